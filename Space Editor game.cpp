@@ -1,655 +1,394 @@
 #define _USE_MATH_DEFINES
 #define GLUT_DISABLE_ATEXIT_HACK
 
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "GLFunctions.h" // ahead of glut.h so the post-1.1 GL entry points are declared
+
+#ifdef _WIN32
 #include <glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#include "AllocCounter.h"
+#include "ChunkStreamer.h"
+#include "FixedStep.h"
+#include "GameCore.h"
+#include "GLRenderer.h"
+#include "GpuTimer.h"
+#include "JobSystem.h"
+#include "LevelFile.h"
+#include "LevelGen.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Scene.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
 
 #ifdef _MSC_VER
 #undef exit
 #endif
 
 // =====================
-// Data structures
-// =====================
-struct Vec2 { float x, y; Vec2(float X = 0, float Y = 0) :x(X), y(Y) {} };
-
-struct Collectible { Vec2 pos; bool active = true; float phase = 0.0f; };
-struct Obstacle { Vec2 pos; float w, h; };
-
-enum PowerType { P_SHIELD = 0, P_SPEED = 1 };
-struct PowerUp { Vec2 pos; bool active = true; PowerType type = P_SHIELD; float phase = 0.0f; };
-
-// =====================
-// Game state
+// Front end state: the simulation itself lives in GameState (src/GameCore.h). It runs on its own thread;
+// the GLUT thread only renders. The two never share mutable data: input goes to the simulation through a
+// lock-free queue, and each batch of ticks comes back as a SimFrame through a lock-free triple buffer, so a
+// slow frame never holds up a tick and a slow tick never holds up a frame.
 // =====================
 int windowWidth = 800, windowHeight = 600;
 
-// UI and world extents
-const float UI_TOP_HEIGHT = 0.12f;   // normalized screen units for panels
-const float UI_BOTTOM_HEIGHT = 0.10f;
-const float WORLD_LEFT = -1.0f, WORLD_RIGHT = 1.0f;
-const float WORLD_BOTTOM = -1.0f, WORLD_TOP = 3.0f; // taller world
-
-float playerX = 0.0f, playerY = -0.9f;
-float playerAngle = 0.0f; // rotation to face movement
-float playerSpeed = 0.05f;
-int score = 0;
-int lives = 5;
-float gameTimer = 30.0f; // <-- changed to 30 seconds
-bool gameOver = false;
-bool gameWin = false;
-bool gameStarted = false; // editing mode initially
-
-std::vector<Collectible> collectibles;
-std::vector<Obstacle> obstacles;
-std::vector<PowerUp> powerups;
-
-// placement tools
-enum Tool { TOOL_NONE = 0, TOOL_OBSTACLE, TOOL_COLLECTIBLE, TOOL_P_SHIELD, TOOL_P_SPEED };
-Tool selectedTool = TOOL_NONE;
-
-// powerup active state
-bool shieldActive = false;
-float shieldTimer = 0.0f; // seconds remaining
-float shieldDuration = 5.0f; // user requested 5s
-// speed power-up variables
-bool speedActive = false;
-float speedTimer = 0.0f;
-float speedDuration = 5.0f; // speed lasts this many seconds
-float basePlayerSpeed = 0.05f;
-float speedMultiplier = 1.8f; // how much faster when speed powerup active
-
-// animations
-float globalTime = 0.0f;
-float lastMoveTime = -100.0f; // used to show brief thruster flame when player recently moved
-
-// target bezier movement
-Vec2 targetPos(0.0f, 0.7f); // ensure visible frame
-float targetAnimT = 0.0f; // 0..1 parameter along bezier
-std::vector<Vec2> targetBezier;
-
-// UI messages
-std::string statusMessage = "Place objects then press R to start";
-float messageTimer = 0.0f;
-
-// helpers
-float randf(float a, float b) { return a + (float(rand()) / RAND_MAX) * (b - a); }
+typedef std::chrono::steady_clock Clock;
+
+// simulation thread (and main before it starts)
+GameState game;
+std::vector<InputEvent> pendingInputs; // input taken off the queue, consumed by the next tick
+FixedStep simClock(60.0);              // ticks at a fixed rate off a monotonic clock
+FramePose prevPose, latestPose;        // poses at the last two ticks
+ReplayRecorder recorder;               // every tick's input, written out on exit (SpaceEditorReplay plays it back)
+
+// GLUT thread -> simulation: input events, and the level file commands (the level belongs to the simulation)
+enum SimCommandKind { CMD_INPUT = 0, CMD_SAVE_LEVEL, CMD_LOAD_LEVEL };
+struct SimCommand { SimCommandKind kind = CMD_INPUT; InputEvent input; };
+SpscQueue<SimCommand, 256> simCommands;
+// GLUT thread -> simulation: arrow keys currently down, sampled once per tick. A press also sets its tap bit,
+// which the next tick clears, so a tap released before the tick still moves for that one tick.
+enum { ARROW_LEFT = 1, ARROW_RIGHT = 2, ARROW_UP = 4, ARROW_DOWN = 8 };
+std::atomic<unsigned> arrowsHeld{ 0 }, arrowsTapped{ 0 };
+
+// simulation -> GLUT thread: everything a frame needs, published after every batch of ticks
+struct SimFrame {
+    FrameSnapshot scene;
+    FramePose prevPose, latestPose; // the last two ticks; the frame blends between them
+    Clock::time_point latestTick;   // real time the latest tick was due
+    double tickDt = 1.0 / 60.0;
+    // the simulation's zone times for this batch, handed to the (render thread's) profiler
+    struct Zone { ProfileZone zone; double startUs, ms; };
+    Zone zones[3]; int zoneCount = 0;
+    size_t residentBytes = 0; // streamed level data in memory
+};
+TripleBuffer<SimFrame> simFrames;
+
+std::thread simThread;
+std::atomic<bool> simRunning{ false };
+
+// GLUT thread
+DrawList drawList; // rebuilt every frame, storage reused
+HudText hudText;   // HUD strings, re-formatted only on change
+ParticleSystem particles; // exhaust and effect bursts, advanced by real time between frames
+Clock::time_point lastDisplay;
+GLRenderer renderer;
+bool uncapped = false; // render as fast as possible and report FPS
+int fpsFrames = 0; Clock::time_point fpsStart;
+int starCount = STARFIELD_DEFAULT_STARS; // --stars
+AllocTotals fpsAllocs; // heap allocations (all threads) at the start of the FPS interval
+
+// profiling: F3 toggles the overlay, --trace <file> writes a trace-event JSON on exit
+GpuTimer gpuTimer;
+ProfilerOverlay profilerOverlay;
+const char* tracePath = nullptr;
+
+// level file used by F5 (save) and F9 (load); --level <file> also loads it at startup
+const char* levelPath = "level.splv";
+bool loadAtStart = false;
+// --generate <count>: a procedural level of this many objects is written to levelPath before the session
+size_t generateCount = 0;
+// --stream <MB>: level files are paged in around the camera within this budget instead of mapped whole
+// (driven by the simulation thread)
+std::unique_ptr<ChunkStreamer> streamer;
+// the session's replay; --record <file> renames it, --no-record turns it off
+const char* recordPath = "session.sprp";
 
 // =====================
-// Drawing helpers & primitives (we use many different GL primitives explicitly)
+// Utility: convert window mouse coords to screen coords in [-1, 1]^2 (the simulation applies the camera)
 // =====================
-
-void drawQuad(float x, float y, float w, float h) { // GL_QUADS
-    glBegin(GL_QUADS);
-    glVertex2f(x - w, y - h);
-    glVertex2f(x + w, y - h);
-    glVertex2f(x + w, y + h);
-    glVertex2f(x - w, y + h);
-    glEnd();
+Vec2 windowToScreen(int mx, int my) {
+    float nx = (2.0f * mx / windowWidth) - 1.0f;
+    float ny = 1.0f - (2.0f * my / windowHeight);
+    return Vec2(nx, ny);
 }
 
-void drawCircle(float cx, float cy, float r, int segs = 24) { // GL_TRIANGLE_FAN
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(cx, cy);
-    for (int i = 0;i <= segs;i++) { float a = i * 2 * M_PI / segs; glVertex2f(cx + cos(a) * r, cy + sin(a) * r); }
-    glEnd();
-}
+// =====================
+// Input callbacks: translate GLUT events into simulation commands (a full queue drops the event)
+// =====================
 
-void drawLine(float x1, float y1, float x2, float y2) { // GL_LINES
-    glBegin(GL_LINES); glVertex2f(x1, y1); glVertex2f(x2, y2); glEnd();
-}
+void sendInput(const InputEvent& e) { SimCommand c; c.input = e; simCommands.push(c); }
+void sendCommand(SimCommandKind kind) { SimCommand c; c.kind = kind; simCommands.push(c); }
 
-void drawLineStrip(const std::vector<Vec2>& pts) { // GL_LINE_STRIP
-    glBegin(GL_LINE_STRIP); for (auto& p : pts) glVertex2f(p.x, p.y); glEnd();
+void mouseClick(int button, int state, int mx, int my) {
+    if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) sendInput(clickInput(windowToScreen(mx, my)));
 }
 
-void drawLineLoop(const std::vector<Vec2>& pts) { // GL_LINE_LOOP
-    glBegin(GL_LINE_LOOP); for (auto& p : pts) glVertex2f(p.x, p.y); glEnd();
+void keyboard(unsigned char key, int x, int y) {
+    if (key == 27) exit(0); // Esc quits (atexit handlers stop the simulation and flush the trace)
+    sendInput(keyInput(key));
 }
 
-void drawPoint(float x, float y) { glBegin(GL_POINTS); glVertex2f(x, y); glEnd(); } // GL_POINTS (allowed in earlier description)
-
-// heart (used for health and extra life powerup) - GL_POLYGON
-void drawHeart(float x, float y, float size) {
-    glBegin(GL_POLYGON);
-    for (float t = 0;t < 2 * M_PI;t += 0.05f) {
-        float X = 16 * pow(sin(t), 3);
-        float Y = 13 * cos(t) - 5 * cos(2 * t) - 2 * cos(3 * t) - cos(4 * t);
-        X /= 18; Y /= 18;
-        glVertex2f(x + X * size, y + Y * size);
+unsigned arrowBit(int key) {
+    switch (key) {
+    case GLUT_KEY_LEFT:  return ARROW_LEFT;
+    case GLUT_KEY_RIGHT: return ARROW_RIGHT;
+    case GLUT_KEY_UP:    return ARROW_UP;
+    case GLUT_KEY_DOWN:  return ARROW_DOWN;
+    default: return 0;
     }
-    glEnd();
 }
 
-// star as GL_TRIANGLES (for collectibles) - uses GL_TRIANGLES primitive
-void drawStarTriangles(float cx, float cy, float outerR) {
-    const int points = 5;
-    std::vector<Vec2> outer(points), inner(points);
-    for (int i = 0;i < points;i++) {
-        float a = i * 2 * M_PI / points - M_PI / 2.0f;
-        outer[i] = Vec2(cx + cos(a) * outerR, cy + sin(a) * outerR);
-        float a2 = a + M_PI / points;
-        inner[i] = Vec2(cx + cos(a2) * outerR * 0.45f, cy + sin(a2) * outerR * 0.45f);
-    }
-    glBegin(GL_TRIANGLES);
-    for (int i = 0;i < points;i++) {
-        int ni = (i + 1) % points;
-        // triangle for each point: outer[i], inner[i], outer[ni]
-        glVertex2f(outer[i].x, outer[i].y);
-        glVertex2f(inner[i].x, inner[i].y);
-        glVertex2f(outer[ni].x, outer[ni].y);
+// key repeat is off (glutIgnoreKeyRepeat), so these see exactly one down and one up per press
+void specialKeys(int key, int x, int y) {
+    if (unsigned bit = arrowBit(key)) { arrowsHeld.fetch_or(bit); arrowsTapped.fetch_or(bit); return; }
+    switch (key) {
+    case GLUT_KEY_F3:    profilerOverlay.visible = !profilerOverlay.visible; break;
+    case GLUT_KEY_F5:    sendCommand(CMD_SAVE_LEVEL); break;
+    case GLUT_KEY_F9:    sendCommand(CMD_LOAD_LEVEL); break;
+    default: return;
     }
-    glEnd();
 }
 
-// score powerup drawn with GL_TRIANGLE_STRIP + GL_LINE_STRIP (two different primitives)
-void drawScorePowerupShape(float cx, float cy, float s) {
-    // diamond using triangle strip
-    glBegin(GL_TRIANGLE_STRIP);
-    glVertex2f(cx, cy + s);
-    glVertex2f(cx + s, cy);
-    glVertex2f(cx, cy - s);
-    glVertex2f(cx - s, cy);
-    glEnd();
-    // outline using line strip
-    std::vector<Vec2> outline = { {cx,cy + s},{cx + s,cy},{cx,cy - s},{cx - s,cy},{cx,cy + s} };
-    glColor3f(0, 0, 0);
-    drawLineStrip(outline);
+void specialKeysUp(int key, int x, int y) {
+    if (unsigned bit = arrowBit(key)) arrowsHeld.fetch_and(~bit);
 }
 
-// shield icon: GL_POLYGON + GL_LINE_LOOP (two primitives)
-void drawShieldIcon(float cx, float cy, float s) {
-    glBegin(GL_POLYGON);
-    glVertex2f(cx - s * 0.5f, cy + s * 0.2f);
-    glVertex2f(cx + s * 0.5f, cy + s * 0.2f);
-    glVertex2f(cx + s * 0.25f, cy - s * 0.1f);
-    glVertex2f(cx, cy - s * 0.5f);
-    glVertex2f(cx - s * 0.25f, cy - s * 0.1f);
-    glEnd();
-    std::vector<Vec2> loop;
-    for (int i = 0;i < 20;i++) { float a = i * 2 * M_PI / 20; loop.push_back(Vec2(cx + cos(a) * s * 0.25f, cy + sin(a) * s * 0.15f)); }
-    drawLineLoop(loop);
-}
+// =====================
+// Level files: saved and loaded by the simulation between ticks, with the outcome shown in the status line
+// =====================
 
-// obstacle primitive: GL_QUADS + GL_LINE_LOOP (2 primitives)
-void drawObstacleIcon(float cx, float cy, float w, float h) {
-    glBegin(GL_QUADS); glVertex2f(cx - w, cy - h); glVertex2f(cx + w, cy - h); glVertex2f(cx + w, cy + h); glVertex2f(cx - w, cy + h); glEnd();
-    std::vector<Vec2> loop = { {cx - w,cy - h},{cx + w,cy - h},{cx + w,cy + h},{cx - w,cy + h} };
-    drawLineLoop(loop);
+void saveLevelFile() {
+#ifdef _WIN32
+    detachLevel(game); // the file being replaced may be the one the level was loaded from
+#endif
+    LevelStatus st = streamer ? streamer->save(game, levelPath) : saveLevel(game, levelPath);
+    if (st == LEVEL_OK) recorder.levelSaved();
+    if (st == LEVEL_OK) setStatus(game, "Saved %s", levelPath); else setStatus(game, "Save failed: %s", levelStatusText(st));
+    game.messageTimer = 2.0f;
 }
 
-// collectible icon: GL_TRIANGLES (star), GL_TRIANGLE_FAN (circle), GL_LINES (line) -> 3 different primitives
-void drawCollectibleIcon(float cx, float cy, float s) {
-    glColor3f(1.0f, 0.9f, 0.2f); drawStarTriangles(cx, cy, s * 0.9f);
-    glColor3f(1, 1, 1); drawCircle(cx, cy, s * 0.25f, 12);
-    glColor3f(0, 0, 0); drawLine(cx - s * 0.6f, cy, cx + s * 0.6f, cy);
+bool loadLevelFile() {
+    LevelStatus st = streamer ? streamer->open(game, levelPath) : loadLevel(game, levelPath);
+    if (st == LEVEL_OK) setStatus(game, "Loaded %s", levelPath); else setStatus(game, "Load failed: %s", levelStatusText(st));
+    game.messageTimer = 2.0f;
+    if (st == LEVEL_OK) { prevPose = latestPose = currentPose(game); pendingInputs.clear(); recorder.levelLoaded(); }
+    return st == LEVEL_OK;
 }
 
 // =====================
-// Player (uses >=4 different primitives: GL_POLYGON, GL_TRIANGLES, GL_TRIANGLE_FAN, GL_LINES)
+// Simulation thread
 // =====================
-void drawPlayer() {
-    // Draw rocket centered at origin (local coordinates). Caller should translate/rotate to the player's world position.
-    // fuselage (GL_POLYGON)
-    glColor3f(0.9f, 0.9f, 0.95f);
-    glBegin(GL_POLYGON);
-    glVertex2f(0.0f, 0.10f);
-    glVertex2f(0.035f, 0.06f);
-    glVertex2f(0.035f, -0.06f);
-    glVertex2f(0.0f, -0.11f);
-    glVertex2f(-0.035f, -0.06f);
-    glVertex2f(-0.035f, 0.06f);
-    glEnd();
-
-    // nose cone (GL_TRIANGLES)
-    glColor3f(0.95f, 0.6f, 0.2f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(0.0f, 0.10f);
-    glVertex2f(-0.02f, 0.045f);
-    glVertex2f(0.02f, 0.045f);
-    glEnd();
-
-    // fins (GL_TRIANGLES)
-    glColor3f(0.8f, 0.15f, 0.15f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(-0.02f, -0.02f);
-    glVertex2f(-0.09f, -0.06f);
-    glVertex2f(-0.02f, -0.06f);
-    glVertex2f(0.02f, -0.02f);
-    glVertex2f(0.09f, -0.06f);
-    glVertex2f(0.02f, -0.06f);
-    glEnd();
-
-    // cockpit/window (GL_TRIANGLE_FAN) and outline (GL_LINE_LOOP)
-    glColor3f(0.2f, 0.45f, 0.85f);
-    drawCircle(0.0f, 0.02f, 0.02f, 20);
-    glColor3f(0.02f, 0.02f, 0.02f);
-    std::vector<Vec2> wloop;
-    for (int i = 0;i <= 20;i++) { float a = i * 2.0f * M_PI / 20.0f; wloop.push_back(Vec2(cos(a) * 0.02f, 0.02f + sin(a) * 0.02f)); }
-    drawLineLoop(wloop);
-
-    // antenna lines (GL_LINES)
-    glColor3f(0.02f, 0.02f, 0.02f);
-    drawLine(0.01f, 0.08f, 0.01f, 0.12f);
-    drawLine(0.01f, 0.12f, 0.03f, 0.13f);
-
-    // thruster point (GL_POINTS)
-    glPointSize(4.0f); drawPoint(0.0f, -0.11f); glPointSize(1.0f);
-
-    // thruster flame when player just moved (GL_TRIANGLE_FAN)
-    if (globalTime - lastMoveTime < 0.25f) {
-        glBegin(GL_TRIANGLE_FAN);
-        glColor3f(1.0f, 0.6f, 0.0f);
-        glVertex2f(0.0f, -0.11f);
-        glColor3f(1.0f, 0.2f, 0.0f);
-        glVertex2f(-0.03f, -0.18f);
-        glVertex2f(0.0f, -0.14f);
-        glVertex2f(0.03f, -0.18f);
-        glEnd();
+
+void drainCommands() {
+    SimCommand c;
+    while (simCommands.pop(c)) {
+        if (c.kind == CMD_INPUT) pendingInputs.push_back(c.input);
+        else if (c.kind == CMD_SAVE_LEVEL) saveLevelFile();
+        else loadLevelFile();
     }
 }
 
-// =====================
-// Rendering UI panels and icons
-// Top/bottom panels use GL_QUADS (at least 1 primitive each)
-// Health drawn with at least 2 primitives (heart polygon + small circle)
-// =====================
-
-void displayText(float x, float y, const std::string& text) { glRasterPos2f(x, y); for (char c : text) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c); }
-
-void drawTopPanel() {
-    // background quad (GL_QUADS)
-    glColor3f(0.02f, 0.02f, 0.02f); drawQuad(0.0f, 1.0f - UI_TOP_HEIGHT / 2.0f, 1.0f, UI_TOP_HEIGHT / 2.0f);
-    // health: draw hearts (GL_POLYGON) + small inner circles (GL_TRIANGLE_FAN) -> 2 primitives per health
-    float sx = -0.9f; float y = 1.0f - UI_TOP_HEIGHT / 2.0f;
-    for (int i = 0;i < lives;i++) {
-        glColor3f(1.0f, 0.15f, 0.25f); drawHeart(sx + i * 0.08f, y, 0.03f); // GL_POLYGON
-        glColor3f(0.8f, 0.2f, 0.3f); drawCircle(sx + i * 0.08f, y - 0.0f, 0.01f, 8); // GL_TRIANGLE_FAN
+// runs every tick that real time says is due since lastTick; pending input goes to the first of them, and
+// each tick samples the arrow keys
+int advanceSimulation(Clock::time_point now, Clock::time_point& lastTick) {
+    int ticks = simClock.advance(std::chrono::duration<double>(now - lastTick).count());
+    lastTick = now;
+    for (int i = 0;i < ticks;++i) {
+        Inputs in; in.events = pendingInputs.data(); in.count = pendingInputs.size();
+        unsigned arrows = arrowsHeld.load() | arrowsTapped.exchange(0);
+        in.moveX = (float)!!(arrows & ARROW_RIGHT) - (float)!!(arrows & ARROW_LEFT);
+        in.moveY = (float)!!(arrows & ARROW_UP) - (float)!!(arrows & ARROW_DOWN);
+        prevPose = latestPose;
+        recorder.tick(in, game);
+        step(game, in, (float)simClock.dt());
+        latestPose = currentPose(game);
+        pendingInputs.clear();
     }
-    // score and time text
-    glColor3f(1, 1, 1);
-    displayText(-0.05f, 1.0f - UI_TOP_HEIGHT / 2.0f, std::string("Score: ") + std::to_string(score));
-    displayText(0.5f, 1.0f - UI_TOP_HEIGHT / 2.0f, std::string("Time: ") + std::to_string((int)gameTimer));
-    // active powerup and its timer (if any)
-    if (shieldActive) { char buf[64]; sprintf(buf, "Shield: %.1fs", shieldTimer); displayText(0.2f, 1.0f - UI_TOP_HEIGHT / 2.0f, buf); }
-    if (speedActive) { char buf2[64]; sprintf(buf2, "Speed: %.1fs", speedTimer); displayText(0.36f, 1.0f - UI_TOP_HEIGHT / 2.0f, buf2); }
+    return ticks;
 }
 
-void drawBottomPanel() {
-    // background quad (GL_QUADS)
-    glColor3f(0.02f, 0.02f, 0.02f); drawQuad(0.0f, -1.0f + UI_BOTTOM_HEIGHT / 2.0f, 1.0f, UI_BOTTOM_HEIGHT / 2.0f);
-    // draw icons for tools (obstacle, collectible, shield, score powerup)
-    float y = -1.0f + UI_BOTTOM_HEIGHT / 2.0f;
-    float startX = -0.8f; float gap = 0.45f;
-    // obstacle icon (GL_QUADS + GL_LINE_LOOP)
-    glColor3f(0.6f, 0.3f, 0.2f); drawObstacleIcon(startX, y, 0.06f, 0.04f);
-    displayText(startX - 0.04f, y - 0.06f, "Obstacle");
-    // collectible icon (GL_TRIANGLES + GL_TRIANGLE_FAN + GL_LINES)
-    glColor3f(1.0f, 0.9f, 0.2f); drawCollectibleIcon(startX + gap, y, 0.06f);
-    displayText(startX + gap - 0.05f, y - 0.06f, "Collectible");
-    // shield icon (GL_POLYGON + GL_LINE_LOOP)
-    glColor3f(0.2f, 0.6f, 1.0f); drawShieldIcon(startX + gap * 2, y, 0.06f);
-    displayText(startX + gap * 2 - 0.03f, y - 0.06f, "Shield (5s)");
-    // score powerup icon (GL_TRIANGLE_STRIP + GL_LINE_STRIP)
-    glColor3f(1.0f, 0.9f, 0.2f); drawScorePowerupShape(startX + gap * 3, y, 0.05f);
-    displayText(startX + gap * 3 - 0.03f, y - 0.06f, "Speed (5s)");
-
-    // selection highlight (GL_LINE_LOOP)
-    float selX = startX + (selectedTool == TOOL_OBSTACLE ? 0 : (selectedTool == TOOL_COLLECTIBLE ? gap : (selectedTool == TOOL_P_SHIELD ? gap * 2 : (selectedTool == TOOL_P_SPEED ? gap * 3 : 0))));
-    if (selectedTool != TOOL_NONE) { glColor3f(0.8f, 0.8f, 0.8f); glBegin(GL_LINE_LOOP); glVertex2f(selX - 0.08f, y - 0.05f); glVertex2f(selX + 0.08f, y - 0.05f); glVertex2f(selX + 0.08f, y + 0.05f); glVertex2f(selX - 0.08f, y + 0.05f); glEnd(); }
+// copies what the render thread needs into the triple buffer's free slot and hands it over
+void publishFrame(Clock::time_point now, const SimFrame::Zone* zones, int zoneCount) {
+    const Profiler& prof = profiler();
+    SimFrame& f = simFrames.writeSlot();
+    double t0 = prof.nowUs();
+    captureSnapshot(game, std::min(prevPose.cameraY, latestPose.cameraY), std::max(prevPose.cameraY, latestPose.cameraY), f.scene);
+    f.prevPose = prevPose; f.latestPose = latestPose;
+    f.tickDt = simClock.dt();
+    f.latestTick = now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(simClock.alpha() * simClock.dt()));
+    f.zoneCount = 0;
+    for (int i = 0;i < zoneCount;++i) f.zones[f.zoneCount++] = zones[i];
+    f.zones[f.zoneCount++] = SimFrame::Zone{ ZONE_SNAPSHOT, t0, (prof.nowUs() - t0) * 0.001 };
+    f.residentBytes = streamer ? streamer->stats().residentBytes : 0;
+    simFrames.publish();
 }
 
-// =====================
-// Utility: convert window mouse coords to world coords (excluding UI panels)
-// =====================
-Vec2 windowToWorld(int mx, int my) {
-    float nx = (2.0f * mx / windowWidth) - 1.0f;
-    float ny = 1.0f - (2.0f * my / windowHeight);
-    return Vec2(nx, ny);
-}
-
-bool pointInsideGameArea(const Vec2& p) {
-    if (p.x < WORLD_LEFT + 0.02f || p.x > WORLD_RIGHT - 0.02f) return false;
-    float topLimit = 1.0f - UI_TOP_HEIGHT;
-    float bottomLimit = -1.0f + UI_BOTTOM_HEIGHT;
-    if (p.y > topLimit - 0.01f) return false;
-    if (p.y < bottomLimit + 0.01f) return false;
-    if (p.y < WORLD_BOTTOM || p.y > WORLD_TOP) return false;
-    return true;
+void simulationLoop() {
+    const Profiler& prof = profiler(); // for its clock only; the profiler itself belongs to the render thread
+    Clock::time_point lastTick = Clock::now();
+    while (simRunning.load(std::memory_order_acquire)) {
+        drainCommands();
+        SimFrame::Zone zones[2]; int zoneCount = 0;
+        double t0 = prof.nowUs();
+        Clock::time_point now = Clock::now();
+        advanceSimulation(now, lastTick);
+        double t1 = prof.nowUs();
+        zones[zoneCount++] = SimFrame::Zone{ ZONE_UPDATE, t0, (t1 - t0) * 0.001 };
+        if (streamer) { streamer->update(game, game.cameraY); zones[zoneCount++] = SimFrame::Zone{ ZONE_STREAM, t1, (prof.nowUs() - t1) * 0.001 }; }
+        publishFrame(now, zones, zoneCount);
+        // sleep until the next tick is due; oversleeping only means that tick runs a little late
+        std::this_thread::sleep_for(std::chrono::duration<double>((1.0 - simClock.alpha()) * simClock.dt()));
+    }
 }
 
-bool tooCloseToExisting(const Vec2& p, float minDist) {
-    for (auto& c : collectibles) if (hypot(c.pos.x - p.x, c.pos.y - p.y) < minDist) return true;
-    for (auto& o : obstacles) if (hypot(o.pos.x - p.x, o.pos.y - p.y) < minDist) return true;
-    for (auto& pu : powerups) if (hypot(pu.pos.x - p.x, pu.pos.y - p.y) < minDist) return true;
-    return false;
+void startSimulation() {
+    publishFrame(Clock::now(), nullptr, 0); // the first frame has something to show
+    simRunning.store(true, std::memory_order_release);
+    simThread = std::thread(simulationLoop);
 }
 
-int obstacleIndexAt(float nx, float ny) {
-    for (size_t i = 0;i < obstacles.size();++i) { auto& o = obstacles[i]; if (fabs(nx - o.pos.x) < (o.w + 0.04f) && fabs(ny - o.pos.y) < (o.h + 0.04f)) return (int)i; }
-    return -1;
+void stopSimulation() {
+    simRunning.store(false, std::memory_order_release);
+    if (simThread.joinable()) simThread.join();
 }
 
 // =====================
-// Mouse handling
+// Render loop
 // =====================
 
-void mouseClick(int button, int state, int mx, int my) {
-    if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
-        Vec2 w = windowToWorld(mx, my);
-        float yPanel = -1.0f + UI_BOTTOM_HEIGHT / 2.0f;
-        float startX = -0.8f; float gap = 0.45f;
-        float epsX = 0.08f, epsY = 0.06f;
-        if (fabs(w.y - yPanel) < 0.12f) {
-            if (fabs(w.x - startX) < epsX) { selectedTool = TOOL_OBSTACLE; statusMessage = "Obstacle drawing mode"; return; }
-            if (fabs(w.x - (startX + gap)) < epsX) { selectedTool = TOOL_COLLECTIBLE; statusMessage = "Collectible drawing mode"; return; }
-            if (fabs(w.x - (startX + gap * 2)) < epsX) { selectedTool = TOOL_P_SHIELD; statusMessage = "Shield powerup drawing mode"; return; }
-            if (fabs(w.x - (startX + gap * 3)) < epsX) { selectedTool = TOOL_P_SPEED; statusMessage = "Speed powerup drawing mode"; return; }
-        }
-        if (!gameStarted && selectedTool != TOOL_NONE) {
-            if (!pointInsideGameArea(w)) { statusMessage = "Cannot place outside game area"; messageTimer = 2.0f; return; }
-            if (!((w.y > playerY) && (w.y < targetPos.y))) { statusMessage = "Place object between player and target"; messageTimer = 2.0f; return; }
-            if (tooCloseToExisting(w, 0.08f)) { statusMessage = "Too close to another object"; messageTimer = 2.0f; return; }
-            if (selectedTool == TOOL_OBSTACLE) { Obstacle o; o.pos = w; o.w = 0.08f; o.h = 0.06f; obstacles.push_back(o); statusMessage = "Placed obstacle"; }
-            else if (selectedTool == TOOL_COLLECTIBLE) { Collectible c; c.pos = w; c.active = true; c.phase = randf(0, 6.28f); collectibles.push_back(c); statusMessage = "Placed collectible"; }
-            else if (selectedTool == TOOL_P_SHIELD) { PowerUp p; p.pos = w; p.type = P_SHIELD; p.active = true; p.phase = 0.0f; powerups.push_back(p); statusMessage = "Placed shield powerup"; }
-            else if (selectedTool == TOOL_P_SPEED) { PowerUp p; p.pos = w; p.type = P_SPEED; p.active = true; p.phase = 0.0f; powerups.push_back(p); statusMessage = "Placed speed powerup"; }
-            messageTimer = 1.5f; return;
-        }
-    }
+size_t residentBytes = 0; // from the latest SimFrame, for the FPS report
+
+void reportFps() {
+    ++fpsFrames;
+    double elapsed = std::chrono::duration<double>(Clock::now() - fpsStart).count();
+    if (elapsed < 1.0) return;
+    printf("%.1f fps (%.3f ms/frame, %d draw calls, %zu vertices", fpsFrames / elapsed, elapsed * 1000.0 / fpsFrames, renderer.drawCalls(), renderer.vertices());
+    if (streamer) printf(", %.1f MB of level resident", residentBytes / 1048576.0);
+    AllocTotals a = allocsSince(fpsAllocs);
+    printf(", %.1f allocations and %.0f bytes per frame)\n", (double)a.count / fpsFrames, (double)a.bytes / fpsFrames);
+    fflush(stdout);
+    fpsFrames = 0; fpsStart = Clock::now(); fpsAllocs = allocTotals();
 }
 
-// =====================
-// Keyboard: R starts game, restarts etc.
-// =====================
-void keyboard(unsigned char key, int x, int y) {
-    if (key == 'r' || key == 'R') {
-        if (!gameStarted) { // start the game
-            gameStarted = true; gameTimer = 30.0f; statusMessage = "Game started"; messageTimer = 1.5f; // <-- start uses 30s
-            // ensure powerup state reset when starting
-            playerSpeed = basePlayerSpeed; speedActive = false; speedTimer = 0.0f; shieldActive = false; shieldTimer = 0.0f;
-        }
-        else if (gameOver) { // restart fully
-            collectibles.clear(); obstacles.clear(); powerups.clear(); selectedTool = TOOL_NONE; gameStarted = false; gameOver = false; gameWin = false; score = 0; lives = 5; statusMessage = "Editing mode: place objects"; messageTimer = 1.5f; playerX = 0; playerY = -0.9f;
-            // reset speed/shield
-            playerSpeed = basePlayerSpeed; speedActive = false; speedTimer = 0.0f; shieldActive = false; shieldTimer = 0.0f;
-            // reset game timer to 30 as well (editing mode)
-            gameTimer = 30.0f;
-        }
-    }
+// capped mode: redraw at about 60 Hz; the simulation thread keeps its own time
+void frameTimer(int val) {
+    glutPostRedisplay();
+    glutTimerFunc(16, frameTimer, 0);
 }
 
-// =====================
-// Collision helpers
-// =====================
-
-bool collidesWithObstacle(float nx, float ny) { return obstacleIndexAt(nx, ny) != -1; }
-
-int collectAt(float nx, float ny) { for (size_t i = 0;i < collectibles.size();++i) { if (collectibles[i].active && hypot(collectibles[i].pos.x - nx, collectibles[i].pos.y - ny) < 0.07f) { collectibles[i].active = false; return 1; } } return 0; }
-
-int powerupAt(float nx, float ny, PowerUp& out, int& index) { for (size_t i = 0;i < powerups.size();++i) { if (powerups[i].active && hypot(powerups[i].pos.x - nx, powerups[i].pos.y - ny) < 0.07f) { out = powerups[i]; out.active = false; index = (int)i; powerups[i].active = false; return 1; } } return 0; }
+void idle() { glutPostRedisplay(); }
 
 // =====================
-// Update loop
+// main display
 // =====================
-void update(int val) {
-    float dt = 0.016f;
-    globalTime += dt;
-
-    // animate target along bezier
-    if (targetBezier.size() == 4) {
-        targetAnimT += dt / 8.0f; if (targetAnimT > 1.0f) targetAnimT -= 1.0f; float t = targetAnimT;
-        Vec2 a = targetBezier[0]; Vec2 b = targetBezier[1]; Vec2 c = targetBezier[2]; Vec2 d = targetBezier[3];
-        float tt = t; float u = 1 - tt;
-        targetPos.x = u * u * u * a.x + 3 * u * u * tt * b.x + 3 * u * tt * tt * c.x + tt * tt * tt * d.x;
-        targetPos.y = u * u * u * a.y + 3 * u * u * tt * b.y + 3 * u * tt * tt * c.y + tt * tt * tt * d.y;
-    }
 
-    // animate collectibles & powerups (phases)
-    for (auto& c : collectibles) c.phase += dt * 2.0f;
-    for (auto& p : powerups) p.phase += dt * 1.5f;
-
-    if (gameStarted && !gameOver) {
-        // timer
-        gameTimer -= dt;
-        if (gameTimer <= 0.0f) { // lose unless at target
-            if (hypot(playerX - targetPos.x, playerY - targetPos.y) < 0.12f) { gameWin = true; }
-            else { gameWin = false; }
-            gameOver = true; messageTimer = 3.0f;
-        }
-        // shield timer
-        if (shieldActive) { shieldTimer -= dt; if (shieldTimer <= 0.0f) { shieldActive = false; shieldTimer = 0.0f; statusMessage = "Shield expired"; messageTimer = 1.5f; } }
-
-        // SPEED timer decrement & expiry handling (NEW)
-        if (speedActive) {
-            speedTimer -= dt;
-            if (speedTimer <= 0.0f) {
-                speedActive = false;
-                speedTimer = 0.0f;
-                playerSpeed = basePlayerSpeed;
-                statusMessage = "Speed expired";
-                messageTimer = 1.5f;
-            }
-        }
+void display() {
+    Profiler& prof = profiler();
+    prof.beginFrame();
+    // the newest SimFrame if there is one, else the last one again; its zones count toward the frame that picks it up
+    bool fresh = simFrames.acquire();
+    const SimFrame& sim = simFrames.readSlot();
+    if (fresh) for (int i = 0;i < sim.zoneCount;++i) prof.addSample(sim.zones[i].zone, sim.zones[i].ms, sim.zones[i].startUs, TRACE_SIM);
+    residentBytes = sim.residentBytes;
+    Clock::time_point now = Clock::now();
+    double sinceTick = std::chrono::duration<double>(now - sim.latestTick).count();
+    float alpha = (float)std::min(1.0, std::max(0.0, sinceTick / sim.tickDt));
+    FramePose pose = blendPoses(sim.prevPose, sim.latestPose, alpha, (float)sim.tickDt);
+
+    float frameDt = lastDisplay == Clock::time_point() ? 0.0f : (float)std::min(0.1, std::chrono::duration<double>(now - lastDisplay).count());
+    lastDisplay = now;
+
+    buildScene(sim.scene, pose, drawList, hudText);
+    buildParticles(sim.scene, pose, frameDt, particles, drawList);
+    buildProfilerOverlay(prof, profilerOverlay, drawList, prof.nowUs() * 1e-6);
+    gpuTimer.collect();
+    {
+        PROFILE_SCOPE(ZONE_SUBMIT);
+        gpuTimer.begin(ZONE_GPU_DRAW);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer.submit(drawList, windowWidth, windowHeight);
+        gpuTimer.end();
     }
-
-    // message timer
-    if (messageTimer > 0.0f) messageTimer -= dt;
-
-    glutPostRedisplay();
-    glutTimerFunc(16, update, 0);
+    { PROFILE_SCOPE(ZONE_SWAP); glutSwapBuffers(); }
+    prof.endFrame();
+    if (uncapped) reportFps();
 }
 
-// =====================
-// Player controls (special keys)
-// =====================
-void specialKeys(int key, int x, int y) {
-    if (gameOver) return;
-    if (!gameStarted) return; // no movement in editing mode
-
-    // compute movement vector based on key, normalize, set angle using atan2 so rocket faces direction of motion
-    float dx = 0.0f, dy = 0.0f;
-    switch (key) {
-    case GLUT_KEY_LEFT:  dx -= 1.0f; break;
-    case GLUT_KEY_RIGHT: dx += 1.0f; break;
-    case GLUT_KEY_UP:    dy += 1.0f; break;
-    case GLUT_KEY_DOWN:  dy -= 1.0f; break;
-    default: return;
-    }
-
-    if (dx == 0.0f && dy == 0.0f) return;
-
-    // normalize movement vector so diagonal isn't faster
-    float len = sqrtf(dx * dx + dy * dy);
-    if (len > 0.0f) { dx /= len; dy /= len; }
-
-    // compute angle: atan2(dy,dx) gives 0 = right, +90 = up; our rocket points up at angle 0 -> subtract 90 degrees
-    playerAngle = atan2f(dy, dx) * 180.0f / (float)M_PI - 90.0f;
-
-    // attempt move
-    float nx = playerX + dx * playerSpeed;
-    float ny = playerY + dy * playerSpeed;
-
-    // clamp to game area (world and UI)
-    float topLimit = 1.0f - UI_TOP_HEIGHT - 0.02f; float bottomLimit = -1.0f + UI_BOTTOM_HEIGHT + 0.02f;
-    if (nx < WORLD_LEFT + 0.02f) nx = WORLD_LEFT + 0.02f; if (nx > WORLD_RIGHT - 0.02f) nx = WORLD_RIGHT - 0.02f;
-    if (ny > topLimit) ny = topLimit; if (ny < bottomLimit) ny = bottomLimit;
-
-    int obsIndex = obstacleIndexAt(nx, ny);
-    if (obsIndex != -1) {
-        if (shieldActive) {
-            // shield protects: destroy the obstacle and allow movement
-            obstacles.erase(obstacles.begin() + obsIndex);
-            score += 5;
-            statusMessage = "Shield absorbed obstacle (destroyed)";
-            messageTimer = 1.5f;
-            playerX = nx; playerY = ny; // move into position
-            lastMoveTime = globalTime;
-        }
-        else {
-            // hit obstacle: lose a life and block motion
-            lives--; statusMessage = "Hit obstacle! -1 life"; messageTimer = 1.5f; if (lives <= 0) { gameOver = true; gameWin = false; }
-            // do not move into obstacle
-        }
-    }
-    else {
-        // no obstacle, move freely
-        playerX = nx; playerY = ny;
-        lastMoveTime = globalTime;
-        // collect collectibles
-        if (collectAt(playerX, playerY)) { score += 5; statusMessage = "Collected +5"; messageTimer = 0.9f; }
-        // powerups
-        PowerUp picked; int pindex = -1; if (powerupAt(playerX, playerY, picked, pindex)) {
-            if (picked.type == P_SHIELD) { shieldActive = true; shieldTimer = shieldDuration; statusMessage = "Shield picked"; messageTimer = 1.5f; }
-            else if (picked.type == P_SPEED) {
-                // activate speed for speedDuration seconds
-                speedActive = true;
-                speedTimer = speedDuration;
-                playerSpeed = basePlayerSpeed * speedMultiplier;
-                statusMessage = "Speed Up!";
-                messageTimer = 1.5f;
-            }
-            if (pindex >= 0) powerups.erase(powerups.begin() + pindex);
-        }
-        // win if reach target
-        if (hypot(playerX - targetPos.x, playerY - targetPos.y) < 0.12f) { gameWin = true; gameOver = true; }
-    }
+void reshape(int w, int h) {
+    windowWidth = w; windowHeight = h > 0 ? h : 1;
+    glViewport(0, 0, windowWidth, windowHeight);
 }
 
 // =====================
-// Drawing world: objects placed by user; animate collectibles & powerups; draw obstacles; draw target; background anim
+// Command line: --tick-rate <hz>, --uncapped, --trace <file>, --level <file>, --stream <MB>, --threads <n>,
+// --record <file>, --no-record, --generate <count>, --stars <n> (GLUT has already taken its own options out of argv)
 // =====================
-
-void drawBackground() {
-    // moving stars background (animated) - use GL_POINTS
-    glBegin(GL_POINTS);
-    for (int i = 0;i < 80;i++) {
-        float sx = -1.0f + (i % 16) * 0.13f + fmod(globalTime * 0.02f + i * 0.01f, 0.2f);
-        float sy = -1.0f + (i / 16) * 0.6f + fmod(globalTime * 0.01f * i, 0.4f);
-        glVertex2f(sx, sy);
-    }
-    glEnd();
-}
-
-void drawObstacles() {
-    for (auto& o : obstacles) {
-        glColor3f(0.4f, 0.2f, 0.1f);
-        drawQuad(o.pos.x, o.pos.y, o.w, o.h);
-        // create loop vertices explicitly using Vec2 constructors to avoid initializer-list ambiguity on some compilers
-        std::vector<Vec2> loop = {
-            Vec2(o.pos.x - o.w, o.pos.y - o.h),
-            Vec2(o.pos.x + o.w, o.pos.y - o.h),
-            Vec2(o.pos.x + o.w, o.pos.y + o.h),
-            Vec2(o.pos.x - o.w, o.pos.y + o.h)
-        };
-        glColor3f(0, 0, 0);
-        drawLineLoop(loop);
-    }
+void writeTraceAtExit() {
+    if (profiler().writeTrace(tracePath)) printf("trace written to %s\n", tracePath);
+    else fprintf(stderr, "could not write trace %s\n", tracePath);
 }
 
-void drawCollectibles() {
-    for (auto& c : collectibles) if (c.active) { float dy = sin(c.phase) * 0.02f; glColor3f(1.0f, 0.9f, 0.2f); drawStarTriangles(c.pos.x, c.pos.y + dy, 0.03f); glColor3f(1, 1, 1); drawCircle(c.pos.x, c.pos.y + dy, 0.01f, 8); glColor3f(0, 0, 0); drawLine(c.pos.x - 0.02f, c.pos.y + dy, c.pos.x + 0.02f, c.pos.y + dy); }
+void writeReplayAtExit() {
+    ReplayStatus st = recorder.write(recordPath, game);
+    if (st == REPLAY_OK) printf("session recorded to %s (%llu ticks)\n", recordPath, (unsigned long long)recorder.ticks());
+    else fprintf(stderr, "could not record %s: %s\n", recordPath, replayStatusText(st));
 }
 
-void drawPowerups() {
-    for (auto& p : powerups) if (p.active) {
-        if (p.type == P_SHIELD) { glColor3f(0.2f, 0.6f, 1.0f); glPushMatrix(); glTranslatef(p.pos.x, p.pos.y, 0); glRotatef(p.phase * 40.0f, 0, 0, 1); drawShieldIcon(0, 0, 0.05f); glPopMatrix(); }
-        else { // P_SPEED
-            glColor3f(0.8f, 0.2f, 0.9f);
-            glPushMatrix(); glTranslatef(p.pos.x, p.pos.y, 0); glRotatef(p.phase * 120.0f, 0, 0, 1);
-            // draw a speed icon using triangle strip + line strip (retains primitive requirements)
-            drawScorePowerupShape(0, 0, 0.035f);
-            glPopMatrix();
-            // small arrow point (GL_TRIANGLES) to make it look like speed
-            glColor3f(1, 1, 1);
-            glBegin(GL_TRIANGLES);
-            glVertex2f(p.pos.x + 0.03f, p.pos.y);
-            glVertex2f(p.pos.x, p.pos.y + 0.015f);
-            glVertex2f(p.pos.x, p.pos.y - 0.015f);
-            glEnd();
-        }
+void parseOptions(int argc, char** argv) {
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--uncapped")) uncapped = true;
+        else if (!strcmp(argv[i], "--tick-rate") && i + 1 < argc) simClock.setRate(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--trace") && i + 1 < argc) tracePath = argv[++i];
+        else if (!strcmp(argv[i], "--level") && i + 1 < argc) { levelPath = argv[++i]; loadAtStart = true; }
+        else if (!strcmp(argv[i], "--stream") && i + 1 < argc) streamer.reset(new ChunkStreamer((size_t)std::max(1, atoi(argv[++i])) << 20));
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) setJobThreads(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--no-record")) recordPath = nullptr;
+        else if (!strcmp(argv[i], "--generate") && i + 1 < argc) generateCount = (size_t)std::max(0LL, atoll(argv[++i]));
+        else if (!strcmp(argv[i], "--stars") && i + 1 < argc) starCount = std::max(0, atoi(argv[++i]));
+        else { fprintf(stderr, "unknown option %s\nusage: %s [--tick-rate <hz>] [--uncapped] [--trace <file.json>] [--level <file>] [--stream <MB>] [--threads <n>] [--record <file> | --no-record] [--generate <count>] [--stars <n>]\n", argv[i], argv[0]); exit(1); }
     }
-}
-
-// nicer sun target with glow and rays
-void drawSunTarget(float cx, float cy, float radius) {
-    const int N = 24;
-    // glow layers (GL_TRIANGLE_FAN)
-    for (int layer = 3;layer >= 0;--layer) { float r = radius * (0.4f + 0.2f * layer); float alpha = 0.2f + 0.2f * (3 - layer); glColor4f(1.0f, 0.85f - 0.08f * layer, 0.0f, alpha); glBegin(GL_TRIANGLE_FAN); glVertex2f(cx, cy); for (int i = 0;i <= N;i++) { float a = i * 2 * M_PI / N; glVertex2f(cx + cos(a) * r, cy + sin(a) * r); } glEnd(); }
-    // rays (GL_TRIANGLES)
-    glBegin(GL_TRIANGLES);
-    for (int i = 0;i < 12;i++) { float a = i * 2 * M_PI / 12 + globalTime * 0.5f; float innerR = radius * 1.05f; float outerR = radius * (1.4f + 0.2f * (i % 2)); glColor3f(1, 0.9f, 0.1f); glVertex2f(cx + cos(a) * innerR, cy + sin(a) * innerR); glVertex2f(cx + cos(a + 0.08f) * outerR, cy + sin(a + 0.08f) * outerR); glVertex2f(cx + cos(a - 0.08f) * outerR, cy + sin(a - 0.08f) * outerR); }
-    glEnd();
-    // core (GL_TRIANGLE_FAN)
-    glColor3f(1, 1, 0.6f); drawCircle(cx, cy, radius * 0.6f, 20);
-}
-
-// =====================
-// main display
-// =====================
-
-void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    // draw background (screen space)
-    glColor3f(0.02f, 0.02f, 0.05f); drawQuad(0, 0, 1.0f, 1.0f);
-    glColor3f(1, 1, 1); glPointSize(2.0f);
-    drawBackground();
-    glPointSize(1.0f);
-
-    // draw UI panels
-    glColor3f(0.1f, 0.1f, 0.12f); drawTopPanel(); drawBottomPanel();
-
-    // draw world objects
-    drawSunTarget(targetPos.x, targetPos.y, 0.06f);
-    drawObstacles();
-    drawCollectibles();
-    drawPowerups();
-
-    // draw player (animated rotation is visualized via antenna lines orientation using playerAngle)
-    glPushMatrix();
-    glTranslatef(playerX, playerY, 0);
-    glRotatef(playerAngle, 0, 0, 1);
-    drawPlayer();
-    glPopMatrix();
-
-    // draw status messages
-    if (messageTimer > 0.0f) { glColor3f(1, 1, 1); displayText(-0.4f, -0.85f + UI_BOTTOM_HEIGHT, statusMessage); }
-
-    if (gameOver) { glColor3f(1, 1, 1); displayText(-0.12f, 0.0f, gameWin ? "YOU WIN!" : "GAME OVER"); displayText(-0.15f, -0.1f, std::string("Final Score: ") + std::to_string(score)); displayText(-0.25f, -0.2f, "Press R to Restart (returns to editor)"); }
-
-    glutSwapBuffers();
+    if (tracePath) { profiler().startTrace(); atexit(writeTraceAtExit); }
 }
 
 // =====================
 // Initialization and main
 // =====================
 
-void initGame() {
-    srand((unsigned)time(0));
-    // prepare bezier control points for target within visible frame
-    float left = -0.6f, right = 0.6f, y = 0.7f;
-    targetBezier.clear(); targetBezier.push_back(Vec2(left, y)); targetBezier.push_back(Vec2(-0.2f, y + 0.3f)); targetBezier.push_back(Vec2(0.2f, y - 0.3f)); targetBezier.push_back(Vec2(right, y));
-    targetAnimT = 0.0f;
-    // clear editor arrays
-    collectibles.clear(); obstacles.clear(); powerups.clear(); selectedTool = TOOL_NONE;
-    playerX = 0; playerY = -0.9f; score = 0; lives = 5; gameStarted = false; gameOver = false; shieldActive = false; shieldTimer = 0.0f; statusMessage = "Editing mode: place objects"; messageTimer = 2.0f;
-    // reset player speed state
-    playerSpeed = basePlayerSpeed; speedActive = false; speedTimer = 0.0f;
-    // ensure game timer default is 30
-    gameTimer = 30.0f;
-}
-
 int main(int argc, char** argv) {
-    glutInit(&argc, argv); glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB); glutInitWindowSize(windowWidth, windowHeight); glutCreateWindow("Space Editor - Place Objects then Press R");
-    glutDisplayFunc(display); glutTimerFunc(16, update, 0); glutMouseFunc(mouseClick); glutKeyboardFunc(keyboard); glutSpecialFunc(specialKeys);
+    glutInit(&argc, argv); parseOptions(argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB); glutInitWindowSize(windowWidth, windowHeight); glutCreateWindow("Space Editor - Place Objects then Press R");
+    glutDisplayFunc(display); glutReshapeFunc(reshape); glutMouseFunc(mouseClick); glutKeyboardFunc(keyboard); glutSpecialFunc(specialKeys); glutSpecialUpFunc(specialKeysUp);
+    glutIgnoreKeyRepeat(1); // held keys are tracked as state, not as a stream of repeats
+    if (uncapped) { glutIdleFunc(idle); if (!setSwapInterval(0)) printf("note: vsync could not be disabled, frame rate may be capped by the display\n"); }
+    else glutTimerFunc(16, frameTimer, 0);
     glClearColor(0, 0, 0, 1);
     glEnable(GL_POINT_SMOOTH);
     glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    initGame(); glutMainLoop(); return 0;
+    renderer.init(starCount);
+    if (!gpuTimer.init()) printf("note: no GL timer queries, GPU zone disabled\n");
+    uint32_t seed = (uint32_t)time(0);
+    initGame(game, seed);
+    recorder.begin(seed, (float)simClock.dt(), levelPath);
+    // --generate writes the level file and starts on it, so F9 and replays get the same level back
+    if (generateCount) {
+        size_t placed = 0;
+        LevelStatus st = generateLevelFile(levelPath, generateCount, seed, placed);
+        if (st == LEVEL_OK) { printf("generated %zu objects into %s\n", placed, levelPath); loadAtStart = true; }
+        else fprintf(stderr, "%s: %s\n", levelPath, levelStatusText(st));
+    }
+    latestPose = prevPose = currentPose(game);
+    if (loadAtStart && !loadLevelFile()) fprintf(stderr, "%s: %s\n", levelPath, game.statusMessage);
+    if (recordPath) atexit(writeReplayAtExit);
+    startSimulation();
+    atexit(stopSimulation); // runs before the replay and trace are written and before the streamer is destroyed
+    fpsStart = Clock::now(); fpsAllocs = allocTotals();
+    glutMainLoop(); return 0;
 }
@@ -0,0 +1,103 @@
+// =====================
+// Geometry cache benchmark: vertex generation for hearts, collectibles (star + circle) and the sun
+// target, evaluated with per-vertex trig (the old draw code) and from the ShapeCache tables.
+// Vertices go into a plain float buffer so only the CPU-side math is measured.
+// =====================
+
+#define _USE_MATH_DEFINES
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "ShapeCache.h"
+
+struct VertexSink {
+    std::vector<float> v;
+    size_t n = 0;
+    void put(float x, float y) { v[n++] = x; v[n++] = y; }
+};
+
+// ---- old path: trig per vertex, as the immediate-mode draw functions used to do ----
+static void trigHeart(VertexSink& out, float x, float y, float size) {
+    for (float t = 0;t < 2 * M_PI;t += 0.05f) {
+        float X = 16 * pow(sin(t), 3);
+        float Y = 13 * cos(t) - 5 * cos(2 * t) - 2 * cos(3 * t) - cos(4 * t);
+        X /= 18; Y /= 18;
+        out.put(x + X * size, y + Y * size);
+    }
+}
+static void trigCircle(VertexSink& out, float cx, float cy, float r, int segs) {
+    out.put(cx, cy);
+    for (int i = 0;i <= segs;i++) { float a = i * 2 * M_PI / segs; out.put(cx + cos(a) * r, cy + sin(a) * r); }
+}
+static void trigStar(VertexSink& out, float cx, float cy, float outerR) {
+    const int points = 5;
+    Vec2 outer[points], inner[points];
+    for (int i = 0;i < points;i++) {
+        float a = i * 2 * M_PI / points - M_PI / 2.0f;
+        outer[i] = Vec2(cx + cos(a) * outerR, cy + sin(a) * outerR);
+        float a2 = a + M_PI / points;
+        inner[i] = Vec2(cx + cos(a2) * outerR * 0.45f, cy + sin(a2) * outerR * 0.45f);
+    }
+    for (int i = 0;i < points;i++) { int ni = (i + 1) % points; out.put(outer[i].x, outer[i].y); out.put(inner[i].x, inner[i].y); out.put(outer[ni].x, outer[ni].y); }
+}
+static void trigSun(VertexSink& out, float cx, float cy, float radius, float time) {
+    for (int layer = 3;layer >= 0;--layer) trigCircle(out, cx, cy, radius * (0.4f + 0.2f * layer), 24);
+    for (int i = 0;i < 12;i++) {
+        float a = i * 2 * M_PI / 12 + time * 0.5f; float innerR = radius * 1.05f; float outerR = radius * (1.4f + 0.2f * (i % 2));
+        out.put(cx + cos(a) * innerR, cy + sin(a) * innerR); out.put(cx + cos(a + 0.08f) * outerR, cy + sin(a + 0.08f) * outerR); out.put(cx + cos(a - 0.08f) * outerR, cy + sin(a - 0.08f) * outerR);
+    }
+    trigCircle(out, cx, cy, radius * 0.6f, 20);
+}
+
+// ---- new path: cached unit tables, multiply-add per vertex ----
+static void cachedShape(VertexSink& out, const std::vector<Vec2>& unit, float cx, float cy, float s) {
+    for (const Vec2& u : unit) out.put(cx + u.x * s, cy + u.y * s);
+}
+static void cachedCircle(VertexSink& out, float cx, float cy, float r, int segs) {
+    out.put(cx, cy); cachedShape(out, shapeCache().circle(segs), cx, cy, r);
+}
+static void cachedSun(VertexSink& out, float cx, float cy, float radius, float time) {
+    for (int layer = 3;layer >= 0;--layer) cachedCircle(out, cx, cy, radius * (0.4f + 0.2f * layer), 24);
+    float spin = time * 0.5f; float rc = cos(spin) * radius, rs = sin(spin) * radius;
+    for (const Vec2& u : shapeCache().sunRays) out.put(cx + u.x * rc - u.y * rs, cy + u.x * rs + u.y * rc);
+    cachedCircle(out, cx, cy, radius * 0.6f, 20);
+}
+
+template <class F>
+static double usPerFrame(int frames, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0;i < frames;++i) f(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+}
+
+int main() {
+    shapeCache(); // build the tables outside the timed region
+    const int collectibleCounts[] = { 100, 1000, 10000 };
+    VertexSink sink;
+
+    printf("%12s %14s %14s %9s\n", "collectibles", "trig (us)", "cached (us)", "speedup");
+    for (int n : collectibleCounts) {
+        sink.v.assign((size_t)n * 64 + 4096, 0.0f);
+        const int frames = std::max(20, 200000 / n);
+        // one frame: 5 HUD hearts, the sun target and n collectibles (star + centre circle)
+        double trig = usPerFrame(frames, [&](int f) {
+            sink.n = 0; float t = f * 0.016f;
+            for (int i = 0;i < 5;i++) trigHeart(sink, -0.9f + i * 0.08f, 0.94f, 0.03f);
+            trigSun(sink, 0.0f, 0.7f, 0.06f, t);
+            for (int i = 0;i < n;i++) { float x = -0.9f + (i % 40) * 0.045f, y = (i / 40) * 0.05f; trigStar(sink, x, y, 0.03f); trigCircle(sink, x, y, 0.01f, 8); }
+        });
+        double cached = usPerFrame(frames, [&](int f) {
+            sink.n = 0; float t = f * 0.016f;
+            for (int i = 0;i < 5;i++) cachedShape(sink, shapeCache().heart, -0.9f + i * 0.08f, 0.94f, 0.03f);
+            cachedSun(sink, 0.0f, 0.7f, 0.06f, t);
+            for (int i = 0;i < n;i++) { float x = -0.9f + (i % 40) * 0.045f, y = (i / 40) * 0.05f; cachedShape(sink, shapeCache().starTriangles, x, y, 0.03f); cachedCircle(sink, x, y, 0.01f, 8); }
+        });
+        printf("%12d %14.1f %14.1f %8.1fx\n", n, trig, cached, trig / cached);
+    }
+    return 0;
+}
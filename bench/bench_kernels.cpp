@@ -0,0 +1,140 @@
+// =====================
+// Entity kernel benchmark: the array-of-structs hypot/fabs loops the game used before the SoA move,
+// the scalar SoA kernels and the SIMD kernels, on 100k and 1M entities. The hit tests scan the whole
+// array (query points far from every entity) so the numbers are pure throughput. The swept tests have no
+// old loop; their speedup is SIMD over scalar.
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "EntityKernels.h"
+#include "EntityStore.h"
+
+// the old storage layout and loops, kept as the reference point
+struct AosCollectible { Vec2 pos; bool active = true; float phase = 0.0f; };
+struct AosObstacle { Vec2 pos; float w, h; };
+struct AosParticle { Vec2 pos, vel; float age, life; };
+
+static void aosAdvancePhases(std::vector<AosCollectible>& v, float delta) { for (auto& c : v) c.phase += delta; }
+
+static void aosIntegrateParticles(std::vector<AosParticle>& v, float dt, float damping, float gravity) {
+    for (auto& p : v) { p.vel.x *= damping; p.vel.y = p.vel.y * damping + gravity * dt; p.pos.x += p.vel.x * dt; p.pos.y += p.vel.y * dt; p.age += dt; }
+}
+
+static int aosWithinRadius(const std::vector<AosCollectible>& v, float px, float py, float r) {
+    for (size_t i = 0;i < v.size();++i) if (v[i].active && hypot(v[i].pos.x - px, v[i].pos.y - py) < r) return (int)i;
+    return -1;
+}
+
+static int aosAabbHit(const std::vector<AosObstacle>& v, float px, float py, float margin) {
+    for (size_t i = 0;i < v.size();++i) if (fabs(px - v[i].pos.x) < v[i].w + margin && fabs(py - v[i].pos.y) < v[i].h + margin) return (int)i;
+    return -1;
+}
+
+// best of reps, in ns per entity
+template <class F>
+static double nsPerEntity(int reps, size_t n, F&& f) {
+    double best = 1e30;
+    for (int r = 0;r < reps;++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / n);
+    }
+    return best;
+}
+
+int main() {
+    const size_t sizes[] = { 100000, 1000000 };
+    volatile int sink = 0;
+    uint32_t rng = 1234u;
+    auto rnd = [&](float a, float b) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return a + (float(rng >> 8) / float(1u << 24)) * (b - a); };
+
+    printf("kernel isa: %s\n", entityKernelIsa());
+    printf("%-18s %9s %12s %12s %12s %9s\n", "kernel", "entities", "AoS (ns)", "SoA scalar", "SoA simd", "speedup");
+    for (size_t n : sizes) {
+        std::vector<AosCollectible> aosC(n); std::vector<AosObstacle> aosO(n);
+        CollectibleStore soaC; ObstacleStore soaO;
+        std::vector<AosParticle> aosP(n);
+        std::vector<float> px(n), py(n), pvx(n), pvy(n), page(n, 0.0f);
+        for (size_t i = 0;i < n;++i) {
+            Collectible c; c.pos = Vec2(rnd(-1, 1), rnd(0, 100)); c.active = (i % 7) != 0; c.phase = rnd(0, 6.28f);
+            Obstacle o; o.pos = Vec2(rnd(-1, 1), rnd(0, 100)); o.w = 0.08f; o.h = 0.06f;
+            aosC[i].pos = c.pos; aosC[i].active = c.active; aosC[i].phase = c.phase; soaC.push(c);
+            aosO[i].pos = o.pos; aosO[i].w = o.w; aosO[i].h = o.h; soaO.push(o);
+            px[i] = aosP[i].pos.x = rnd(-1, 1); py[i] = aosP[i].pos.y = rnd(0, 2); pvx[i] = aosP[i].vel.x = rnd(-1, 1); pvy[i] = aosP[i].vel.y = rnd(-1, 1);
+            aosP[i].age = 0.0f; aosP[i].life = 1.0f;
+        }
+        const int reps = 7;
+        const float far = 1000.0f; // never within reach of any entity, so every scan runs to the end
+        auto row = [&](const char* name, double aos, double scalar, double simd) {
+            if (aos < 0.0) printf("%-18s %9zu %12s %12.3f %12.3f %8.1fx\n", name, n, "-", scalar, simd, scalar / simd);
+            else printf("%-18s %9zu %12.3f %12.3f %12.3f %8.1fx\n", name, n, aos, scalar, simd, aos / simd);
+        };
+
+        row("advancePhases",
+            nsPerEntity(reps, n, [&] { aosAdvancePhases(aosC, 0.032f); }),
+            nsPerEntity(reps, n, [&] { advancePhasesScalar(soaC.phase.data(), n, 0.032f); }),
+            nsPerEntity(reps, n, [&] { advancePhases(soaC.phase.data(), n, 0.032f); }));
+        // damping 1 and no gravity keep the values from drifting towards denormals over the repetitions
+        row("integrateParticles",
+            nsPerEntity(reps, n, [&] { aosIntegrateParticles(aosP, 0.016f, 1.0f, 0.0f); }),
+            nsPerEntity(reps, n, [&] { integrateParticlesScalar(px.data(), py.data(), pvx.data(), pvy.data(), page.data(), n, 0.016f, 1.0f, 0.0f); }),
+            nsPerEntity(reps, n, [&] { integrateParticles(px.data(), py.data(), pvx.data(), pvy.data(), page.data(), n, 0.016f, 1.0f, 0.0f); }));
+        row("withinRadius",
+            nsPerEntity(reps, n, [&] { sink += aosWithinRadius(aosC, far, far, 0.07f); }),
+            nsPerEntity(reps, n, [&] { sink += firstWithinRadiusScalar(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, far, far, 0.07f * 0.07f); }),
+            nsPerEntity(reps, n, [&] { sink += firstWithinRadius(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, far, far, 0.07f * 0.07f); }));
+        row("aabbHit",
+            nsPerEntity(reps, n, [&] { sink += aosAabbHit(aosO, far, far, 0.04f); }),
+            nsPerEntity(reps, n, [&] { sink += firstAabbHitScalar(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, far, far, 0.04f); }),
+            nsPerEntity(reps, n, [&] { sink += firstAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, far, far, 0.04f); }));
+        const Sweep farMove(far, far, far + 0.5f, far + 0.3f);
+        float t = 0.0f;
+        row("sweptAabb", -1.0,
+            nsPerEntity(reps, n, [&] { sink += earliestSweptAabbHitScalar(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, farMove, 0.04f, t); }),
+            nsPerEntity(reps, n, [&] { sink += earliestSweptAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, farMove, 0.04f, t); }));
+        row("sweptCircle", -1.0,
+            nsPerEntity(reps, n, [&] { sink += earliestSweptCircleHitScalar(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, farMove, 0.07f * 0.07f, t); }),
+            nsPerEntity(reps, n, [&] { sink += earliestSweptCircleHit(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, farMove, 0.07f * 0.07f, t); }));
+
+        // the kernels must agree with the old loops on real hits, not only on misses
+        int mismatches = 0;
+        for (int q = 0;q < 2000;++q) {
+            float px = rnd(-1, 1), py = rnd(0, 100);
+            int a = aosWithinRadius(aosC, px, py, 0.07f), b = firstWithinRadius(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, px, py, 0.07f * 0.07f);
+            int c = aosAabbHit(aosO, px, py, 0.04f), d = firstAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, px, py, 0.04f);
+            mismatches += (a != b) + (c != d);
+            // and the swept SIMD kernels with their scalar versions, index and t
+            Sweep sw(px, py, px + rnd(-0.5f, 0.5f), py + rnd(-0.5f, 0.5f));
+            float t1 = -1.0f, t2 = -1.0f;
+            a = earliestSweptAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, sw, 0.04f, t1);
+            b = earliestSweptAabbHitScalar(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), nullptr, n, sw, 0.04f, t2);
+            mismatches += a != b || t1 != t2;
+            // with a mask (the collectibles' active bits stand in for destroyed obstacles)
+            a = earliestSweptAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), soaC.active.words(), n, sw, 0.04f, t1);
+            b = earliestSweptAabbHitScalar(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), soaC.active.words(), n, sw, 0.04f, t2);
+            mismatches += a != b || t1 != t2;
+            c = firstAabbHit(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), soaC.active.words(), n, px, py, 0.04f);
+            d = firstAabbHitScalar(soaO.x.data(), soaO.y.data(), soaO.w.data(), soaO.h.data(), soaC.active.words(), n, px, py, 0.04f);
+            mismatches += c != d;
+            a = earliestSweptCircleHit(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, sw, 0.07f * 0.07f, t1);
+            b = earliestSweptCircleHitScalar(soaC.x.data(), soaC.y.data(), soaC.active.words(), n, sw, 0.07f * 0.07f, t2);
+            mismatches += a != b || t1 != t2;
+        }
+        // one damped step with gravity: the SIMD integration must match the scalar one bit for bit
+        {
+            std::vector<float> x2 = px, y2 = py, vx2 = pvx, vy2 = pvy, age2 = page;
+            integrateParticles(px.data(), py.data(), pvx.data(), pvy.data(), page.data(), n, 0.016f, 0.97f, -0.5f);
+            integrateParticlesScalar(x2.data(), y2.data(), vx2.data(), vy2.data(), age2.data(), n, 0.016f, 0.97f, -0.5f);
+            mismatches += x2 != px || y2 != py || vx2 != pvx || vy2 != pvy || age2 != page;
+        }
+        if (mismatches) printf("  %d result mismatch(es) against the AoS loops or the scalar kernels\n", mismatches);
+        sink += (int)aosC[0].phase + (int)soaC.phase[0];
+    }
+    return 0;
+}
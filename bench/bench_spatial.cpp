@@ -0,0 +1,78 @@
+// =====================
+// Spatial index benchmark: per-query cost of the grid-backed lookups against the old full scans,
+// on levels of growing size at constant object density (the grid cost should stay flat).
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "GameCore.h"
+
+// the pre-grid implementations (one flat scan over every chunk), kept here as the reference point
+static int linearObstacleIndexAt(const GameState& s, float nx, float ny) {
+    int hit = -1;
+    s.chunks.forEachResident([&](const LevelChunk& ch) {
+        const ObstacleStore& o = ch.obstacles;
+        for (size_t i = 0;hit < 0 && i < o.size();++i) if (fabs(nx - o.x[i]) < (o.w[i] + 0.04f) && fabs(ny - o.y[i]) < (o.h[i] + 0.04f)) hit = (int)i;
+    });
+    return hit;
+}
+
+static bool linearTooCloseToExisting(const GameState& s, const Vec2& p, float minDist) {
+    bool near = false;
+    s.chunks.forEachResident([&](const LevelChunk& ch) {
+        const CollectibleStore& c = ch.collectibles; const ObstacleStore& o = ch.obstacles; const PowerupStore& pu = ch.powerups;
+        for (size_t i = 0;!near && i < c.size();++i) near = c.active.test(i) && hypot(c.x[i] - p.x, c.y[i] - p.y) < minDist;
+        for (size_t i = 0;!near && i < o.size();++i) near = hypot(o.x[i] - p.x, o.y[i] - p.y) < minDist;
+        for (size_t i = 0;!near && i < pu.size();++i) near = pu.active.test(i) && hypot(pu.x[i] - p.x, pu.y[i] - p.y) < minDist;
+    });
+    return near;
+}
+
+// fills a band of the given height with n objects (obstacles, collectibles, power-ups in 2:2:1)
+static void buildLevel(GameState& s, int n, float bandHeight) {
+    initGame(s, 1234u);
+    for (int i = 0;i < n;++i) {
+        Vec2 p(randf(s, -0.98f, 0.98f), randf(s, 0.0f, bandHeight));
+        int kind = i % 5;
+        if (kind < 2) { Obstacle o; o.pos = p; o.w = 0.08f; o.h = 0.06f; addObstacle(s, o); }
+        else if (kind < 4) { Collectible c; c.pos = p; c.phase = 0.0f; addCollectible(s, c); }
+        else { PowerUp pu; pu.pos = p; pu.type = (i & 1) ? P_SPEED : P_SHIELD; addPowerup(s, pu); }
+    }
+}
+
+template <class F>
+static double nsPerQuery(int queries, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0;i < queries;++i) f(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / queries;
+}
+
+int main() {
+    const float areaPerObject = 0.02f; // roughly an editor-authored density
+    const int sizes[] = { 1000, 10000, 100000 };
+    volatile int sink = 0;
+
+    printf("%10s %16s %16s %16s %16s\n", "objects", "obstacle grid", "obstacle scan", "tooClose grid", "tooClose scan");
+    for (int n : sizes) {
+        float band = n * areaPerObject / 2.0f;
+        GameState s; buildLevel(s, n, band);
+
+        // same pseudo-random query points for both paths
+        std::vector<Vec2> pts(4096);
+        for (auto& p : pts) p = Vec2(randf(s, -1.0f, 1.0f), randf(s, 0.0f, band));
+        const int gridQueries = 200000;
+        const int scanQueries = std::max(200, 20000000 / n);
+
+        double og = nsPerQuery(gridQueries, [&](int i) { const Vec2& p = pts[i & 4095]; sink += obstacleAt(s, p.x, p.y).index; });
+        double os = nsPerQuery(scanQueries, [&](int i) { const Vec2& p = pts[i & 4095]; sink += linearObstacleIndexAt(s, p.x, p.y); });
+        double tg = nsPerQuery(gridQueries, [&](int i) { sink += tooCloseToExisting(s, pts[i & 4095], 0.08f); });
+        double ts = nsPerQuery(scanQueries, [&](int i) { sink += linearTooCloseToExisting(s, pts[i & 4095], 0.08f); });
+        printf("%10d %13.1f ns %13.1f ns %13.1f ns %13.1f ns\n", n, og, os, tg, ts);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// =====================
+// Streaming benchmark: writes a level far too big to keep resident (10M entities by default) one chunk
+// at a time, then flies the camera up through it at a fixed frame rate with a ChunkStreamer paging
+// chunks in and out under a memory budget. Reports the per-frame cost of ChunkStreamer::update() (the
+// main-thread side), the frames where the view was still waiting for a chunk, and peak resident memory.
+// The file has just been written, so reads mostly come from the page cache; drop caches for a cold run.
+// Exit code 2 if the view ever had to wait.
+//
+//   bench_streaming [--entities N] [--density per-unit-height] [--budget-mb MB] [--speed units/s]
+//                   [--seconds S] [--file path] [--keep]
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ChunkStreamer.h"
+#include "GameCore.h"
+#include "LevelFile.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double msSince(Clock::time_point t0) { return std::chrono::duration<double, std::milli>(Clock::now() - t0).count(); }
+
+// entities (obstacles, collectibles, power-ups in 2:2:1) at uniform density from WORLD_BOTTOM to top
+static LevelStatus writeLevel(const char* path, long long entities, float density, float& top) {
+    top = WORLD_BOTTOM + (float)(entities / density);
+    const int bands = chunkBand(top) + 1;
+    const long long perBand = (long long)(density * CHUNK_HEIGHT);
+    GameState s; initGame(s, 4321u);
+    LevelWriter w;
+    LevelStatus st = w.open(path);
+    long long made = 0;
+    for (int b = 0;st == LEVEL_OK && b < bands;++b) {
+        float y0 = WORLD_BOTTOM + b * CHUNK_HEIGHT;
+        for (long long i = 0;i < perBand && made < entities;++i, ++made) {
+            Vec2 p(randf(s, -0.98f, 0.98f), randf(s, y0, y0 + CHUNK_HEIGHT - 0.001f));
+            int kind = (int)(made % 5);
+            if (kind < 2) { Obstacle o; o.pos = p; o.w = 0.02f; o.h = 0.015f; addObstacle(s, o); }
+            else if (kind < 4) { Collectible c; c.pos = p; c.phase = randf(s, 0, 6.28f); addCollectible(s, c); }
+            else { PowerUp pu; pu.pos = p; pu.type = (made & 1) ? P_SPEED : P_SHIELD; addPowerup(s, pu); }
+        }
+        std::unique_ptr<LevelChunk> ch = s.chunks.release(b); // written and freed band by band
+        if (ch) st = w.addChunk(*ch);
+    }
+    s.targetBezier.clear();
+    for (int i = 0;i < 4;++i) s.targetBezier.push_back(Vec2(-0.6f + 0.4f * i, top - 0.3f));
+    return st == LEVEL_OK ? w.finish(s.targetBezier, std::max(top, WORLD_TOP), s.chunks.obstacleReach(), s.motion) : st;
+}
+
+int main(int argc, char** argv) {
+    long long entities = 10000000; float density = 100.0f; int budgetMb = 1; float speed = 60.0f; float seconds = 10.0f;
+    const char* path = "bench_streaming_level.splv"; bool keep = false;
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--entities") && i + 1 < argc) entities = std::max(1LL, atoll(argv[++i]));
+        else if (!strcmp(argv[i], "--density") && i + 1 < argc) density = std::max(1.0f, (float)atof(argv[++i]));
+        else if (!strcmp(argv[i], "--budget-mb") && i + 1 < argc) budgetMb = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--speed") && i + 1 < argc) speed = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--file") && i + 1 < argc) path = argv[++i];
+        else if (!strcmp(argv[i], "--keep")) keep = true;
+        else { fprintf(stderr, "usage: %s [--entities N] [--density per-unit-height] [--budget-mb MB] [--speed units/s] [--seconds S] [--file path] [--keep]\n", argv[0]); return 1; }
+    }
+
+    float top = 0.0f;
+    Clock::time_point t0 = Clock::now();
+    LevelStatus st = writeLevel(path, entities, density, top);
+    if (st != LEVEL_OK) { fprintf(stderr, "%s: %s\n", path, levelStatusText(st)); return 1; }
+    FILE* f = fopen(path, "rb"); fseek(f, 0, SEEK_END); long long fileBytes = ftell(f); fclose(f);
+    printf("wrote %lld entities in %d chunks (world height %.0f, %.1f MB) in %.0f ms\n", entities, chunkBand(top) + 1, top - WORLD_BOTTOM, fileBytes / 1048576.0, msSince(t0));
+
+    GameState game; initGame(game, 1u);
+    ChunkStreamer streamer((size_t)budgetMb << 20);
+    t0 = Clock::now();
+    if ((st = streamer.open(game, path)) != LEVEL_OK) { fprintf(stderr, "%s: %s\n", path, levelStatusText(st)); return 1; }
+    streamer.update(game, game.cameraY); streamer.waitIdle(); // the first view is loaded up front, as a loading screen would
+    printf("opened in %.2f ms\n", msSince(t0));
+
+    // fly up at 60 frames per second; a frame is stalled while any band under the view is not resident
+    const double frameMs = 1000.0 / 60.0;
+    const int frames = (int)(seconds * 60.0f);
+    std::vector<double> updateMs;
+    int stalled = 0;
+    volatile int sink = 0;
+    Clock::time_point next = Clock::now();
+    for (int i = 0;i < frames;++i) {
+        float y = std::min(CAMERA_MIN_Y + speed * i / 60.0f, cameraMaxY(game));
+        game.cameraY = y;
+        Clock::time_point u0 = Clock::now();
+        streamer.update(game, y);
+        updateMs.push_back(msSince(u0));
+        if (bandsPending(game, y - 1.0f, y + 1.0f)) ++stalled;
+        for (int q = 0;q < 64;++q) sink += obstacleAt(game, -1.0f + q / 32.0f, y - 1.0f + q / 32.0f).index; // some gameplay queries
+        next += std::chrono::microseconds((long long)(frameMs * 1000.0));
+        std::this_thread::sleep_until(next);
+    }
+
+    const StreamStats& ss = streamer.stats();
+    std::vector<double> sorted = updateMs;
+    std::sort(sorted.begin(), sorted.end());
+    printf("%d frames, camera %.0f units at %.0f units/s, budget %d MB\n", frames, std::min(speed * seconds, cameraMaxY(game) - CAMERA_MIN_Y), speed, budgetMb);
+    printf("update   p50 %8.3f  p99 %8.3f  max %8.3f ms\n", sorted[sorted.size() / 2], sorted[(size_t)(0.99 * (sorted.size() - 1) + 0.5)], sorted.back());
+    printf("stalled  %d frame(s) with the view waiting for a chunk\n", stalled);
+    printf("resident peak %.1f MB (%d chunks now), %d loads, %d evictions, %d write-backs, %d failures\n", ss.peakBytes / 1048576.0, ss.residentChunks, ss.loads, ss.evictions, ss.writebacks, ss.failures);
+    if (!keep) remove(path);
+    return stalled ? 2 : 0;
+}
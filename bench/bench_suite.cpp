@@ -0,0 +1,262 @@
+// =====================
+// Benchmark suite: synthetic levels of 1k to 1M objects, each hot path timed on its own.
+// Prints a table, optionally writes the results as JSON (--json) and compares them with a stored
+// baseline (--baseline), flagging anything slower than the tolerance. Exit code 2 on regression.
+//
+//   bench_suite [--json out.json] [--baseline bench/baseline.json] [--tolerance 0.15]
+//               [--max-objects N] [--reps N]
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DrawList.h"
+#include "GameCore.h"
+#include "LevelFile.h"
+#include "LevelGen.h"
+#include "Particles.h"
+#include "Scene.h"
+#include "VecEnv.h"
+
+struct BenchResult { std::string name; int objects; double nsPerOp; };
+
+// fills a band of constant object density with n objects (obstacles, collectibles, power-ups in 2:2:1)
+static void buildLevel(GameState& s, int n) {
+    const float areaPerObject = 0.02f;
+    float band = std::max(2.0f, n * areaPerObject / 2.0f);
+    initGame(s, 1234u);
+    for (int i = 0;i < n;++i) {
+        Vec2 p(randf(s, -0.98f, 0.98f), randf(s, 0.0f, band));
+        int kind = i % 5;
+        if (kind < 2) { Obstacle o; o.pos = p; o.w = 0.08f; o.h = 0.06f; addObstacle(s, o); }
+        else if (kind < 4) { Collectible c; c.pos = p; c.phase = randf(s, 0, 6.28f); addCollectible(s, c); }
+        else { PowerUp pu; pu.pos = p; pu.type = (i & 1) ? P_SPEED : P_SHIELD; addPowerup(s, pu); }
+    }
+}
+
+// median over reps of the per-op time of `ops` calls to f(i)
+template <class F>
+static double nsPerOp(int reps, int ops, F&& f) {
+    std::vector<double> runs;
+    for (int r = 0;r < reps;++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0;i < ops;++i) f(i);
+        auto t1 = std::chrono::steady_clock::now();
+        runs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / ops);
+    }
+    std::nth_element(runs.begin(), runs.begin() + runs.size() / 2, runs.end());
+    return runs[runs.size() / 2];
+}
+
+// ---- JSON: one result per line, so the baseline reader can stay a sscanf loop ----
+static bool writeJson(const char* path, const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"unit\": \"ns_per_op\",\n  \"results\": [\n");
+    for (size_t i = 0;i < results.size();++i)
+        fprintf(f, "    {\"name\": \"%s\", \"objects\": %d, \"ns_per_op\": %.2f}%s\n", results[i].name.c_str(), results[i].objects, results[i].nsPerOp, i + 1 < results.size() ? "," : "");
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+static bool readJson(const char* path, std::vector<BenchResult>& results) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[512], name[128]; int objects; double ns;
+    while (fgets(line, sizeof(line), f)) {
+        const char* p = strstr(line, "{\"name\"");
+        if (p && sscanf(p, "{\"name\": \"%127[^\"]\", \"objects\": %d, \"ns_per_op\": %lf", name, &objects, &ns) == 3) {
+            BenchResult r; r.name = name; r.objects = objects; r.nsPerOp = ns; results.push_back(r);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr; const char* baselinePath = nullptr;
+    double tolerance = 0.15; int maxObjects = 1000000; int reps = 5;
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max-objects") && i + 1 < argc) maxObjects = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--reps") && i + 1 < argc) reps = std::max(1, atoi(argv[++i]));
+        else { fprintf(stderr, "usage: %s [--json out.json] [--baseline file] [--tolerance 0.15] [--max-objects N] [--reps N]\n", argv[0]); return 1; }
+    }
+
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    std::vector<BenchResult> results;
+    volatile int sink = 0;
+    auto record = [&](const char* name, int n, double ns) {
+        BenchResult r; r.name = name; r.objects = n; r.nsPerOp = ns; results.push_back(r);
+        printf("%-22s %9d %14.1f ns\n", name, n, ns);
+        fflush(stdout);
+    };
+
+    printf("%-22s %9s %17s\n", "benchmark", "objects", "per op");
+    for (int n : sizes) {
+        if (n > maxObjects) break;
+        GameState s; buildLevel(s, n);
+        float band = std::max(2.0f, n * 0.02f / 2.0f);
+        std::vector<Vec2> pts(4096);
+        for (auto& p : pts) p = Vec2(randf(s, -1.0f, 1.0f), randf(s, 0.0f, band));
+        const int queries = 200000;
+
+        // collision queries
+        record("obstacleAt", n, nsPerOp(reps, queries, [&](int i) { const Vec2& p = pts[i & 4095]; sink += obstacleAt(s, p.x, p.y).index; }));
+        // a long move (five default steps, diagonally), the case swept collision exists for
+        record("sweepObstacles", n, nsPerOp(reps, queries, [&](int i) { const Vec2& p = pts[i & 4095]; float t; sink += sweepObstacles(s, p, Vec2(p.x + 0.18f, p.y + 0.18f), t).index; }));
+        // collecting mutates the level, so every rep works on a fresh copy (the copy is outside the timing)
+        {
+            std::vector<double> runs;
+            for (int r = 0;r < reps;++r) {
+                GameState c = s;
+                runs.push_back(nsPerOp(1, queries, [&](int i) { const Vec2& p = pts[i & 4095]; sink += collectAt(c, p.x, p.y); }));
+            }
+            std::nth_element(runs.begin(), runs.begin() + runs.size() / 2, runs.end());
+            record("collectAt", n, runs[runs.size() / 2]);
+            runs.clear();
+            for (int r = 0;r < reps;++r) {
+                GameState c = s;
+                runs.push_back(nsPerOp(1, queries, [&](int i) { const Vec2& p = pts[i & 4095]; PowerUp got; EntityRef ref; sink += powerupAt(c, p.x, p.y, got, ref); }));
+            }
+            std::nth_element(runs.begin(), runs.begin() + runs.size() / 2, runs.end());
+            record("powerupAt", n, runs[runs.size() / 2]);
+        }
+        // editor placement validation
+        record("tooCloseToExisting", n, nsPerOp(reps, queries, [&](int i) { sink += tooCloseToExisting(s, pts[i & 4095], 0.08f); }));
+
+        // one simulation tick: phase animation loops, Bezier target, timers (no input)
+        const int ticks = std::max(5, 2000000 / n);
+        Inputs none = {};
+        record("tick", n, nsPerOp(reps, ticks, [&](int) { step(s, none, 0.016f); }));
+
+        // n path followers advanced one tick (ns per follower): 16 Catmull-Rom loops, followers spread over them
+        {
+            LevelMotion m;
+            for (int k = 0;k < 16;++k) {
+                const Vec2 loop[5] = { Vec2(-0.3f, 0.0f), Vec2(0.0f, 0.05f * (k + 1)), Vec2(0.3f, 0.0f), Vec2(0.1f, -0.1f), Vec2(-0.1f, -0.05f) };
+                m.paths.addCatmullRom(loop, 5, k & 1);
+            }
+            for (int i = 0;i < n;++i) {
+                int path = i & 15;
+                m.obstacles.motion.push((uint32_t)path, pts[i & 4095], randf(s, 0.0f, m.paths.period(path)), randf(s, 0.1f, 0.4f), Vec2());
+            }
+            const int ticks = std::max(3, 2000000 / n);
+            record("advanceMovers", n, nsPerOp(reps, ticks, [&](int) { advanceMovers(m.paths, m.obstacles.motion, 0.016f); }) / n);
+            sink += (int)m.obstacles.motion.x[n / 2];
+        }
+
+        // one full scene rebuild into a reused draw list
+        {
+            DrawList dl; HudText hud;
+            FramePose pose = currentPose(s);
+            buildScene(s, pose, dl, hud); // warm-up: grows the batch storage once
+            const int frames = std::max(3, 200000 / n);
+            record("buildScene", n, nsPerOp(reps, frames, [&](int) { buildScene(s, pose, dl, hud); }));
+        }
+
+        // editor solvability: building the map from scratch, and repairing it after an obstacle is placed on the
+        // route just above the rocket and removed again (two incremental solves per op)
+        {
+            record("solvabilityBuild", n, nsPerOp(reps, 1, [&](int) { s.solvability.invalidate(); updateSolvability(s); }));
+            Obstacle o; o.pos = Vec2(s.playerX, s.playerY + 0.3f); o.w = 0.08f; o.h = 0.06f;
+            const int edits = 200;
+            record("solvabilityRepair", n, nsPerOp(reps, edits, [&](int) {
+                addObstacle(s, o); updateSolvability(s);
+                EntityRef ref; ref.band = chunkBand(o.pos.y); ref.index = (int)s.chunks.at(ref.band)->obstacles.size() - 1;
+                removeObstacle(s, ref); updateSolvability(s);
+            }));
+            sink += (int)s.solvability.path().size();
+        }
+
+        // procedural generation of an n-object level into an empty session (ns per object placed; the session
+        // is set up outside the timing)
+        {
+            std::vector<double> runs;
+            for (int r = 0;r < reps;++r) {
+                GameState g; initGame(g, 77u);
+                LevelGenOptions o; o.count = (size_t)n; o.seed = 77u + r;
+                size_t placed = 0;
+                runs.push_back(nsPerOp(1, 1, [&](int) { placed = generateLevel(g, o); }) / std::max<size_t>(placed, 1));
+            }
+            std::nth_element(runs.begin(), runs.begin() + runs.size() / 2, runs.end());
+            record("generateLevel", n, runs[runs.size() / 2]);
+        }
+
+        // opening a saved level (the file stays in the page cache between reps, as it would after a save)
+        {
+            const char* path = "bench_suite_level.splv";
+            if (saveLevel(s, path) != LEVEL_OK) { fprintf(stderr, "could not write %s\n", path); return 1; }
+            GameState loaded; initGame(loaded, 1u);
+            record("loadLevel", n, nsPerOp(reps, 1, [&](int) { sink += loadLevel(loaded, path); }));
+            remove(path);
+        }
+    }
+
+    // target path evaluation does not depend on level size
+    {
+        GameState s; initGame(s, 1u);
+        const int evals = 1000000;
+        float acc = 0.0f;
+        record("bezierPoint", 0, nsPerOp(reps, evals, [&](int i) { Vec2 p = bezierPoint(s.targetBezier.data(), (i & 1023) * (1.0f / 1023.0f)); acc += p.x + p.y; }));
+        // the same curve through its arc-length table
+        const float period = s.targetPath.period(0);
+        record("pathSample", 0, nsPerOp(reps, evals, [&](int i) { Vec2 p = s.targetPath.sample(0, (i & 1023) * (period / 1023.0f)); acc += p.x + p.y; }));
+        sink += (int)acc;
+    }
+
+    // a full spark pool (the particle budget) integrated and drawn once per frame, per particle; the lives are
+    // long enough that none expire during the run
+    {
+        ParticleSystem ps; DrawList dl;
+        uint32_t rng = 99u;
+        auto rnd = [&](float a, float b) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return a + float(rng >> 8) / float(1u << 24) * (b - a); };
+        while (ps.sparks.spawn(rnd(-1, 1), rnd(-1, 1), rnd(-0.5f, 0.5f), rnd(-0.5f, 0.5f), 1e6f, 0.0f, packColor(1.0f, 0.6f, 0.2f, 1.0f))) {}
+        const int frames = 20;
+        record("particles", (int)PARTICLE_BUDGET, nsPerOp(reps, frames, [&](int) { dl.clear(); updateParticles(ps, 0.016f); drawParticles(ps, dl); }) / PARTICLE_BUDGET);
+        sink += (int)dl.vertexCount();
+    }
+
+    // the batched environment: 1024 rounds of a 200-object level stepped together, per instance step
+    {
+        GameState level; initGame(level, 7u);
+        LevelGenOptions o; o.count = 200; o.seed = 7u; generateLevel(level, o);
+        VecEnv env(level, 1024);
+        std::vector<uint8_t> actions(env.size());
+        for (size_t i = 0;i < actions.size();++i) actions[i] = (uint8_t)(i % 3 ? ACT_UP : ACT_UP_RIGHT);
+        const int steps = 60;
+        record("vecEnvStep", 0, nsPerOp(reps, steps, [&](int) { env.step(actions.data()); }) / env.size());
+        sink += (int)env.roundsFinished();
+    }
+
+    if (jsonPath) {
+        if (writeJson(jsonPath, results)) printf("\nresults written to %s\n", jsonPath);
+        else { fprintf(stderr, "could not write %s\n", jsonPath); return 1; }
+    }
+
+    int regressions = 0;
+    if (baselinePath) {
+        std::vector<BenchResult> base;
+        if (!readJson(baselinePath, base)) { fprintf(stderr, "could not read baseline %s\n", baselinePath); return 1; }
+        printf("\n%-22s %9s %12s %12s %8s\n", "vs baseline", "objects", "base (ns)", "now (ns)", "ratio");
+        for (const BenchResult& r : results) {
+            const BenchResult* b = nullptr;
+            for (const BenchResult& c : base) if (c.name == r.name && c.objects == r.objects) { b = &c; break; }
+            if (!b) { printf("%-22s %9d %12s %12.1f %8s\n", r.name.c_str(), r.objects, "-", r.nsPerOp, "new"); continue; }
+            double ratio = r.nsPerOp / b->nsPerOp;
+            bool slower = ratio > 1.0 + tolerance;
+            regressions += slower;
+            printf("%-22s %9d %12.1f %12.1f %7.2fx%s\n", r.name.c_str(), r.objects, b->nsPerOp, r.nsPerOp, ratio, slower ? "  REGRESSION" : "");
+        }
+        printf("%d regression(s) beyond %.0f%%\n", regressions, tolerance * 100.0);
+    }
+    return regressions ? 2 : 0;
+}
@@ -0,0 +1,105 @@
+// =====================
+// Batched environment benchmark: N instances of a generated level stepped together with a fixed pseudo-random
+// policy (mostly climbing), at 1, 2, 4 ... threads. Reports instance steps per second and checks that
+// every thread count ends in the same observations, rewards and round counts, and that the first few
+// instances match a plain GameState stepped one tick at a time with the same held keys. Exit code 2 on any
+// difference.
+//
+//   bench_vecenv [--instances N] [--objects N] [--steps N] [--max-threads T]
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "GameCore.h"
+#include "JobSystem.h"
+#include "LevelGen.h"
+#include "VecEnv.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t fnv(uint64_t h, const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0;i < bytes;++i) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+// the actions of one step: up, up-left or up-right most of the time, anything now and then
+static void policy(uint32_t& rng, std::vector<uint8_t>& actions) {
+    static const uint8_t CLIMB[3] = { ACT_UP, ACT_UP_LEFT, ACT_UP_RIGHT };
+    for (uint8_t& a : actions) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        a = (rng >> 8) % 8 ? CLIMB[(rng >> 4) % 3] : (uint8_t)((rng >> 12) % ACT_COUNT);
+    }
+}
+
+int main(int argc, char** argv) {
+    int instances = 4096, objects = 200, steps = 600;
+    int maxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--instances") && i + 1 < argc) instances = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--objects") && i + 1 < argc) objects = std::max(0, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc) maxThreads = std::max(1, atoi(argv[++i]));
+        else { fprintf(stderr, "usage: %s [--instances N] [--objects N] [--steps N] [--max-threads T]\n", argv[0]); return 1; }
+    }
+
+    GameState level; initGame(level, 7u);
+    LevelGenOptions o; o.count = (size_t)objects; o.seed = 7u;
+    size_t placed = generateLevel(level, o);
+    std::vector<int> counts;
+    for (int t = 1;t < maxThreads;t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    printf("%d instances of a %zu-object level, %d steps, %u hardware threads\n", instances, placed, steps, std::thread::hardware_concurrency());
+    printf("%8s %12s %16s %8s %8s\n", "threads", "time (ms)", "steps/s", "speedup", "rounds");
+    const int checked = std::min(instances, 8);
+    std::vector<uint8_t> actions(instances);
+    double ms1 = 0.0; uint64_t hash1 = 0;
+    int mismatches = 0;
+    for (int threads : counts) {
+        setJobThreads(threads);
+        VecEnv env(level, (size_t)instances);
+        std::vector<float> returns(instances, 0.0f);
+        // the reference: the first instances as plain GameStates, ticked the way the front end does
+        std::vector<GameState> ref(checked, level);
+        for (GameState& g : ref) if (!g.gameStarted) applyKey(g, 'r');
+        const GameState refStart = ref.empty() ? level : ref[0];
+        uint32_t rng = 2024u;
+        double ms = 0.0;
+        for (int s = 0;s < steps;++s) {
+            policy(rng, actions);
+            Clock::time_point t0 = Clock::now();
+            env.step(actions.data());
+            ms += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            for (int i = 0;i < instances;++i) returns[i] += env.rewards()[i];
+            for (int i = 0;i < checked;++i) {
+                GameState& g = ref[i];
+                Inputs in;
+                in.moveX = (float)(actions[i] == ACT_RIGHT || actions[i] == ACT_UP_RIGHT || actions[i] == ACT_DOWN_RIGHT) - (float)(actions[i] == ACT_LEFT || actions[i] == ACT_UP_LEFT || actions[i] == ACT_DOWN_LEFT);
+                in.moveY = (float)(actions[i] == ACT_UP || actions[i] == ACT_UP_LEFT || actions[i] == ACT_UP_RIGHT) - (float)(actions[i] == ACT_DOWN || actions[i] == ACT_DOWN_LEFT || actions[i] == ACT_DOWN_RIGHT);
+                step(g, in, env.config().dt);
+                if (g.gameOver) g = refStart;
+            }
+        }
+        for (int i = 0;i < checked;++i) {
+            const RoundState& a = env.round(i); const GameState& b = ref[i];
+            mismatches += a.score != b.score || a.lives != b.lives || memcmp(&a.playerX, &b.playerX, sizeof(float)) || memcmp(&a.playerY, &b.playerY, sizeof(float)) ||
+                          memcmp(&a.gameTimer, &b.gameTimer, sizeof(float));
+        }
+        uint64_t h = fnv(1469598103934665603ull, env.observations(), (size_t)instances * VEC_OBS_DIM * sizeof(float));
+        h = fnv(h, returns.data(), returns.size() * sizeof(float));
+        uint64_t rounds = env.roundsFinished(); h = fnv(h, &rounds, sizeof(rounds));
+        if (threads == counts[0]) { ms1 = ms; hash1 = h; }
+        bool same = h == hash1;
+        mismatches += !same;
+        printf("%8d %12.1f %16.0f %7.2fx %8llu%s\n", threads, ms, (double)instances * steps / (ms * 1e-3), ms1 / ms, (unsigned long long)rounds, same ? "" : "  RESULT DIFFERS");
+    }
+    if (mismatches) printf("%d mismatch(es) against the reference or between thread counts\n", mismatches);
+    return mismatches ? 2 : 0;
+}
@@ -0,0 +1,65 @@
+#include "AllocCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// relaxed counters: readers only need totals that are right once the threads they care about have synchronised
+static std::atomic<uint64_t> allocCount{ 0 }, allocBytes{ 0 };
+
+AllocTotals allocTotals() {
+    AllocTotals t;
+    t.count = allocCount.load(std::memory_order_relaxed);
+    t.bytes = allocBytes.load(std::memory_order_relaxed);
+    return t;
+}
+
+static void* countedAlloc(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+static void* countedAlignedAlloc(size_t size, size_t align) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+static void alignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// =====================
+// Replacement operators (every form that allocates or frees, so no pointer crosses to the library's own)
+// =====================
+void* operator new(size_t size) { if (void* p = countedAlloc(size)) return p; throw std::bad_alloc(); }
+void* operator new[](size_t size) { if (void* p = countedAlloc(size)) return p; throw std::bad_alloc(); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) { if (void* p = countedAlignedAlloc(size, (size_t)align)) return p; throw std::bad_alloc(); }
+void* operator new[](size_t size, std::align_val_t align) { if (void* p = countedAlignedAlloc(size, (size_t)align)) return p; throw std::bad_alloc(); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, (size_t)align); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
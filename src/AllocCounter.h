@@ -0,0 +1,23 @@
+#pragma once
+
+// =====================
+// Heap allocation counting. AllocCounter.cpp replaces the global operator new and delete with versions
+// that count every allocation and its size, on any thread, so a frame's allocations can be read as the
+// difference of two readings. Replacing operator new is program-wide, so AllocCounter.cpp is its own build
+// target (space_alloc_counter), linked only into the game and the headless renderer; the libraries,
+// benchmarks and replay runner keep the default allocator.
+// =====================
+
+#include <cstdint>
+
+struct AllocTotals { uint64_t count = 0, bytes = 0; };
+
+// operator new calls and bytes requested since the program started, all threads together
+AllocTotals allocTotals();
+
+// what was allocated since an earlier reading
+inline AllocTotals allocsSince(const AllocTotals& before) {
+    AllocTotals now = allocTotals();
+    now.count -= before.count; now.bytes -= before.bytes;
+    return now;
+}
@@ -0,0 +1,231 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+ChunkStreamer::ChunkStreamer(size_t budgetBytes) {
+    counters.budgetBytes = budgetBytes;
+    worker = std::thread([this] { run(); });
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    { std::lock_guard<std::mutex> lock(mutex); quit = true; }
+    wake.notify_all();
+    worker.join();
+    if (source) fclose(source);
+    if (swap) fclose(swap); // tmpfile(): removed on close
+}
+
+// =====================
+// I/O thread
+// =====================
+
+void ChunkStreamer::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || !jobs.empty(); });
+            if (jobs.empty()) return; // quit, with nothing left to write
+            job = std::move(jobs.front()); jobs.pop_front();
+            busy = true;
+        }
+        Result out; out.band = job.band; out.status = LEVEL_OK;
+        const int b = job.band;
+        if (job.kind == JOB_LOAD) {
+            bool known = b < (int)where.size() && where[b].bytes != 0;
+            FILE* f = known ? (inSwap[b] ? swap : source) : nullptr;
+            out.chunk.reset(new LevelChunk());
+            out.status = f ? readChunkBlob(f, where[b], *out.chunk) : LEVEL_OPEN_FAILED;
+        }
+        else if (job.kind == JOB_WRITEBACK) {
+            // append to the swap file; a failed write hands the chunk back so nothing is lost
+            if (b >= (int)where.size()) { where.resize(b + 1, ChunkEntry()); inSwap.resize(b + 1, 0); }
+            if (!swap) swap = tmpfile();
+            ChunkEntry e; e.band = b; e.entities = (uint32_t)job.chunk->entityCount(); e.bytes = 0;
+            bool ok = swap && fseek(swap, 0, SEEK_END) == 0;
+            if (ok) {
+#ifdef _WIN32
+                e.offset = (uint64_t)_ftelli64(swap);
+#else
+                e.offset = (uint64_t)ftello(swap);
+#endif
+                ok = e.offset % 64 == 0 && writeChunkBlob(swap, *job.chunk, e.bytes) == LEVEL_OK && fflush(swap) == 0;
+            }
+            if (ok) { where[b] = e; inSwap[b] = 1; }
+            else { where[b].bytes = 0; out.status = LEVEL_WRITE_FAILED; out.chunk = std::move(job.chunk); }
+        }
+        job.chunk.reset(); // JOB_RETIRE: freeing a big chunk is the whole job
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job.kind == JOB_LOAD || out.status != LEVEL_OK) finished.push_back(std::move(out));
+        busy = false;
+        if (jobs.empty()) idle.notify_all();
+    }
+}
+
+void ChunkStreamer::push(JobKind kind, int band, std::unique_ptr<LevelChunk> chunk) {
+    { std::lock_guard<std::mutex> lock(mutex); Job j; j.kind = kind; j.band = band; j.chunk = std::move(chunk); jobs.push_back(std::move(j)); }
+    wake.notify_one();
+}
+
+void ChunkStreamer::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [&] { return jobs.empty() && !busy; });
+}
+
+// =====================
+// Main thread
+// =====================
+
+void ChunkStreamer::reset() {
+    finished.clear();
+    if (source) { fclose(source); source = nullptr; }
+    sourcePath.clear();
+    where.clear(); inSwap.clear(); // the swap file is append-only; stale blobs in it are simply never read
+    state.clear(); hasCopy.clear(); resident.clear();
+    counters.residentBytes = 0; counters.residentChunks = 0;
+}
+
+void ChunkStreamer::growBands(int band) {
+    if (band >= (int)state.size()) { state.resize(band + 1, BAND_EMPTY); hasCopy.resize(band + 1, 0); }
+}
+
+LevelStatus ChunkStreamer::open(GameState& s, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return LEVEL_OPEN_FAILED;
+    LevelIndex index;
+    LevelStatus st = readLevelIndex(f, index);
+    if (st != LEVEL_OK) { fclose(f); return st; }
+    waitIdle();
+    if (index.version < 2) {
+        fclose(f);
+        if ((st = loadLevel(s, path)) != LEVEL_OK) return st;
+        reset();
+        // everything is resident; the budget applies from the next update, evicting to the swap file
+        for (int b = 0;b < s.chunks.bandCount();++b) if (s.chunks.at(b)) { growBands(b); state[b] = BAND_RESIDENT; resident.push_back(b); }
+        return LEVEL_OK;
+    }
+    reset();
+    source = f; sourcePath = path;
+    clearLevel(s);
+    s.worldTop = index.worldTop;
+    s.chunks.noteReach(index.obstacleReach);
+    for (const ChunkEntry& e : index.chunks) {
+        growBands(e.band);
+        if (e.band >= (int)where.size()) { where.resize(e.band + 1, ChunkEntry()); inSwap.resize(e.band + 1, 0); }
+        where[e.band] = e; state[e.band] = BAND_ON_DISK; hasCopy[e.band] = 1;
+        s.chunks.setPending(e.band, true);
+    }
+    s.motion = std::move(index.motion);
+    setTargetPath(s, index.targetBezier.data());
+    resetToEditing(s);
+    return LEVEL_OK;
+}
+
+LevelStatus ChunkStreamer::save(GameState& s, const char* path) {
+    waitIdle();
+    finished.clear(); // loads still to be installed are read again if the bands are still wanted
+    for (size_t b = 0;b < state.size();++b) if (state[b] == BAND_LOADING) state[b] = BAND_ON_DISK;
+    LevelWriter w;
+    LevelStatus st = w.open(path);
+    int bands = std::max(s.chunks.bandCount(), (int)where.size());
+    for (int b = 0;st == LEVEL_OK && b < bands;++b) {
+        if (const LevelChunk* ch = s.chunks.at(b)) { st = w.addChunk(*ch); continue; }
+        if (b >= (int)where.size() || where[b].bytes == 0) continue;
+        LevelChunk stored;
+        FILE* f = inSwap[b] ? swap : source;
+        st = f ? readChunkBlob(f, where[b], stored) : LEVEL_OPEN_FAILED;
+        if (st == LEVEL_OK) st = w.addChunk(stored);
+    }
+    if (st != LEVEL_OK) return st;
+    // the new file replaces the source (Windows cannot rename over an open file)
+    if (source) { fclose(source); source = nullptr; }
+    st = w.finish(s.targetBezier, s.worldTop, s.chunks.obstacleReach(), s.motion);
+    if (st != LEVEL_OK) {
+        if (!sourcePath.empty()) source = fopen(sourcePath.c_str(), "rb");
+        return st;
+    }
+    // from now on every band streams from the new file
+    source = fopen(path, "rb"); sourcePath = path;
+    where.assign(where.size(), ChunkEntry()); inSwap.assign(inSwap.size(), 0);
+    std::fill(hasCopy.begin(), hasCopy.end(), 0);
+    for (const ChunkEntry& e : w.directory()) {
+        growBands(e.band);
+        if (e.band >= (int)where.size()) { where.resize(e.band + 1, ChunkEntry()); inSwap.resize(e.band + 1, 0); }
+        where[e.band] = e; hasCopy[e.band] = 1;
+    }
+    s.chunks.forEachResident([](LevelChunk& ch) { ch.dirty = false; });
+    return source ? LEVEL_OK : LEVEL_OPEN_FAILED;
+}
+
+void ChunkStreamer::evict(GameState& s, int band) {
+    std::unique_ptr<LevelChunk> ch = s.chunks.release(band);
+    s.chunks.setPending(band, true);
+    state[band] = BAND_ON_DISK;
+    ++counters.evictions;
+    if (ch->dirty || !hasCopy[band]) { ++counters.writebacks; hasCopy[band] = 1; push(JOB_WRITEBACK, band, std::move(ch)); }
+    else push(JOB_RETIRE, band, std::move(ch));
+}
+
+void ChunkStreamer::update(GameState& s, float focusY) {
+    auto start = std::chrono::steady_clock::now();
+    // the game cleared the level (restart after game over): the streamed one is gone
+    if (!state.empty() && s.chunks.bandCount() == 0) { waitIdle(); reset(); }
+
+    std::vector<Result> arrived;
+    { std::lock_guard<std::mutex> lock(mutex); arrived.swap(finished); }
+    for (Result& r : arrived) {
+        int b = r.band;
+        if (r.status == LEVEL_WRITE_FAILED) { // back into the table, still unsaved
+            ++counters.failures;
+            r.chunk->dirty = true; hasCopy[b] = 0;
+            if (state[b] != BAND_RESIDENT) resident.push_back(b);
+            state[b] = BAND_RESIDENT; s.chunks.install(std::move(r.chunk));
+            continue;
+        }
+        if (b >= (int)state.size() || state[b] != BAND_LOADING) continue; // superseded; the chunk frees here
+        // the prefetch margin below was worked out from the level's reach; a chunk reaching further is damaged
+        if (r.status == LEVEL_OK && r.chunk->obstacleReach > s.chunks.obstacleReach()) r.status = LEVEL_CORRUPT;
+        if (r.status != LEVEL_OK) { // unreadable: treat the band as empty rather than hold the rocket forever
+            ++counters.failures;
+            state[b] = BAND_EMPTY; s.chunks.setPending(b, false);
+            continue;
+        }
+        ++counters.loads;
+        state[b] = BAND_RESIDENT; resident.push_back(b);
+        s.chunks.install(std::move(r.chunk));
+    }
+
+    // wanted: everything a query or the view can touch from the camera, plus a prefetch margin
+    const float reach = std::max(s.chunks.obstacleReach(), 0.1f) + STREAM_PREFETCH + 1.0f;
+    const int lo = chunkBand(focusY - reach), hi = chunkBand(focusY + reach), focus = chunkBand(focusY);
+    growBands(std::max(hi, s.chunks.bandCount() - 1));
+    for (int d = 0;focus - d >= lo || focus + d <= hi;++d) { // nearest first
+        const int pair[2] = { focus - d, focus + d };
+        for (int k = 0;k < (d ? 2 : 1);++k) {
+            int b = pair[k];
+            if (b < lo || b > hi) continue;
+            if (s.chunks.at(b) && state[b] != BAND_RESIDENT) { state[b] = BAND_RESIDENT; resident.push_back(b); } // created by an edit
+            else if (state[b] == BAND_ON_DISK) { state[b] = BAND_LOADING; push(JOB_LOAD, b, nullptr); }
+        }
+    }
+
+    // over budget: evict the resident bands farthest from the camera, never the wanted ones
+    size_t bytes = 0;
+    for (int b : resident) if (const LevelChunk* ch = s.chunks.at(b)) bytes += ch->memoryBytes();
+    if (bytes > counters.budgetBytes) {
+        std::sort(resident.begin(), resident.end(), [&](int a, int b) { return std::abs(a - focus) > std::abs(b - focus); });
+        size_t kept = 0;
+        for (size_t i = 0;i < resident.size();++i) {
+            int b = resident[i];
+            if (bytes > counters.budgetBytes && (b < lo || b > hi) && s.chunks.at(b)) { bytes -= s.chunks.at(b)->memoryBytes(); evict(s, b); }
+            else resident[kept++] = b;
+        }
+        resident.resize(kept);
+    }
+    counters.residentBytes = bytes; counters.peakBytes = std::max(counters.peakBytes, bytes);
+    counters.residentChunks = (int)resident.size();
+    counters.lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    counters.worstUpdateMs = std::max(counters.worstUpdateMs, counters.lastUpdateMs);
+}
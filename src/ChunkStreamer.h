@@ -0,0 +1,89 @@
+#pragma once
+
+// =====================
+// Out-of-core levels. A ChunkStreamer keeps only the chunks near the camera resident in a GameState's
+// ChunkTable and pages the rest in and out of the level file on a background I/O thread, within a memory
+// budget. update() runs once per frame on the main thread and never touches the disk: it installs chunks
+// the I/O thread has finished reading (a pointer move), queues reads for the bands coming into view, and
+// hands chunks it evicts to the I/O thread, which writes edited ones to a swap file and frees them. Bands
+// that are not resident yet are marked pending in the table; the simulation refuses to move or place
+// objects into them (see bandsPending()), so a slow disk shows up as a held rocket, never a stalled frame.
+// =====================
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameCore.h"
+#include "LevelFile.h"
+
+const float STREAM_PREFETCH = 2.0f; // world units beyond the view (and obstacle reach) kept resident
+
+struct StreamStats {
+    size_t budgetBytes = 0;
+    size_t residentBytes = 0, peakBytes = 0;
+    int residentChunks = 0;
+    int loads = 0, evictions = 0, writebacks = 0, failures = 0;
+    double lastUpdateMs = 0.0, worstUpdateMs = 0.0;
+};
+
+class ChunkStreamer {
+public:
+    explicit ChunkStreamer(size_t budgetBytes);
+    ~ChunkStreamer(); // waits for queued I/O and deletes the swap file
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // replaces s's level with the file's; only its index is read now, the chunks follow through update().
+    // A version 1 file has no chunk directory and is loaded whole.
+    LevelStatus open(GameState& s, const char* path);
+    // writes the whole level, reading non-resident chunks back from disk; waits for queued I/O first
+    LevelStatus save(GameState& s, const char* path);
+
+    // per frame: focusY is the world y at the centre of the view (GameState::cameraY)
+    void update(GameState& s, float focusY);
+    // blocks until the I/O thread has nothing queued (tools and benchmarks; the game never needs to)
+    void waitIdle();
+
+    const StreamStats& stats() const { return counters; }
+
+private:
+    enum BandState : uint8_t { BAND_EMPTY = 0, BAND_ON_DISK, BAND_LOADING, BAND_RESIDENT };
+    enum JobKind { JOB_LOAD, JOB_WRITEBACK, JOB_RETIRE };
+    struct Job { JobKind kind; int band; std::unique_ptr<LevelChunk> chunk; };
+    struct Result { int band; LevelStatus status; std::unique_ptr<LevelChunk> chunk; };
+
+    void run();
+    void push(JobKind kind, int band, std::unique_ptr<LevelChunk> chunk);
+    void reset(); // forgets the level; the I/O thread must be idle
+    void growBands(int band);
+    void evict(GameState& s, int band);
+
+    // main thread
+    std::vector<uint8_t> state;   // BandState per band
+    std::vector<uint8_t> hasCopy; // the band's current contents are on disk (else eviction writes it back)
+    std::vector<int> resident;    // bands the streamer counts against the budget
+    StreamStats counters;
+
+    // I/O thread, or the main thread while the I/O thread is idle
+    FILE* source = nullptr; // the open level file
+    FILE* swap = nullptr;   // evicted edits, created on first use
+    std::string sourcePath;
+    std::vector<ChunkEntry> where; // per band; bytes == 0 when it has no blob
+    std::vector<uint8_t> inSwap;   // where[] points into the swap file
+
+    // shared, under mutex
+    std::mutex mutex;
+    std::condition_variable wake, idle;
+    std::deque<Job> jobs;
+    std::vector<Result> finished;
+    bool busy = false, quit = false;
+
+    std::thread worker; // last, so everything above exists before it starts
+};
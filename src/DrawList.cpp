@@ -0,0 +1,178 @@
+#define _USE_MATH_DEFINES
+
+#include "DrawList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static uint8_t toByte(float v) { return (uint8_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); }
+
+void DrawList::clear() {
+    for (auto& b : batches) b.verts.clear();
+    order.clear(); scratch.clear(); textItems.clear(); chars.clear();
+    for (auto& g : glyphVerts) g.clear();
+    scratchArena.reset();
+    stars = StarfieldPass();
+    xf = Transform(); xfDepth = 0;
+    curLayer = 0; curPointSize = 1.0f;
+    cr = cg = cb = ca = 255;
+}
+
+void DrawList::color(float r, float g, float b, float a) { cr = toByte(r); cg = toByte(g); cb = toByte(b); ca = toByte(a); }
+
+void DrawList::pushTransform(float tx, float ty, float angleDeg) {
+    if (xfDepth < 4) xfStack[xfDepth++] = xf;
+    // compose: new local frame = parent * translate * rotate
+    float a = angleDeg * (float)M_PI / 180.0f; float c = cosf(a), s = sinf(a);
+    Transform n;
+    n.tx = xf.tx + xf.c * tx - xf.s * ty;
+    n.ty = xf.ty + xf.s * tx + xf.c * ty;
+    n.c = xf.c * c - xf.s * s;
+    n.s = xf.s * c + xf.c * s;
+    xf = n;
+}
+
+void DrawList::popTransform() { if (xfDepth > 0) xf = xfStack[--xfDepth]; }
+
+DrawBatch& DrawList::batchFor(BatchPrim prim) { return batchFor(curLayer, prim, prim == BATCH_POINTS ? curPointSize : 1.0f); }
+
+DrawBatch& DrawList::batchFor(int layer, BatchPrim prim, float size) {
+    if (lastBatch >= 0) {
+        DrawBatch& b = batches[lastBatch];
+        if (b.layer == layer && b.prim == prim && b.pointSize == size) return b;
+    }
+    for (size_t i = 0;i < batches.size();++i) {
+        DrawBatch& b = batches[i];
+        if (b.layer == layer && b.prim == prim && b.pointSize == size) { lastBatch = (int)i; return b; }
+    }
+    DrawBatch b; b.layer = layer; b.prim = prim; b.pointSize = size;
+    batches.push_back(b);
+    lastBatch = (int)batches.size() - 1;
+    return batches.back();
+}
+
+void DrawList::begin(PrimType prim) { curPrim = prim; scratch.clear(); }
+
+void DrawList::vertex(float x, float y) {
+    DrawVertex v;
+    v.x = xf.tx + xf.c * x - xf.s * y;
+    v.y = xf.ty + xf.s * x + xf.c * y;
+    v.r = cr; v.g = cg; v.b = cb; v.a = ca;
+    scratch.push_back(v);
+}
+
+void DrawList::end() {
+    const size_t n = scratch.size();
+    const DrawVertex* v = scratch.data();
+    switch (curPrim) {
+    case PRIM_POINTS: {
+        auto& out = batchFor(BATCH_POINTS).verts; out.insert(out.end(), v, v + n); break;
+    }
+    case PRIM_LINES: {
+        auto& out = batchFor(BATCH_LINES).verts; out.insert(out.end(), v, v + (n & ~size_t(1))); break;
+    }
+    case PRIM_LINE_STRIP:
+    case PRIM_LINE_LOOP: {
+        if (n < 2) break;
+        auto& out = batchFor(BATCH_LINES).verts;
+        for (size_t i = 0;i + 1 < n;++i) { out.push_back(v[i]); out.push_back(v[i + 1]); }
+        if (curPrim == PRIM_LINE_LOOP && n > 2) { out.push_back(v[n - 1]); out.push_back(v[0]); }
+        break;
+    }
+    case PRIM_TRIANGLES: {
+        auto& out = batchFor(BATCH_TRIANGLES).verts; out.insert(out.end(), v, v + (n - n % 3)); break;
+    }
+    case PRIM_TRIANGLE_STRIP: {
+        if (n < 3) break;
+        auto& out = batchFor(BATCH_TRIANGLES).verts;
+        // keep a consistent winding: odd triangles swap their first two vertices
+        for (size_t i = 0;i + 2 < n;++i) {
+            if (i & 1) { out.push_back(v[i + 1]); out.push_back(v[i]); }
+            else { out.push_back(v[i]); out.push_back(v[i + 1]); }
+            out.push_back(v[i + 2]);
+        }
+        break;
+    }
+    case PRIM_TRIANGLE_FAN:
+    case PRIM_POLYGON: {
+        if (n < 3) break;
+        auto& out = batchFor(BATCH_TRIANGLES).verts;
+        for (size_t i = 1;i + 1 < n;++i) { out.push_back(v[0]); out.push_back(v[i]); out.push_back(v[i + 1]); }
+        break;
+    }
+    case PRIM_QUADS: {
+        auto& out = batchFor(BATCH_TRIANGLES).verts;
+        for (size_t i = 0;i + 3 < n;i += 4) {
+            out.push_back(v[i]); out.push_back(v[i + 1]); out.push_back(v[i + 2]);
+            out.push_back(v[i]); out.push_back(v[i + 2]); out.push_back(v[i + 3]);
+        }
+        break;
+    }
+    }
+    scratch.clear();
+}
+
+void DrawList::reservePoints(size_t n) {
+    auto& out = batchFor(BATCH_POINTS).verts;
+    // doubling: resize() alone grows a cleared batch to the exact size, so a count that rises frame by frame would reallocate every frame
+    if (out.size() + n > out.capacity()) out.reserve(std::max(out.size() + n, 2 * out.capacity()));
+}
+
+void DrawList::points(const float* xs, const float* ys, const uint32_t* rgba, size_t n) {
+    auto& out = batchFor(BATCH_POINTS).verts;
+    reservePoints(n);
+    size_t at = out.size();
+    out.resize(at + n);
+    DrawVertex* v = out.data() + at;
+    for (size_t i = 0;i < n;++i) {
+        v[i].x = xf.tx + xf.c * xs[i] - xf.s * ys[i];
+        v[i].y = xf.ty + xf.s * xs[i] + xf.c * ys[i];
+        memcpy(&v[i].r, &rgba[i], 4);
+    }
+}
+
+void DrawList::text(float x, float y, const char* str) {
+    DrawText t;
+    t.layer = curLayer; t.x = x; t.y = y; t.r = cr; t.g = cg; t.b = cb; t.a = ca;
+    t.first = (uint32_t)chars.size(); t.count = (uint32_t)strlen(str);
+    chars.insert(chars.end(), str, str + t.count);
+    textItems.push_back(t);
+}
+
+void DrawList::inheritState(const DrawList& from) {
+    xf = from.xf; xfDepth = 0;
+    curLayer = from.curLayer; curPointSize = from.curPointSize;
+    cr = from.cr; cg = from.cg; cb = from.cb; ca = from.ca;
+}
+
+void DrawList::append(const DrawList& part) {
+    // one batch per key in either list, so appending batch by batch keeps every batch's vertex order
+    for (const DrawBatch& pb : part.batches) {
+        if (pb.verts.empty()) continue;
+        std::vector<DrawVertex>& out = batchFor(pb.layer, pb.prim, pb.pointSize).verts;
+        out.insert(out.end(), pb.verts.begin(), pb.verts.end());
+    }
+    const uint32_t base = (uint32_t)chars.size();
+    for (DrawText t : part.textItems) { t.first += base; textItems.push_back(t); }
+    chars.insert(chars.end(), part.chars.begin(), part.chars.end());
+    cr = part.cr; cg = part.cg; cb = part.cb; ca = part.ca;
+}
+
+const std::vector<const DrawBatch*>& DrawList::sortedBatches() {
+    order.clear();
+    order.reserve(batches.size()); // room for every known batch, so one that is empty most frames costs nothing when it fills
+    for (auto& b : batches) if (!b.verts.empty()) order.push_back(&b);
+    std::sort(order.begin(), order.end(), [](const DrawBatch* a, const DrawBatch* b) {
+        if (a->layer != b->layer) return a->layer < b->layer;
+        if (a->prim != b->prim) return a->prim < b->prim;
+        return a->pointSize < b->pointSize;
+    });
+    return order;
+}
+
+size_t DrawList::vertexCount() const {
+    size_t n = 0;
+    for (auto& b : batches) n += b.verts.size();
+    return n;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+// =====================
+// Retained per-frame draw list. Scene code issues immediate-mode style begin()/vertex()/end() calls;
+// every primitive is converted on end() into triangle, line or point lists with per-vertex colour and
+// appended to a batch keyed by (layer, primitive, point size). A renderer then submits one draw per batch.
+// No GL calls in here, so draw lists can be built and measured headless.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameArena.h"
+
+// source primitive (what the scene asks for), mirroring the GL immediate-mode modes
+enum PrimType {
+    PRIM_POINTS = 0, PRIM_LINES, PRIM_LINE_STRIP, PRIM_LINE_LOOP,
+    PRIM_TRIANGLES, PRIM_TRIANGLE_STRIP, PRIM_TRIANGLE_FAN, PRIM_QUADS, PRIM_POLYGON
+};
+
+// batch primitive (what gets submitted); the order is the in-layer draw order
+enum BatchPrim { BATCH_TRIANGLES = 0, BATCH_LINES, BATCH_POINTS };
+
+// painter's order between parts of the frame (the world scrolls under the UI panels)
+enum DrawLayer { LAYER_BACKGROUND = 0, LAYER_WORLD, LAYER_PLAYER, LAYER_PANELS, LAYER_OVERLAY, LAYER_COUNT };
+
+struct DrawVertex { float x, y; uint8_t r, g, b, a; };
+
+struct DrawBatch {
+    int layer = 0;
+    BatchPrim prim = BATCH_TRIANGLES;
+    float pointSize = 1.0f;
+    std::vector<DrawVertex> verts;
+};
+
+// text queued for the text renderer: characters live in DrawList::textChars
+struct DrawText { int layer; float x, y; uint8_t r, g, b, a; uint32_t first, count; };
+
+// textured glyph-quad vertex (see GlyphAtlas::layoutText)
+struct TextVertex { float x, y, u, v; uint8_t r, g, b, a; };
+
+// the parallax starfield (src/Starfield.h) for this frame: the renderer draws it from its own static buffer,
+// right after the background layer's batches
+struct StarfieldPass { bool on = false; float time = 0.0f, scroll = 0.0f; };
+
+class DrawList {
+public:
+    // drops last frame's geometry but keeps every buffer's capacity
+    void clear();
+
+    void setLayer(int layer) { curLayer = layer; }
+    void color(float r, float g, float b, float a = 1.0f);
+    void pointSize(float s) { curPointSize = s; }
+
+    // translate then rotate (degrees), like glTranslatef + glRotatef inside glPushMatrix/glPopMatrix
+    void pushTransform(float tx, float ty, float angleDeg = 0.0f);
+    void popTransform();
+
+    void begin(PrimType prim);
+    void vertex(float x, float y);
+    void end();
+
+    // n points at (xs[i], ys[i]) in one go, each with its own colour (rgba[i] holds the bytes r, g, b, a in
+    // memory order); they join the points batch of the current layer and point size like begin(PRIM_POINTS)
+    void points(const float* xs, const float* ys, const uint32_t* rgba, size_t n);
+    // room for n more points in that batch, so a count that varies from frame to frame settles without reallocating
+    void reservePoints(size_t n);
+
+    void text(float x, float y, const char* str);
+    // stars at time t (seconds) with the camera at world height scroll
+    void starfield(float t, float scroll) { stars.on = true; stars.time = t; stars.scroll = scroll; }
+
+    // parallel scene building: a part list starts from this list's layer, transform, colour and point size,
+    // and append() adds a part's geometry and text after this list's, leaving the part's colour current.
+    // Parts appended in order give the same batches as drawing everything into this list.
+    void inheritState(const DrawList& from);
+    void append(const DrawList& part);
+
+    // batches with geometry, sorted into submission order
+    const std::vector<const DrawBatch*>& sortedBatches();
+    const std::vector<DrawText>& texts() const { return textItems; }
+    const std::vector<char>& textChars() const { return chars; }
+    // laid-out glyph quads (two triangles each) of one layer
+    std::vector<TextVertex>& glyphVertices(int layer) { return glyphVerts[layer]; }
+    const std::vector<TextVertex>& glyphVertices(int layer) const { return glyphVerts[layer]; }
+    size_t vertexCount() const;
+    const StarfieldPass& starfieldPass() const { return stars; }
+
+    // scratch space for the frame being built (temporary point lists and the like); clear() takes it back
+    FrameArena& arena() { return scratchArena; }
+
+private:
+    struct Transform { float tx = 0.0f, ty = 0.0f, c = 1.0f, s = 0.0f; };
+
+    DrawBatch& batchFor(BatchPrim prim);
+    DrawBatch& batchFor(int layer, BatchPrim prim, float size);
+
+    std::vector<DrawBatch> batches; // never shrinks, so vertex storage is reused frame to frame
+    std::vector<const DrawBatch*> order;
+    std::vector<DrawVertex> scratch; // vertices of the primitive being built
+    std::vector<DrawText> textItems;
+    std::vector<char> chars;
+    std::vector<TextVertex> glyphVerts[LAYER_COUNT];
+    FrameArena scratchArena;
+    StarfieldPass stars;
+
+    Transform xf;
+    Transform xfStack[4];
+    int xfDepth = 0;
+    int curLayer = 0;
+    float curPointSize = 1.0f;
+    uint8_t cr = 255, cg = 255, cb = 255, ca = 255;
+    PrimType curPrim = PRIM_POINTS;
+    int lastBatch = -1;
+};
@@ -0,0 +1,245 @@
+#include "EntityKernels.h"
+
+#include <cmath>
+
+#ifdef SPACE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// active bits of entities [i, i+4) as a 4-bit lane mask (i is a multiple of 4, so they share a word)
+static inline int activeLanes(const uint64_t* active, size_t i) {
+    return active ? (int)((active[i >> 6] >> (i & 63)) & 0xF) : 0xF;
+}
+
+static inline int lowestLane(int mask) {
+    int lane = 0;
+    while (!(mask & 1)) { mask >>= 1; ++lane; }
+    return lane;
+}
+
+// =====================
+// Scalar reference
+// =====================
+
+void advancePhasesScalar(float* phase, size_t n, float delta) {
+    for (size_t i = 0;i < n;++i) phase[i] += delta;
+}
+
+void integrateParticlesScalar(float* x, float* y, float* vx, float* vy, float* age, size_t n, float dt, float damping, float gravity) {
+    const float g = gravity * dt;
+    for (size_t i = 0;i < n;++i) {
+        float u = vx[i] * damping, v = vy[i] * damping + g;
+        vx[i] = u; vy[i] = v; x[i] += u * dt; y[i] += v * dt; age[i] += dt;
+    }
+}
+
+int firstWithinRadiusScalar(const float* x, const float* y, const uint64_t* active, size_t n, float px, float py, float r2) {
+    for (size_t i = 0;i < n;++i) {
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        float dx = x[i] - px, dy = y[i] - py;
+        if (dx * dx + dy * dy < r2) return (int)i;
+    }
+    return -1;
+}
+
+int firstAabbHitScalar(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, float px, float py, float margin) {
+    for (size_t i = 0;i < n;++i) {
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (fabsf(px - x[i]) < w[i] + margin && fabsf(py - y[i]) < h[i] + margin) return (int)i;
+    }
+    return -1;
+}
+
+int earliestSweptAabbHitScalar(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, const Sweep& s, float margin, float& t) {
+    int best = -1; float bt = 0.0f, ti;
+    for (size_t i = 0;i < n;++i) {
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (sweepAabb(s, x[i], y[i], w[i] + margin, h[i] + margin, ti) && (best < 0 || ti < bt)) { best = (int)i; bt = ti; }
+    }
+    if (best >= 0) t = bt;
+    return best;
+}
+
+int earliestSweptCircleHitScalar(const float* x, const float* y, const uint64_t* active, size_t n, const Sweep& s, float r2, float& t) {
+    int best = -1; float bt = 0.0f, ti;
+    for (size_t i = 0;i < n;++i) {
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (sweepCircle(s, x[i], y[i], r2, ti) && (best < 0 || ti < bt)) { best = (int)i; bt = ti; }
+    }
+    if (best >= 0) t = bt;
+    return best;
+}
+
+// =====================
+// SSE2: four entities per step, scalar tail
+// =====================
+#ifdef SPACE_SIMD_SSE2
+
+const char* entityKernelIsa() { return "sse2"; }
+
+void advancePhases(float* phase, size_t n, float delta) {
+    const __m128 d = _mm_set1_ps(delta);
+    size_t i = 0;
+    // four vectors per iteration: a single dependent load/add/store chain leaves the adders idle
+    for (;i + 16 <= n;i += 16) {
+        __m128 a = _mm_loadu_ps(phase + i), b = _mm_loadu_ps(phase + i + 4), c = _mm_loadu_ps(phase + i + 8), e = _mm_loadu_ps(phase + i + 12);
+        _mm_storeu_ps(phase + i, _mm_add_ps(a, d)); _mm_storeu_ps(phase + i + 4, _mm_add_ps(b, d));
+        _mm_storeu_ps(phase + i + 8, _mm_add_ps(c, d)); _mm_storeu_ps(phase + i + 12, _mm_add_ps(e, d));
+    }
+    for (;i + 4 <= n;i += 4) _mm_storeu_ps(phase + i, _mm_add_ps(_mm_loadu_ps(phase + i), d));
+    advancePhasesScalar(phase + i, n - i, delta);
+}
+
+void integrateParticles(float* x, float* y, float* vx, float* vy, float* age, size_t n, float dt, float damping, float gravity) {
+    const __m128 d = _mm_set1_ps(dt), k = _mm_set1_ps(damping), g = _mm_set1_ps(gravity * dt);
+    size_t i = 0;
+    for (;i + 4 <= n;i += 4) {
+        __m128 u = _mm_mul_ps(_mm_loadu_ps(vx + i), k), v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), k), g);
+        _mm_storeu_ps(vx + i, u); _mm_storeu_ps(vy + i, v);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(u, d)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(v, d)));
+        _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), d));
+    }
+    integrateParticlesScalar(x + i, y + i, vx + i, vy + i, age + i, n - i, dt, damping, gravity);
+}
+
+int firstWithinRadius(const float* x, const float* y, const uint64_t* active, size_t n, float px, float py, float r2) {
+    const __m128 qx = _mm_set1_ps(px), qy = _mm_set1_ps(py), rr = _mm_set1_ps(r2);
+    size_t i = 0;
+    for (;i + 4 <= n;i += 4) {
+        int lanes = activeLanes(active, i);
+        if (!lanes) continue;
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), qx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), qy);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int hit = _mm_movemask_ps(_mm_cmplt_ps(d2, rr)) & lanes;
+        if (hit) return (int)i + lowestLane(hit);
+    }
+    for (;i < n;++i) {
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        float dx = x[i] - px, dy = y[i] - py;
+        if (dx * dx + dy * dy < r2) return (int)i;
+    }
+    return -1;
+}
+
+int firstAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, float px, float py, float margin) {
+    const __m128 qx = _mm_set1_ps(px), qy = _mm_set1_ps(py), m = _mm_set1_ps(margin);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    size_t i = 0;
+    for (;i + 4 <= n;i += 4) {
+        int lanes = activeLanes(active, i);
+        if (!lanes) continue;
+        __m128 ax = _mm_and_ps(_mm_sub_ps(qx, _mm_loadu_ps(x + i)), absMask);
+        __m128 ay = _mm_and_ps(_mm_sub_ps(qy, _mm_loadu_ps(y + i)), absMask);
+        __m128 inX = _mm_cmplt_ps(ax, _mm_add_ps(_mm_loadu_ps(w + i), m));
+        __m128 inY = _mm_cmplt_ps(ay, _mm_add_ps(_mm_loadu_ps(h + i), m));
+        int hit = _mm_movemask_ps(_mm_and_ps(inX, inY)) & lanes;
+        if (hit) return (int)i + lowestLane(hit);
+    }
+    for (;i < n;++i) { // in place: the active bits of the tail do not start a word
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (fabsf(px - x[i]) < w[i] + margin && fabsf(py - y[i]) < h[i] + margin) return (int)i;
+    }
+    return -1;
+}
+
+// hits are rare, so the lanes that hit are merged one by one: earliest t, then lowest index
+static inline void mergeLanes(int hit, __m128 tv, size_t i, int& best, float& bt) {
+    float ts[4]; _mm_storeu_ps(ts, tv);
+    for (int k = 0;k < 4;++k) if ((hit >> k & 1) && (best < 0 || ts[k] < bt)) { best = (int)i + k; bt = ts[k]; }
+}
+
+int earliestSweptAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, const Sweep& s, float margin, float& t) {
+    const __m128 ax = _mm_set1_ps(s.ax), ay = _mm_set1_ps(s.ay), ix = _mm_set1_ps(s.invDx), iy = _mm_set1_ps(s.invDy), m = _mm_set1_ps(margin);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 negInf = _mm_set1_ps(-INFINITY), posInf = _mm_set1_ps(INFINITY);
+    int best = -1; float bt = 0.0f;
+    size_t i = 0;
+    for (;i + 4 <= n;i += 4) {
+        int lanes = activeLanes(active, i);
+        if (!lanes) continue;
+        __m128 cx = _mm_loadu_ps(x + i), cy = _mm_loadu_ps(y + i);
+        __m128 hw = _mm_add_ps(_mm_loadu_ps(w + i), m), hh = _mm_add_ps(_mm_loadu_ps(h + i), m);
+        __m128 lo = negInf, hi = posInf, ok = _mm_cmpeq_ps(zero, zero);
+        // an axis the segment does not move along is a plain overlap test
+        if (s.dx != 0.0f) {
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(cx, hw), ax), ix), t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(cx, hw), ax), ix);
+            lo = _mm_min_ps(t1, t2); hi = _mm_max_ps(t1, t2);
+        }
+        else ok = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(ax, cx), absMask), hw);
+        if (s.dy != 0.0f) {
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(cy, hh), ay), iy), t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(cy, hh), ay), iy);
+            lo = _mm_max_ps(lo, _mm_min_ps(t1, t2)); hi = _mm_min_ps(hi, _mm_max_ps(t1, t2));
+        }
+        else ok = _mm_and_ps(ok, _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(ay, cy), absMask), hh));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmplt_ps(lo, hi), _mm_cmpgt_ps(hi, zero)));
+        __m128 inside = _mm_cmplt_ps(lo, zero);
+        __m128 hitv = _mm_and_ps(ok, _mm_or_ps(_mm_and_ps(inside, _mm_cmpgt_ps(hi, one)), _mm_andnot_ps(inside, _mm_cmplt_ps(lo, one))));
+        int hit = _mm_movemask_ps(hitv) & lanes;
+        if (hit) mergeLanes(hit, _mm_andnot_ps(inside, lo), i, best, bt);
+    }
+    for (;i < n;++i) { // in place: the active bits of the tail do not start a word
+        float ti;
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (sweepAabb(s, x[i], y[i], w[i] + margin, h[i] + margin, ti) && (best < 0 || ti < bt)) { best = (int)i; bt = ti; }
+    }
+    if (best >= 0) t = bt;
+    return best;
+}
+
+int earliestSweptCircleHit(const float* x, const float* y, const uint64_t* active, size_t n, const Sweep& s, float r2, float& t) {
+    const __m128 ax = _mm_set1_ps(s.ax), ay = _mm_set1_ps(s.ay), dx = _mm_set1_ps(s.dx), dy = _mm_set1_ps(s.dy), rr = _mm_set1_ps(r2);
+    const __m128 a = _mm_set1_ps(s.dx * s.dx + s.dy * s.dy), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    int best = -1; float bt = 0.0f;
+    size_t i = 0;
+    for (;i + 4 <= n;i += 4) {
+        int lanes = activeLanes(active, i);
+        if (!lanes) continue;
+        __m128 mx = _mm_sub_ps(ax, _mm_loadu_ps(x + i)), my = _mm_sub_ps(ay, _mm_loadu_ps(y + i));
+        __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), rr);
+        __m128 b = _mm_add_ps(_mm_mul_ps(mx, dx), _mm_mul_ps(my, dy));
+        __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+        // lanes that miss may take the square root of a negative number; their NaNs are masked off below
+        __m128 te = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(disc)), a);
+        __m128 inside = _mm_cmplt_ps(c, zero);
+        __m128 enters = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(b, zero), _mm_cmpgt_ps(disc, zero)), _mm_cmplt_ps(te, one));
+        int hit = _mm_movemask_ps(_mm_or_ps(inside, enters)) & lanes;
+        if (hit) mergeLanes(hit, _mm_andnot_ps(inside, te), i, best, bt);
+    }
+    for (;i < n;++i) { // in place: the active bits of the tail do not start a word
+        float ti;
+        if (active && !((active[i >> 6] >> (i & 63)) & 1u)) continue;
+        if (sweepCircle(s, x[i], y[i], r2, ti) && (best < 0 || ti < bt)) { best = (int)i; bt = ti; }
+    }
+    if (best >= 0) t = bt;
+    return best;
+}
+
+#else
+
+const char* entityKernelIsa() { return "scalar"; }
+
+void advancePhases(float* phase, size_t n, float delta) { advancePhasesScalar(phase, n, delta); }
+
+void integrateParticles(float* x, float* y, float* vx, float* vy, float* age, size_t n, float dt, float damping, float gravity) {
+    integrateParticlesScalar(x, y, vx, vy, age, n, dt, damping, gravity);
+}
+
+int firstWithinRadius(const float* x, const float* y, const uint64_t* active, size_t n, float px, float py, float r2) {
+    return firstWithinRadiusScalar(x, y, active, n, px, py, r2);
+}
+
+int firstAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, float px, float py, float margin) {
+    return firstAabbHitScalar(x, y, w, h, active, n, px, py, margin);
+}
+
+int earliestSweptAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, const Sweep& s, float margin, float& t) {
+    return earliestSweptAabbHitScalar(x, y, w, h, active, n, s, margin, t);
+}
+
+int earliestSweptCircleHit(const float* x, const float* y, const uint64_t* active, size_t n, const Sweep& s, float r2, float& t) {
+    return earliestSweptCircleHitScalar(x, y, active, n, s, r2, t);
+}
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+// =====================
+// Batch kernels over the structure-of-arrays entity data: phase advance, particle integration, point hit
+// tests and swept (segment) hit tests.
+// SSE2 versions process four entities per instruction; the *Scalar versions are the portable
+// fallback (and the benchmark reference). Both return identical results: the hit tests compare
+// squared distances with the same single-precision operations and report the lowest matching index.
+// =====================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPACE_SIMD_SSE2 1
+#endif
+
+// "sse2" or "scalar": which path the unsuffixed kernels take in this build
+const char* entityKernelIsa();
+
+// phase[i] += delta for all n entries
+void advancePhases(float* phase, size_t n, float delta);
+void advancePhasesScalar(float* phase, size_t n, float delta);
+
+// one particle step of dt seconds: velocity scaled by damping, then gravity added to vy, then position
+// moved by the new velocity; age += dt. Same operations in the same order in both versions.
+void integrateParticles(float* x, float* y, float* vx, float* vy, float* age, size_t n, float dt, float damping, float gravity);
+void integrateParticlesScalar(float* x, float* y, float* vx, float* vy, float* age, size_t n, float dt, float damping, float gravity);
+
+// lowest i with (x[i]-px)^2 + (y[i]-py)^2 < r2 and, when active is non-null, its active bit set; -1 if none
+int firstWithinRadius(const float* x, const float* y, const uint64_t* active, size_t n, float px, float py, float r2);
+int firstWithinRadiusScalar(const float* x, const float* y, const uint64_t* active, size_t n, float px, float py, float r2);
+
+// lowest i with |px-x[i]| < w[i]+margin and |py-y[i]| < h[i]+margin and, when active is non-null, its active
+// bit set; -1 if none
+int firstAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, float px, float py, float margin);
+int firstAabbHitScalar(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, float px, float py, float margin);
+
+// =====================
+// Swept tests: a point moving from (ax, ay) to (bx, by) in one step, against boxes and circles. A hit is
+// reported at the parameter t in [0, 1) where the segment enters the shape, so a step of any length finds
+// what it passes through. The hit rules match the point tests at the end of the step: a segment that starts
+// inside a box only hits it if it also ends inside (a mover can always back out), and one that starts inside
+// a circle hits it at t = 0.
+// =====================
+
+struct Sweep {
+    float ax, ay, dx, dy;
+    float invDx, invDy; // 1/d, or 0 on an axis the segment does not move along
+    Sweep(float ax_, float ay_, float bx, float by) : ax(ax_), ay(ay_), dx(bx - ax_), dy(by - ay_) {
+        // a component too small to invert counts as no movement on that axis
+        invDx = dx != 0.0f ? 1.0f / dx : 0.0f; if (!(fabsf(invDx) < INFINITY)) dx = invDx = 0.0f;
+        invDy = dy != 0.0f ? 1.0f / dy : 0.0f; if (!(fabsf(invDy) < INFINITY)) dy = invDy = 0.0f;
+    }
+};
+
+// the open box |x - cx| < hw, |y - cy| < hh (the kernels below do the same operations in the same order)
+inline bool sweepAabb(const Sweep& s, float cx, float cy, float hw, float hh, float& t) {
+    float lo = -INFINITY, hi = INFINITY;
+    if (s.dx != 0.0f) { float t1 = (cx - hw - s.ax) * s.invDx, t2 = (cx + hw - s.ax) * s.invDx; lo = fminf(t1, t2); hi = fmaxf(t1, t2); }
+    else if (!(fabsf(s.ax - cx) < hw)) return false;
+    if (s.dy != 0.0f) { float t1 = (cy - hh - s.ay) * s.invDy, t2 = (cy + hh - s.ay) * s.invDy; lo = fmaxf(lo, fminf(t1, t2)); hi = fminf(hi, fmaxf(t1, t2)); }
+    else if (!(fabsf(s.ay - cy) < hh)) return false;
+    if (!(lo < hi) || !(hi > 0.0f)) return false;
+    if (lo < 0.0f) { t = 0.0f; return hi > 1.0f; } // started inside
+    t = lo;
+    return lo < 1.0f;
+}
+
+// the open disc of squared radius r2 around (cx, cy)
+inline bool sweepCircle(const Sweep& s, float cx, float cy, float r2, float& t) {
+    float mx = s.ax - cx, my = s.ay - cy;
+    float c = mx * mx + my * my - r2;
+    if (c < 0.0f) { t = 0.0f; return true; }
+    float a = s.dx * s.dx + s.dy * s.dy, b = mx * s.dx + my * s.dy;
+    if (!(b < 0.0f)) return false; // moving away (or not moving)
+    float disc = b * b - a * c;
+    if (!(disc > 0.0f)) return false;
+    t = (-b - sqrtf(disc)) / a;
+    return t < 1.0f;
+}
+
+// entity with the earliest hit along the sweep (ties go to the lowest index) and its t; -1 if none. A non-null
+// active skips the entities whose bit is clear.
+int earliestSweptAabbHit(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, const Sweep& s, float margin, float& t);
+int earliestSweptAabbHitScalar(const float* x, const float* y, const float* w, const float* h, const uint64_t* active, size_t n, const Sweep& s, float margin, float& t);
+int earliestSweptCircleHit(const float* x, const float* y, const uint64_t* active, size_t n, const Sweep& s, float r2, float& t);
+int earliestSweptCircleHitScalar(const float* x, const float* y, const uint64_t* active, size_t n, const Sweep& s, float r2, float& t);
@@ -0,0 +1,89 @@
+#pragma once
+
+// =====================
+// Structure-of-arrays entity storage. Each field of an entity kind lives in its own contiguous array
+// and "active" flags are packed 64 to a word, so per-tick loops and hit-test kernels (EntityKernels.h)
+// stream through exactly the data they use. The arrays are Columns (MappedFile.h), so a loaded level
+// can use the file's pages directly. The AoS structs below remain the value type for adding and
+// reading back single entities.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MappedFile.h"
+#include "Vec2.h"
+
+struct Collectible { Vec2 pos; bool active = true; float phase = 0.0f; };
+struct Obstacle { Vec2 pos; float w, h; }; // w, h are half extents
+
+enum PowerType { P_SHIELD = 0, P_SPEED = 1 };
+struct PowerUp { Vec2 pos; bool active = true; PowerType type = P_SHIELD; float phase = 0.0f; };
+
+// one bit per entity; bits past size() are always zero so kernels can test whole words
+class ActiveBits {
+public:
+    size_t size() const { return count; }
+    bool test(size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1u; }
+    void set(size_t i, bool on) {
+        uint64_t m = uint64_t(1) << (i & 63);
+        if (on) bits[i >> 6] |= m; else bits[i >> 6] &= ~m;
+    }
+    void push_back(bool on) { if ((count & 63) == 0) bits.push_back(0); set(count++, on); }
+    void pop_back() { set(--count, false); if ((count & 63) == 0) bits.pop_back(); }
+    void clear() { bits.clear(); count = 0; }
+    const uint64_t* words() const { return bits.data(); }
+    size_t wordCount() const { return bits.size(); }
+    // takes over (count + 63) / 64 words whose bits past count are zero
+    void adopt(Column<uint64_t> words, size_t count) { bits = std::move(words); this->count = count; }
+    void detach() { bits.detach(); }
+
+private:
+    Column<uint64_t> bits;
+    size_t count = 0;
+};
+
+struct ObstacleStore {
+    Column<float> x, y, w, h;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void push(const Obstacle& o) { x.push_back(o.pos.x); y.push_back(o.pos.y); w.push_back(o.w); h.push_back(o.h); }
+    Obstacle get(size_t i) const { Obstacle o; o.pos = Vec2(x[i], y[i]); o.w = w[i]; o.h = h[i]; return o; }
+    // swap-and-pop
+    void remove(size_t i) {
+        size_t last = size() - 1;
+        x[i] = x[last]; y[i] = y[last]; w[i] = w[last]; h[i] = h[last];
+        x.pop_back(); y.pop_back(); w.pop_back(); h.pop_back();
+    }
+    void clear() { x.clear(); y.clear(); w.clear(); h.clear(); }
+};
+
+struct CollectibleStore {
+    Column<float> x, y, phase;
+    ActiveBits active;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void push(const Collectible& c) { x.push_back(c.pos.x); y.push_back(c.pos.y); phase.push_back(c.phase); active.push_back(c.active); }
+    Collectible get(size_t i) const { Collectible c; c.pos = Vec2(x[i], y[i]); c.phase = phase[i]; c.active = active.test(i); return c; }
+    void clear() { x.clear(); y.clear(); phase.clear(); active.clear(); }
+};
+
+struct PowerupStore {
+    Column<float> x, y, phase;
+    Column<uint8_t> type; // PowerType
+    ActiveBits active;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void push(const PowerUp& p) { x.push_back(p.pos.x); y.push_back(p.pos.y); phase.push_back(p.phase); type.push_back((uint8_t)p.type); active.push_back(p.active); }
+    PowerUp get(size_t i) const { PowerUp p; p.pos = Vec2(x[i], y[i]); p.phase = phase[i]; p.type = (PowerType)type[i]; p.active = active.test(i); return p; }
+    // swap-and-pop
+    void remove(size_t i) {
+        size_t last = size() - 1;
+        x[i] = x[last]; y[i] = y[last]; phase[i] = phase[last]; type[i] = type[last]; active.set(i, active.test(last));
+        x.pop_back(); y.pop_back(); phase.pop_back(); type.pop_back(); active.pop_back();
+    }
+    void clear() { x.clear(); y.clear(); phase.clear(); type.clear(); active.clear(); }
+};
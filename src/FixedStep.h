@@ -0,0 +1,35 @@
+#pragma once
+
+// =====================
+// Fixed-timestep accumulator. The front end feeds it real elapsed time; it answers how many
+// simulation ticks of dt() are due and how far (0..1) the frame sits between the last two ticks,
+// so the simulation always advances in identical steps whatever the frame rate.
+// =====================
+
+class FixedStep {
+public:
+    explicit FixedStep(double hz = 60.0) { setRate(hz); }
+
+    void setRate(double hz) { tickDt = 1.0 / (hz > 1.0 ? hz : 1.0); }
+    double dt() const { return tickDt; }
+    double rate() const { return 1.0 / tickDt; }
+
+    // adds elapsed seconds and returns the ticks now due; after a long stall (debugger, window drag)
+    // at most maxTicks run and the rest of the backlog is dropped instead of spiralling
+    int advance(double seconds, int maxTicks = 8) {
+        accumulator += seconds > 0.0 ? seconds : 0.0;
+        int ticks = (int)(accumulator / tickDt);
+        if (ticks > maxTicks) { ticks = maxTicks; accumulator = tickDt * maxTicks; }
+        accumulator -= ticks * tickDt;
+        return ticks;
+    }
+
+    // fraction of a tick left over: 0 = exactly on the latest tick
+    float alpha() const { return (float)(accumulator / tickDt); }
+
+    void reset() { accumulator = 0.0; }
+
+private:
+    double tickDt = 1.0 / 60.0;
+    double accumulator = 0.0;
+};
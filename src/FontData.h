@@ -0,0 +1,119 @@
+#pragma once
+
+// =====================
+// Embedded bitmap font: printable ASCII from the X11 Adobe Helvetica 12 bitmap font
+// (-adobe-helvetica-medium-r-normal--12-120-75-75-p-67-iso8859-1), the same face GLUT_BITMAP_HELVETICA_12 draws.
+// Each glyph is FONT_CELL_HEIGHT rows, bottom row first; bit 15 of a row is the glyph's leftmost pixel.
+// =====================
+
+const int FONT_FIRST_CHAR = 32;
+const int FONT_CHAR_COUNT = 95;
+const int FONT_CELL_HEIGHT = 16;
+const int FONT_BASELINE = 4; // rows below the baseline (glBitmap yorig)
+
+const unsigned char FONT_ADVANCE[FONT_CHAR_COUNT] = {
+    4, 3, 5, 7, 7, 11, 9, 3, 4, 4, 5, 7, 4, 8, 3, 4,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 3, 3, 7, 7, 7, 7,
+    12, 9, 8, 9, 9, 8, 8, 9, 9, 3, 7, 8, 7, 11, 9, 10,
+    8, 10, 8, 8, 7, 8, 9, 11, 9, 9, 9, 3, 4, 3, 6, 7,
+    3, 7, 7, 7, 7, 7, 3, 7, 7, 3, 3, 6, 3, 9, 7, 7,
+    7, 7, 4, 6, 3, 7, 7, 9, 6, 7, 6, 4, 3, 4, 7,
+};
+
+const unsigned short FONT_ROWS[FONT_CHAR_COUNT][FONT_CELL_HEIGHT] = {
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // ' '
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // '!'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x5000,0x5000,0x5000,0x0000,0x0000,0x0000 }, // '"'
+    { 0x0000,0x0000,0x0000,0x0000,0x5000,0x5000,0x5000,0xfc00,0x2800,0xfc00,0x2800,0x2800,0x0000,0x0000,0x0000,0x0000 }, // '#'
+    { 0x0000,0x0000,0x0000,0x1000,0x3800,0x5400,0x5400,0x1400,0x3800,0x5000,0x5400,0x3800,0x1000,0x0000,0x0000,0x0000 }, // '$'
+    { 0x0000,0x0000,0x0000,0x0000,0x1180,0x0a40,0x0a40,0x0980,0x0400,0x3400,0x4a00,0x4a00,0x3100,0x0000,0x0000,0x0000 }, // '%'
+    { 0x0000,0x0000,0x0000,0x0000,0x3900,0x4600,0x4200,0x4500,0x2800,0x1800,0x2400,0x2400,0x1800,0x0000,0x0000,0x0000 }, // '&'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x4000,0x2000,0x6000,0x0000,0x0000,0x0000 }, // '\''
+    { 0x0000,0x1000,0x2000,0x2000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x2000,0x2000,0x1000,0x0000,0x0000,0x0000 }, // '('
+    { 0x0000,0x8000,0x4000,0x4000,0x2000,0x2000,0x2000,0x2000,0x2000,0x2000,0x4000,0x4000,0x8000,0x0000,0x0000,0x0000 }, // ')'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x5000,0x2000,0x5000,0x0000,0x0000,0x0000 }, // '*'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x1000,0x1000,0x7c00,0x1000,0x1000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '+'
+    { 0x0000,0x0000,0x4000,0x2000,0x2000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // ','
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x7c00,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '-'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '.'
+    { 0x0000,0x0000,0x0000,0x0000,0x8000,0x8000,0x4000,0x4000,0x4000,0x2000,0x2000,0x1000,0x1000,0x0000,0x0000,0x0000 }, // '/'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x4400,0x4400,0x4400,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '0'
+    { 0x0000,0x0000,0x0000,0x0000,0x1000,0x1000,0x1000,0x1000,0x1000,0x1000,0x1000,0x7000,0x1000,0x0000,0x0000,0x0000 }, // '1'
+    { 0x0000,0x0000,0x0000,0x0000,0x7c00,0x4000,0x4000,0x2000,0x1000,0x0800,0x0400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '2'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x0400,0x0400,0x1800,0x0400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '3'
+    { 0x0000,0x0000,0x0000,0x0000,0x0800,0x0800,0xfc00,0x8800,0x4800,0x2800,0x2800,0x1800,0x0800,0x0000,0x0000,0x0000 }, // '4'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x0400,0x0400,0x7800,0x4000,0x4000,0x7c00,0x0000,0x0000,0x0000 }, // '5'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x4400,0x6400,0x5800,0x4000,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '6'
+    { 0x0000,0x0000,0x0000,0x0000,0x2000,0x2000,0x1000,0x1000,0x1000,0x0800,0x0800,0x0400,0x7c00,0x0000,0x0000,0x0000 }, // '7'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x4400,0x4400,0x3800,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '8'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x0400,0x0400,0x3c00,0x4400,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '9'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x0000,0x0000,0x0000,0x0000,0x4000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // ':'
+    { 0x0000,0x0000,0x8000,0x4000,0x4000,0x0000,0x0000,0x0000,0x0000,0x4000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // ';'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0c00,0x3000,0xc000,0x3000,0x0c00,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '<'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x7c00,0x0000,0x7c00,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '='
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x6000,0x1800,0x0600,0x1800,0x6000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '>'
+    { 0x0000,0x0000,0x0000,0x0000,0x1000,0x0000,0x1000,0x1000,0x0800,0x0800,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000 }, // '?'
+    { 0x0000,0x0000,0x0000,0x1f00,0x2000,0x4d80,0x5340,0x5120,0x5120,0x4920,0x26a0,0x3040,0x0f80,0x0000,0x0000,0x0000 }, // '@'
+    { 0x0000,0x0000,0x0000,0x0000,0x4100,0x4100,0x4100,0x3e00,0x2200,0x2200,0x1400,0x1400,0x0800,0x0000,0x0000,0x0000 }, // 'A'
+    { 0x0000,0x0000,0x0000,0x0000,0x7c00,0x4200,0x4200,0x4200,0x7c00,0x4200,0x4200,0x4200,0x7c00,0x0000,0x0000,0x0000 }, // 'B'
+    { 0x0000,0x0000,0x0000,0x0000,0x1e00,0x2100,0x4000,0x4000,0x4000,0x4000,0x4000,0x2100,0x1e00,0x0000,0x0000,0x0000 }, // 'C'
+    { 0x0000,0x0000,0x0000,0x0000,0x7c00,0x4200,0x4100,0x4100,0x4100,0x4100,0x4100,0x4200,0x7c00,0x0000,0x0000,0x0000 }, // 'D'
+    { 0x0000,0x0000,0x0000,0x0000,0x7e00,0x4000,0x4000,0x4000,0x7e00,0x4000,0x4000,0x4000,0x7e00,0x0000,0x0000,0x0000 }, // 'E'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x7c00,0x4000,0x4000,0x4000,0x7e00,0x0000,0x0000,0x0000 }, // 'F'
+    { 0x0000,0x0000,0x0000,0x0000,0x1d00,0x2300,0x4100,0x4100,0x4700,0x4000,0x4000,0x2100,0x1e00,0x0000,0x0000,0x0000 }, // 'G'
+    { 0x0000,0x0000,0x0000,0x0000,0x4100,0x4100,0x4100,0x4100,0x7f00,0x4100,0x4100,0x4100,0x4100,0x0000,0x0000,0x0000 }, // 'H'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'I'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x0400,0x0400,0x0400,0x0400,0x0400,0x0400,0x0000,0x0000,0x0000 }, // 'J'
+    { 0x0000,0x0000,0x0000,0x0000,0x4100,0x4200,0x4400,0x4800,0x7000,0x5000,0x4800,0x4400,0x4200,0x0000,0x0000,0x0000 }, // 'K'
+    { 0x0000,0x0000,0x0000,0x0000,0x7c00,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'L'
+    { 0x0000,0x0000,0x0000,0x0000,0x4440,0x4440,0x4a40,0x4a40,0x5140,0x5140,0x60c0,0x60c0,0x4040,0x0000,0x0000,0x0000 }, // 'M'
+    { 0x0000,0x0000,0x0000,0x0000,0x4100,0x4300,0x4500,0x4500,0x4900,0x5100,0x5100,0x6100,0x4100,0x0000,0x0000,0x0000 }, // 'N'
+    { 0x0000,0x0000,0x0000,0x0000,0x1e00,0x2100,0x4080,0x4080,0x4080,0x4080,0x4080,0x2100,0x1e00,0x0000,0x0000,0x0000 }, // 'O'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x7c00,0x4200,0x4200,0x4200,0x7c00,0x0000,0x0000,0x0000 }, // 'P'
+    { 0x0000,0x0000,0x0000,0x0000,0x1e80,0x2100,0x4280,0x4480,0x4080,0x4080,0x4080,0x2100,0x1e00,0x0000,0x0000,0x0000 }, // 'Q'
+    { 0x0000,0x0000,0x0000,0x0000,0x4200,0x4200,0x4200,0x4400,0x7c00,0x4200,0x4200,0x4200,0x7c00,0x0000,0x0000,0x0000 }, // 'R'
+    { 0x0000,0x0000,0x0000,0x0000,0x3c00,0x4200,0x4200,0x0200,0x0c00,0x3000,0x4000,0x4200,0x3c00,0x0000,0x0000,0x0000 }, // 'S'
+    { 0x0000,0x0000,0x0000,0x0000,0x1000,0x1000,0x1000,0x1000,0x1000,0x1000,0x1000,0x1000,0xfe00,0x0000,0x0000,0x0000 }, // 'T'
+    { 0x0000,0x0000,0x0000,0x0000,0x3c00,0x4200,0x4200,0x4200,0x4200,0x4200,0x4200,0x4200,0x4200,0x0000,0x0000,0x0000 }, // 'U'
+    { 0x0000,0x0000,0x0000,0x0000,0x0800,0x0800,0x1400,0x1400,0x2200,0x2200,0x2200,0x4100,0x4100,0x0000,0x0000,0x0000 }, // 'V'
+    { 0x0000,0x0000,0x0000,0x0000,0x1100,0x1100,0x1100,0x2a80,0x2a80,0x2480,0x4440,0x4440,0x4440,0x0000,0x0000,0x0000 }, // 'W'
+    { 0x0000,0x0000,0x0000,0x0000,0x4100,0x2200,0x2200,0x1400,0x0800,0x1400,0x2200,0x2200,0x4100,0x0000,0x0000,0x0000 }, // 'X'
+    { 0x0000,0x0000,0x0000,0x0000,0x0800,0x0800,0x0800,0x0800,0x1400,0x2200,0x2200,0x4100,0x4100,0x0000,0x0000,0x0000 }, // 'Y'
+    { 0x0000,0x0000,0x0000,0x0000,0x7f00,0x4000,0x2000,0x1000,0x0800,0x0400,0x0200,0x0100,0x7f00,0x0000,0x0000,0x0000 }, // 'Z'
+    { 0x0000,0x6000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x6000,0x0000,0x0000,0x0000 }, // '['
+    { 0x0000,0x0000,0x0000,0x0000,0x1000,0x1000,0x2000,0x2000,0x2000,0x4000,0x4000,0x8000,0x8000,0x0000,0x0000,0x0000 }, // '\\'
+    { 0x0000,0xc000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0xc000,0x0000,0x0000,0x0000 }, // ']'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x8800,0x5000,0x2000,0x0000,0x0000,0x0000,0x0000 }, // '^'
+    { 0x0000,0x0000,0xfe00,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '_'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xc000,0x8000,0x4000,0x0000,0x0000,0x0000 }, // '`'
+    { 0x0000,0x0000,0x0000,0x0000,0x3a00,0x4400,0x4400,0x3c00,0x0400,0x4400,0x3800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'a'
+    { 0x0000,0x0000,0x0000,0x0000,0x5800,0x6400,0x4400,0x4400,0x4400,0x6400,0x5800,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'b'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4000,0x4000,0x4000,0x4400,0x3800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'c'
+    { 0x0000,0x0000,0x0000,0x0000,0x3400,0x4c00,0x4400,0x4400,0x4400,0x4c00,0x3400,0x0400,0x0400,0x0000,0x0000,0x0000 }, // 'd'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4000,0x7c00,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'e'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0xe000,0x4000,0x3000,0x0000,0x0000,0x0000 }, // 'f'
+    { 0x0000,0x3800,0x4400,0x0400,0x3400,0x4c00,0x4400,0x4400,0x4400,0x4c00,0x3400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'g'
+    { 0x0000,0x0000,0x0000,0x0000,0x4400,0x4400,0x4400,0x4400,0x4400,0x6400,0x5800,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'h'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x4000,0x0000,0x0000,0x0000 }, // 'i'
+    { 0x0000,0x8000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x4000,0x0000,0x0000,0x0000 }, // 'j'
+    { 0x0000,0x0000,0x0000,0x0000,0x4400,0x4800,0x5000,0x6000,0x6000,0x5000,0x4800,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'k'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 'l'
+    { 0x0000,0x0000,0x0000,0x0000,0x4900,0x4900,0x4900,0x4900,0x4900,0x6d00,0x5200,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'm'
+    { 0x0000,0x0000,0x0000,0x0000,0x4400,0x4400,0x4400,0x4400,0x4400,0x6400,0x5800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'n'
+    { 0x0000,0x0000,0x0000,0x0000,0x3800,0x4400,0x4400,0x4400,0x4400,0x4400,0x3800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'o'
+    { 0x0000,0x4000,0x4000,0x4000,0x5800,0x6400,0x4400,0x4400,0x4400,0x6400,0x5800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'p'
+    { 0x0000,0x0400,0x0400,0x0400,0x3400,0x4c00,0x4400,0x4400,0x4400,0x4c00,0x3400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'q'
+    { 0x0000,0x0000,0x0000,0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x6000,0x5000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'r'
+    { 0x0000,0x0000,0x0000,0x0000,0x3000,0x4800,0x0800,0x3000,0x4000,0x4800,0x3000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 's'
+    { 0x0000,0x0000,0x0000,0x0000,0x6000,0x4000,0x4000,0x4000,0x4000,0x4000,0xe000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // 't'
+    { 0x0000,0x0000,0x0000,0x0000,0x3400,0x4c00,0x4400,0x4400,0x4400,0x4400,0x4400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'u'
+    { 0x0000,0x0000,0x0000,0x0000,0x1000,0x1000,0x2800,0x2800,0x4400,0x4400,0x4400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'v'
+    { 0x0000,0x0000,0x0000,0x0000,0x2200,0x2200,0x5500,0x4900,0x4900,0x8880,0x8880,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'w'
+    { 0x0000,0x0000,0x0000,0x0000,0x8400,0x8400,0x4800,0x3000,0x3000,0x4800,0x8400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'x'
+    { 0x0000,0x4000,0x2000,0x1000,0x1000,0x2800,0x2800,0x4800,0x4400,0x4400,0x4400,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'y'
+    { 0x0000,0x0000,0x0000,0x0000,0x7800,0x4000,0x2000,0x2000,0x1000,0x0800,0x7800,0x0000,0x0000,0x0000,0x0000,0x0000 }, // 'z'
+    { 0x0000,0x3000,0x4000,0x4000,0x4000,0x4000,0x4000,0x8000,0x4000,0x4000,0x4000,0x4000,0x3000,0x0000,0x0000,0x0000 }, // '{'
+    { 0x0000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x4000,0x0000,0x0000,0x0000 }, // '|'
+    { 0x0000,0xc000,0x2000,0x2000,0x2000,0x2000,0x2000,0x1000,0x2000,0x2000,0x2000,0x2000,0xc000,0x0000,0x0000,0x0000 }, // '}'
+    { 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x9800,0x6400,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000 }, // '~'
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// =====================
+// Per-frame bump arena for scratch data (temporary vertex arrays and the like). alloc() hands out
+// uninitialised space by advancing an offset; reset() takes it all back at once. Blocks are kept across
+// resets, and a frame that needed more than one block leaves a single block of their combined size, so a
+// steady frame allocates nothing from the heap. Not thread-safe: one arena per thread or per draw list.
+// =====================
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t blockBytes = 16 << 10) : blockBytes(blockBytes) {}
+    // scratch is per frame, so a copy starts empty
+    FrameArena(const FrameArena& o) : blockBytes(o.blockBytes) {}
+    FrameArena& operator=(const FrameArena& o) { if (this != &o) { blocks.clear(); cur = 0; offset = 0; blockBytes = o.blockBytes; } return *this; }
+    FrameArena(FrameArena&&) = default;
+    FrameArena& operator=(FrameArena&&) = default;
+
+    // room for n Ts, valid until the next reset(); no constructors run, so only trivial types
+    template <class T>
+    T* alloc(size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "the arena never runs destructors");
+        return static_cast<T*>(allocBytes(n * sizeof(T), alignof(T)));
+    }
+
+    void* allocBytes(size_t bytes, size_t align) {
+        if (cur < blocks.size()) {
+            size_t at = (offset + align - 1) & ~(align - 1);
+            if (at + bytes <= blocks[cur].size) { offset = at + bytes; return blocks[cur].data.get() + at; }
+        }
+        // the next kept block, or a new one big enough; a fresh block's start suits any fundamental alignment
+        while (++cur < blocks.size() && blocks[cur].size < bytes) {}
+        if (cur >= blocks.size()) { cur = blocks.size(); blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[std::max(bytes, blockBytes)]), std::max(bytes, blockBytes) }); }
+        offset = bytes;
+        return blocks[cur].data.get();
+    }
+
+    void reset() {
+        if (blocks.size() > 1) {
+            size_t total = 0;
+            for (const Block& b : blocks) total += b.size;
+            blocks.clear();
+            blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[total]), total });
+        }
+        cur = 0; offset = 0;
+    }
+
+    size_t capacity() const { size_t n = 0; for (const Block& b : blocks) n += b.size; return n; }
+
+private:
+    struct Block { std::unique_ptr<unsigned char[]> data; size_t size; };
+    std::vector<Block> blocks;
+    size_t cur = 0, offset = 0;
+    size_t blockBytes;
+};
@@ -0,0 +1,122 @@
+#include "GLFunctions.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <GL/glx.h>
+#endif
+
+static bool glVersionAtLeast(int wantMajor, int wantMinor) {
+    const char* version = (const char*)glGetString(GL_VERSION);
+    int major = 0, minor = 0;
+    if (!version || sscanf(version, "%d.%d", &major, &minor) != 2) return false;
+    return major > wantMajor || (major == wantMajor && minor >= wantMinor);
+}
+
+static bool hasTimerQueries() {
+    const char* ext = (const char*)glGetString(GL_EXTENSIONS);
+    return glVersionAtLeast(3, 3) || (ext && strstr(ext, "GL_ARB_timer_query"));
+}
+
+#ifdef _WIN32
+GLGenBuffersFn glGenBuffersPtr = nullptr;
+GLDeleteBuffersFn glDeleteBuffersPtr = nullptr;
+GLBindBufferFn glBindBufferPtr = nullptr;
+GLBufferDataFn glBufferDataPtr = nullptr;
+GLBufferSubDataFn glBufferSubDataPtr = nullptr;
+GLGenQueriesFn glGenQueriesPtr = nullptr;
+GLDeleteQueriesFn glDeleteQueriesPtr = nullptr;
+GLBeginQueryFn glBeginQueryPtr = nullptr;
+GLEndQueryFn glEndQueryPtr = nullptr;
+GLGetQueryObjectivFn glGetQueryObjectivPtr = nullptr;
+GLGetQueryObjectui64vFn glGetQueryObjectui64vPtr = nullptr;
+GLCreateShaderFn glCreateShaderPtr = nullptr;
+GLShaderSourceFn glShaderSourcePtr = nullptr;
+GLCompileShaderFn glCompileShaderPtr = nullptr;
+GLGetShaderivFn glGetShaderivPtr = nullptr;
+GLGetShaderInfoLogFn glGetShaderInfoLogPtr = nullptr;
+GLDeleteShaderFn glDeleteShaderPtr = nullptr;
+GLCreateProgramFn glCreateProgramPtr = nullptr;
+GLAttachShaderFn glAttachShaderPtr = nullptr;
+GLLinkProgramFn glLinkProgramPtr = nullptr;
+GLGetProgramivFn glGetProgramivPtr = nullptr;
+GLGetProgramInfoLogFn glGetProgramInfoLogPtr = nullptr;
+GLUseProgramFn glUseProgramPtr = nullptr;
+GLGetUniformLocationFn glGetUniformLocationPtr = nullptr;
+GLUniform1fFn glUniform1fPtr = nullptr;
+
+template <class Fn>
+static bool load(Fn& fn, const char* name) {
+    fn = (Fn)wglGetProcAddress(name);
+    return fn != nullptr;
+}
+
+bool loadGLFunctions() {
+    bool ok = true;
+    ok &= load(glGenBuffersPtr, "glGenBuffers");
+    ok &= load(glDeleteBuffersPtr, "glDeleteBuffers");
+    ok &= load(glBindBufferPtr, "glBindBuffer");
+    ok &= load(glBufferDataPtr, "glBufferData");
+    ok &= load(glBufferSubDataPtr, "glBufferSubData");
+    return ok;
+}
+
+bool loadShaderFunctions() {
+    if (!glVersionAtLeast(2, 0)) return false;
+    bool ok = true;
+    ok &= load(glCreateShaderPtr, "glCreateShader");
+    ok &= load(glShaderSourcePtr, "glShaderSource");
+    ok &= load(glCompileShaderPtr, "glCompileShader");
+    ok &= load(glGetShaderivPtr, "glGetShaderiv");
+    ok &= load(glGetShaderInfoLogPtr, "glGetShaderInfoLog");
+    ok &= load(glDeleteShaderPtr, "glDeleteShader");
+    ok &= load(glCreateProgramPtr, "glCreateProgram");
+    ok &= load(glAttachShaderPtr, "glAttachShader");
+    ok &= load(glLinkProgramPtr, "glLinkProgram");
+    ok &= load(glGetProgramivPtr, "glGetProgramiv");
+    ok &= load(glGetProgramInfoLogPtr, "glGetProgramInfoLog");
+    ok &= load(glUseProgramPtr, "glUseProgram");
+    ok &= load(glGetUniformLocationPtr, "glGetUniformLocation");
+    ok &= load(glUniform1fPtr, "glUniform1f");
+    return ok;
+}
+
+bool loadTimerQueries() {
+    if (!hasTimerQueries()) return false;
+    bool ok = true;
+    ok &= load(glGenQueriesPtr, "glGenQueries");
+    ok &= load(glDeleteQueriesPtr, "glDeleteQueries");
+    ok &= load(glBeginQueryPtr, "glBeginQuery");
+    ok &= load(glEndQueryPtr, "glEndQuery");
+    ok &= load(glGetQueryObjectivPtr, "glGetQueryObjectiv");
+    ok &= load(glGetQueryObjectui64vPtr, "glGetQueryObjectui64v");
+    return ok;
+}
+
+bool setSwapInterval(int interval) {
+    typedef BOOL (WINAPI* SwapIntervalFn)(int interval);
+    SwapIntervalFn fn = (SwapIntervalFn)wglGetProcAddress("wglSwapIntervalEXT");
+    return fn && fn(interval);
+}
+#else
+bool loadGLFunctions() { return glVersionAtLeast(1, 5); }
+
+bool loadShaderFunctions() { return glVersionAtLeast(2, 0); }
+
+bool loadTimerQueries() { return hasTimerQueries(); }
+
+bool setSwapInterval(int interval) {
+#ifdef __APPLE__
+    (void)interval; return false;
+#else
+    // Mesa's extension takes the interval directly; SGI's is the common fallback
+    typedef int (*SwapIntervalFn)(unsigned int interval);
+    SwapIntervalFn mesa = (SwapIntervalFn)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalMESA");
+    if (mesa) return mesa((unsigned int)interval) == 0;
+    typedef int (*SwapIntervalSgiFn)(int interval);
+    SwapIntervalSgiFn sgi = (SwapIntervalSgiFn)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalSGI");
+    return sgi && sgi(interval) == 0;
+#endif
+}
+#endif
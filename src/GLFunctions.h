@@ -0,0 +1,126 @@
+#pragma once
+
+// =====================
+// GL headers plus the post-1.1 entry points the renderer uses. Windows' opengl32 only exports GL 1.1,
+// so there they are fetched at runtime with wglGetProcAddress; other platforms link them directly.
+// Include this before any other GL header (glut.h pulls in GL/gl.h).
+// =====================
+
+#ifdef _WIN32
+#include <windows.h>
+#include <GL/gl.h>
+#include <cstddef>
+
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef char GLchar;
+
+#define GL_ARRAY_BUFFER  0x8892
+#define GL_STREAM_DRAW   0x88E0
+#define GL_STATIC_DRAW   0x88E4
+#define GL_QUERY_RESULT            0x8866
+#define GL_QUERY_RESULT_AVAILABLE  0x8867
+#define GL_TIME_ELAPSED            0x88BF
+#define GL_VERTEX_SHADER              0x8B31
+#define GL_COMPILE_STATUS             0x8B81
+#define GL_LINK_STATUS                0x8B82
+#define GL_VERTEX_PROGRAM_POINT_SIZE  0x8642
+
+typedef unsigned __int64 GLuint64;
+
+typedef void (APIENTRY* GLGenBuffersFn)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY* GLDeleteBuffersFn)(GLsizei n, const GLuint* buffers);
+typedef void (APIENTRY* GLBindBufferFn)(GLenum target, GLuint buffer);
+typedef void (APIENTRY* GLBufferDataFn)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+typedef void (APIENTRY* GLBufferSubDataFn)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+typedef void (APIENTRY* GLGenQueriesFn)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY* GLDeleteQueriesFn)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY* GLBeginQueryFn)(GLenum target, GLuint id);
+typedef void (APIENTRY* GLEndQueryFn)(GLenum target);
+typedef void (APIENTRY* GLGetQueryObjectivFn)(GLuint id, GLenum pname, GLint* params);
+typedef void (APIENTRY* GLGetQueryObjectui64vFn)(GLuint id, GLenum pname, GLuint64* params);
+typedef GLuint (APIENTRY* GLCreateShaderFn)(GLenum type);
+typedef void (APIENTRY* GLShaderSourceFn)(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths);
+typedef void (APIENTRY* GLCompileShaderFn)(GLuint shader);
+typedef void (APIENTRY* GLGetShaderivFn)(GLuint shader, GLenum pname, GLint* params);
+typedef void (APIENTRY* GLGetShaderInfoLogFn)(GLuint shader, GLsizei size, GLsizei* length, GLchar* log);
+typedef void (APIENTRY* GLDeleteShaderFn)(GLuint shader);
+typedef GLuint (APIENTRY* GLCreateProgramFn)();
+typedef void (APIENTRY* GLAttachShaderFn)(GLuint program, GLuint shader);
+typedef void (APIENTRY* GLLinkProgramFn)(GLuint program);
+typedef void (APIENTRY* GLGetProgramivFn)(GLuint program, GLenum pname, GLint* params);
+typedef void (APIENTRY* GLGetProgramInfoLogFn)(GLuint program, GLsizei size, GLsizei* length, GLchar* log);
+typedef void (APIENTRY* GLUseProgramFn)(GLuint program);
+typedef GLint (APIENTRY* GLGetUniformLocationFn)(GLuint program, const GLchar* name);
+typedef void (APIENTRY* GLUniform1fFn)(GLint location, GLfloat v0);
+
+extern GLGenBuffersFn glGenBuffersPtr;
+extern GLDeleteBuffersFn glDeleteBuffersPtr;
+extern GLBindBufferFn glBindBufferPtr;
+extern GLBufferDataFn glBufferDataPtr;
+extern GLBufferSubDataFn glBufferSubDataPtr;
+extern GLGenQueriesFn glGenQueriesPtr;
+extern GLDeleteQueriesFn glDeleteQueriesPtr;
+extern GLBeginQueryFn glBeginQueryPtr;
+extern GLEndQueryFn glEndQueryPtr;
+extern GLGetQueryObjectivFn glGetQueryObjectivPtr;
+extern GLGetQueryObjectui64vFn glGetQueryObjectui64vPtr;
+extern GLCreateShaderFn glCreateShaderPtr;
+extern GLShaderSourceFn glShaderSourcePtr;
+extern GLCompileShaderFn glCompileShaderPtr;
+extern GLGetShaderivFn glGetShaderivPtr;
+extern GLGetShaderInfoLogFn glGetShaderInfoLogPtr;
+extern GLDeleteShaderFn glDeleteShaderPtr;
+extern GLCreateProgramFn glCreateProgramPtr;
+extern GLAttachShaderFn glAttachShaderPtr;
+extern GLLinkProgramFn glLinkProgramPtr;
+extern GLGetProgramivFn glGetProgramivPtr;
+extern GLGetProgramInfoLogFn glGetProgramInfoLogPtr;
+extern GLUseProgramFn glUseProgramPtr;
+extern GLGetUniformLocationFn glGetUniformLocationPtr;
+extern GLUniform1fFn glUniform1fPtr;
+
+#define glGenBuffers glGenBuffersPtr
+#define glDeleteBuffers glDeleteBuffersPtr
+#define glBindBuffer glBindBufferPtr
+#define glBufferData glBufferDataPtr
+#define glBufferSubData glBufferSubDataPtr
+#define glGenQueries glGenQueriesPtr
+#define glDeleteQueries glDeleteQueriesPtr
+#define glBeginQuery glBeginQueryPtr
+#define glEndQuery glEndQueryPtr
+#define glGetQueryObjectiv glGetQueryObjectivPtr
+#define glGetQueryObjectui64v glGetQueryObjectui64vPtr
+#define glCreateShader glCreateShaderPtr
+#define glShaderSource glShaderSourcePtr
+#define glCompileShader glCompileShaderPtr
+#define glGetShaderiv glGetShaderivPtr
+#define glGetShaderInfoLog glGetShaderInfoLogPtr
+#define glDeleteShader glDeleteShaderPtr
+#define glCreateProgram glCreateProgramPtr
+#define glAttachShader glAttachShaderPtr
+#define glLinkProgram glLinkProgramPtr
+#define glGetProgramiv glGetProgramivPtr
+#define glGetProgramInfoLog glGetProgramInfoLogPtr
+#define glUseProgram glUseProgramPtr
+#define glGetUniformLocation glGetUniformLocationPtr
+#define glUniform1f glUniform1fPtr
+#else
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+// needs a current context; returns true when buffer objects (GL 1.5) are usable
+bool loadGLFunctions();
+
+// needs a current context; returns true when GLSL vertex shaders (GL 2.0) are usable
+bool loadShaderFunctions();
+
+// needs a current context; returns true when GL_TIME_ELAPSED timer queries (GL 3.3 / ARB_timer_query) work
+bool loadTimerQueries();
+
+// swap interval for the current context (0 = don't wait for vblank); false if the driver offers no control
+bool setSwapInterval(int interval);
@@ -0,0 +1,192 @@
+#include "GLFunctions.h"
+
+#include "GLRenderer.h"
+
+#include <cstdio>
+
+#include "GlyphAtlas.h"
+
+// starPosition(), starPointSize() and starTwinkle() from Starfield.h, per vertex; gl_Vertex is (x, y, depth, phase)
+static const char* STAR_VERTEX_SHADER =
+    "uniform float time, scroll;\n"
+    "void main() {\n"
+    "    float depth = gl_Vertex.z;\n"
+    "    vec2 p = fract(gl_Vertex.xy + vec2(time * DRIFT_X, -(time * DRIFT_Y + scroll * 0.5)) * depth);\n"
+    "    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);\n"
+    "    gl_PointSize = 1.0 + 2.0 * depth;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb * (0.75 + 0.25 * sin(time * TWINKLE_RATE + gl_Vertex.w)), gl_Color.a);\n"
+    "}\n";
+
+// vertex-only program (fragments stay fixed-function, so point smoothing still applies); 0 if it does not build
+static unsigned int buildStarProgram() {
+    char defines[160];
+    snprintf(defines, sizeof(defines), "#version 110\n#define DRIFT_X %.6f\n#define DRIFT_Y %.6f\n#define TWINKLE_RATE %.6f\n", STAR_DRIFT_X, STAR_DRIFT_Y, STAR_TWINKLE_RATE);
+    const GLchar* source[2] = { defines, STAR_VERTEX_SHADER };
+    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vs, 2, source, nullptr);
+    glCompileShader(vs);
+    GLint ok = 0; char log[1024];
+    glGetShaderiv(vs, GL_COMPILE_STATUS, &ok);
+    if (!ok) { glGetShaderInfoLog(vs, sizeof(log), nullptr, log); fprintf(stderr, "starfield shader: %s\n", log); glDeleteShader(vs); return 0; }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glLinkProgram(program);
+    glDeleteShader(vs); // stays alive while attached
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) { glGetProgramInfoLog(program, sizeof(log), nullptr, log); fprintf(stderr, "starfield program: %s\n", log); return 0; }
+    return program;
+}
+
+void GLRenderer::init(int starCount) {
+    useVbo = loadGLFunctions();
+    if (useVbo) glGenBuffers(1, &vbo);
+
+    // starfield: uploaded once; the program moves it, or the fallback recomputes it per frame
+    buildStarfield(starCount, 0x5EEDu, stars, starLayerStart);
+    if (useVbo && loadShaderFunctions() && (starProgram = buildStarProgram()) != 0) {
+        starTimeLoc = glGetUniformLocation(starProgram, "time");
+        starScrollLoc = glGetUniformLocation(starProgram, "scroll");
+        glGenBuffers(1, &starVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, starVbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(stars.size() * sizeof(StarVertex)), stars.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else starScratch.resize(stars.size());
+
+    // font atlas: alpha-only, sampled texel for texel, so text stays as crisp as glBitmap output
+    const GlyphAtlas& atlas = glyphAtlas();
+    glGenTextures(1, &fontTexture);
+    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas.width(), atlas.height(), 0, GL_ALPHA, GL_UNSIGNED_BYTE, atlas.pixels().data());
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void GLRenderer::drawStarfield(const StarfieldPass& pass) {
+    if (stars.empty()) return;
+    if (starProgram) {
+        glBindBuffer(GL_ARRAY_BUFFER, starVbo);
+        glVertexPointer(4, GL_FLOAT, sizeof(StarVertex), (const void*)0);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(StarVertex), (const void*)offsetof(StarVertex, r));
+        glUseProgram(starProgram);
+        glUniform1f(starTimeLoc, pass.time); glUniform1f(starScrollLoc, pass.scroll);
+        glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)stars.size());
+        glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        glUseProgram(0);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        ++lastDrawCalls;
+    }
+    else {
+        // no GLSL: the same motion on the CPU, one draw per layer for its point size
+        for (size_t i = 0;i < stars.size();++i) {
+            const StarVertex& s = stars[i];
+            Vec2 p = starPosition(s, pass.time, pass.scroll);
+            float tw = starTwinkle(s, pass.time);
+            DrawVertex& v = starScratch[i];
+            v.x = p.x; v.y = p.y; v.r = (uint8_t)(s.r * tw); v.g = (uint8_t)(s.g * tw); v.b = (uint8_t)(s.b * tw); v.a = s.a;
+        }
+        if (useVbo) glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glVertexPointer(2, GL_FLOAT, sizeof(DrawVertex), &starScratch[0].x);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(DrawVertex), &starScratch[0].r);
+        for (int l = 0;l < STARFIELD_LAYERS;++l) {
+            int first = starLayerStart[l], n = starLayerStart[l + 1] - first;
+            if (!n) continue;
+            glPointSize(starPointSize(stars[first].depth));
+            glDrawArrays(GL_POINTS, first, n);
+            ++lastDrawCalls;
+        }
+        if (useVbo) glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    }
+    lastVertices += stars.size();
+}
+
+static GLenum glModeFor(BatchPrim prim) {
+    switch (prim) {
+    case BATCH_LINES: return GL_LINES;
+    case BATCH_POINTS: return GL_POINTS;
+    default: return GL_TRIANGLES;
+    }
+}
+
+void GLRenderer::submit(DrawList& dl, int viewportW, int viewportH) {
+    const std::vector<const DrawBatch*>& batches = dl.sortedBatches();
+    glyphAtlas().layoutText(dl, viewportW, viewportH);
+    lastDrawCalls = 0; lastVertices = 0;
+
+    size_t total = 0, textTotal = 0;
+    for (const DrawBatch* b : batches) total += b->verts.size();
+    for (int layer = 0;layer < LAYER_COUNT;++layer) textTotal += dl.glyphVertices(layer).size();
+    lastVertices = total + textTotal;
+
+    // glyph vertices follow the geometry in the same buffer
+    const size_t textBase = total * sizeof(DrawVertex);
+    const GLsizei stride = sizeof(DrawVertex), textStride = sizeof(TextVertex);
+    if (useVbo) {
+        // one upload per frame: orphan the buffer, then copy each batch into its slice
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        size_t bytes = textBase + textTotal * sizeof(TextVertex);
+        if (bytes > vboBytes) vboBytes = bytes + bytes / 2;
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vboBytes, nullptr, GL_STREAM_DRAW);
+        size_t offset = 0;
+        for (const DrawBatch* b : batches) {
+            size_t n = b->verts.size() * sizeof(DrawVertex);
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)n, b->verts.data());
+            offset += n;
+        }
+        for (int layer = 0;layer < LAYER_COUNT;++layer) {
+            const std::vector<TextVertex>& tv = dl.glyphVertices(layer);
+            size_t n = tv.size() * sizeof(TextVertex);
+            if (n) glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)n, tv.data());
+            offset += n;
+        }
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    // batches are sorted by layer; text of a layer goes on top of that layer's geometry
+    size_t first = 0, textFirst = 0, bi = 0;
+    for (int layer = 0;layer < LAYER_COUNT;++layer) {
+        if (useVbo) {
+            glVertexPointer(2, GL_FLOAT, stride, (const void*)0);
+            glColorPointer(4, GL_UNSIGNED_BYTE, stride, (const void*)offsetof(DrawVertex, r));
+        }
+        for (;bi < batches.size() && batches[bi]->layer == layer;++bi) {
+            const DrawBatch* b = batches[bi];
+            if (!useVbo) {
+                glVertexPointer(2, GL_FLOAT, stride, &b->verts[0].x);
+                glColorPointer(4, GL_UNSIGNED_BYTE, stride, &b->verts[0].r);
+            }
+            if (b->prim == BATCH_POINTS) glPointSize(b->pointSize);
+            glDrawArrays(glModeFor(b->prim), useVbo ? (GLint)first : 0, (GLsizei)b->verts.size());
+            first += b->verts.size();
+            ++lastDrawCalls;
+        }
+        if (layer == LAYER_BACKGROUND && dl.starfieldPass().on) drawStarfield(dl.starfieldPass());
+
+        const std::vector<TextVertex>& tv = dl.glyphVertices(layer);
+        if (tv.empty()) continue;
+        // buffer offset of the glyph region (VBO) or the layer's own array (fallback)
+        const char* base = useVbo ? (const char*)textBase : (const char*)tv.data();
+        glVertexPointer(2, GL_FLOAT, textStride, base + offsetof(TextVertex, x));
+        glColorPointer(4, GL_UNSIGNED_BYTE, textStride, base + offsetof(TextVertex, r));
+        glTexCoordPointer(2, GL_FLOAT, textStride, base + offsetof(TextVertex, u));
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnable(GL_TEXTURE_2D); glBindTexture(GL_TEXTURE_2D, fontTexture);
+        glDrawArrays(GL_TRIANGLES, useVbo ? (GLint)textFirst : 0, (GLsizei)tv.size());
+        glDisable(GL_TEXTURE_2D); glBindTexture(GL_TEXTURE_2D, 0);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        textFirst += tv.size();
+        ++lastDrawCalls;
+    }
+    glPointSize(1.0f);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (useVbo) glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
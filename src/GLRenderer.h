@@ -0,0 +1,43 @@
+#pragma once
+
+// =====================
+// Submits a DrawList: all batch vertices are streamed into one vertex buffer per frame and each batch
+// becomes a single glDrawArrays. Text is laid out against the glyph atlas texture, so each layer's
+// strings cost one more draw. Falls back to client-side vertex arrays when buffer objects are missing.
+// The starfield lives in a static buffer and is moved by a vertex shader, one draw for every star; without
+// GLSL its positions are computed on the CPU each frame instead.
+// =====================
+
+#include <cstddef>
+#include <vector>
+
+#include "DrawList.h"
+#include "Starfield.h"
+
+class GLRenderer {
+public:
+    // call once with the GL context current
+    void init(int starCount = STARFIELD_DEFAULT_STARS);
+    // viewport size in pixels is needed to pixel-align the glyph quads
+    void submit(DrawList& dl, int viewportW, int viewportH);
+
+    int drawCalls() const { return lastDrawCalls; }
+    size_t vertices() const { return lastVertices; }
+
+private:
+    void drawStarfield(const StarfieldPass& pass);
+
+    unsigned int vbo = 0;
+    unsigned int fontTexture = 0;
+    bool useVbo = false;
+    size_t vboBytes = 0;
+    int lastDrawCalls = 0;
+    size_t lastVertices = 0;
+
+    // starfield: static buffer and program, or the CPU fallback's per-frame positions (sized once)
+    std::vector<StarVertex> stars;
+    int starLayerStart[STARFIELD_LAYERS + 1] = {};
+    unsigned int starVbo = 0, starProgram = 0;
+    int starTimeLoc = -1, starScrollLoc = -1;
+    std::vector<DrawVertex> starScratch;
+};
@@ -0,0 +1,735 @@
+#define _USE_MATH_DEFINES
+
+#include "GameCore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+#include "EntityKernels.h"
+#include "JobSystem.h"
+#include "LevelGen.h"
+
+// helpers
+float randf(GameState& s, float a, float b) {
+    // xorshift32: cheap, and identical on every platform unlike rand()
+    uint32_t x = s.rngState;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    s.rngState = x;
+    return a + (float(x >> 8) / float(1u << 24)) * (b - a);
+}
+
+void setStatus(GameState& s, const char* fmt, ...) {
+    va_list args; va_start(args, fmt);
+    vsnprintf(s.statusMessage, sizeof(s.statusMessage), fmt, args);
+    va_end(args);
+}
+
+// =====================
+// Placement and collision queries
+// =====================
+
+bool pointInsideGameArea(const GameState& s, const Vec2& screen, const Vec2& world) {
+    if (world.x < WORLD_LEFT + 0.02f || world.x > WORLD_RIGHT - 0.02f) return false;
+    float topLimit = 1.0f - UI_TOP_HEIGHT;
+    float bottomLimit = -1.0f + UI_BOTTOM_HEIGHT;
+    if (screen.y > topLimit - 0.01f) return false;
+    if (screen.y < bottomLimit + 0.01f) return false;
+    if (world.y < WORLD_BOTTOM || world.y > s.worldTop) return false;
+    return true;
+}
+
+bool bandsPending(const GameState& s, float y0, float y1) {
+    float reach = std::max(s.chunks.obstacleReach(), 0.1f);
+    for (int b = chunkBand(y0 - reach), last = chunkBand(y1 + reach);b <= last;++b) if (s.chunks.pending(b)) return true;
+    return false;
+}
+
+// Entities are filed under the band of their centre, so a query of radius r only visits the chunks of the
+// bands within r. Inside a chunk, small stores (what an editor session produces) are scanned linearly with
+// the SIMD kernels, which beats hashing into nine cells; larger ones go through the chunk's grids. Both
+// test squared distances and keep the lowest matching index, so they agree exactly.
+bool tooCloseToExisting(const GameState& s, const Vec2& p, float minDist) {
+    const float r2 = minDist * minDist;
+    auto within = [&](const Column<float>& xs, const Column<float>& ys, uint32_t i) { float dx = xs[i] - p.x, dy = ys[i] - p.y; return dx * dx + dy * dy < r2; };
+    for (int b = chunkBand(p.y - minDist), last = chunkBand(p.y + minDist);b <= last;++b) {
+        const LevelChunk* ch = s.chunks.at(b);
+        if (!ch) continue;
+        const CollectibleStore& c = ch->collectibles; const ObstacleStore& o = ch->obstacles; const PowerupStore& pu = ch->powerups;
+        if (c.size() <= SMALL_LEVEL_SCAN) { if (firstWithinRadius(c.x.data(), c.y.data(), c.active.words(), c.size(), p.x, p.y, r2) >= 0) return true; }
+        else if (ch->collectibleGrid.query(p.x, p.y, minDist, [&](uint32_t i) { return within(c.x, c.y, i); })) return true;
+        if (o.size() <= SMALL_LEVEL_SCAN) { if (firstWithinRadius(o.x.data(), o.y.data(), nullptr, o.size(), p.x, p.y, r2) >= 0) return true; }
+        else if (ch->obstacleGrid.query(p.x, p.y, minDist, [&](uint32_t i) { return within(o.x, o.y, i); })) return true;
+        if (pu.size() <= SMALL_LEVEL_SCAN) { if (firstWithinRadius(pu.x.data(), pu.y.data(), pu.active.words(), pu.size(), p.x, p.y, r2) >= 0) return true; }
+        else if (ch->powerupGrid.query(p.x, p.y, minDist, [&](uint32_t i) { return within(pu.x, pu.y, i); })) return true;
+    }
+    return false;
+}
+
+// the grids return candidates in cell order, so keep the lowest matching index to stay independent of it
+static int obstacleIndexIn(const LevelChunk& ch, float nx, float ny) {
+    const ObstacleStore& o = ch.obstacles;
+    if (o.size() <= SMALL_LEVEL_SCAN) return firstAabbHit(o.x.data(), o.y.data(), o.w.data(), o.h.data(), nullptr, o.size(), nx, ny, OBSTACLE_MARGIN);
+    int best = -1;
+    ch.obstacleGrid.query(nx, ny, ch.obstacleReach, [&](uint32_t i) {
+        if (fabsf(nx - o.x[i]) < o.w[i] + OBSTACLE_MARGIN && fabsf(ny - o.y[i]) < o.h[i] + OBSTACLE_MARGIN && (best < 0 || (int)i < best)) best = (int)i;
+        return false;
+    });
+    return best;
+}
+
+EntityRef obstacleAt(const GameState& s, float nx, float ny) {
+    EntityRef ref;
+    float reach = s.chunks.obstacleReach();
+    for (int b = chunkBand(ny - reach), last = chunkBand(ny + reach);b <= last;++b) {
+        const LevelChunk* ch = s.chunks.at(b);
+        int i = ch ? obstacleIndexIn(*ch, nx, ny) : -1;
+        if (i >= 0) { ref.band = b; ref.index = i; break; }
+    }
+    return ref;
+}
+
+bool collidesWithObstacle(const GameState& s, float nx, float ny) { return collidesWithObstacle(roundView(s), nx, ny); }
+
+// lowest active entity within radius r of (nx, ny), by scan or grid as above
+static int pickupIndexAt(const Column<float>& xs, const Column<float>& ys, const ActiveBits& active, const SpatialGrid& grid, float nx, float ny, float r) {
+    const float r2 = r * r;
+    if (xs.size() <= SMALL_LEVEL_SCAN) return firstWithinRadius(xs.data(), ys.data(), active.words(), xs.size(), nx, ny, r2);
+    int best = -1;
+    grid.query(nx, ny, r, [&](uint32_t i) {
+        float dx = xs[i] - nx, dy = ys[i] - ny;
+        if (active.test(i) && dx * dx + dy * dy < r2 && (best < 0 || (int)i < best)) best = (int)i;
+        return false;
+    });
+    return best;
+}
+
+int collectAt(GameState& s, float nx, float ny) {
+    for (int b = chunkBand(ny - PICKUP_RADIUS), last = chunkBand(ny + PICKUP_RADIUS);b <= last;++b) {
+        LevelChunk* ch = s.chunks.at(b);
+        if (!ch) continue;
+        CollectibleStore& c = ch->collectibles;
+        int best = pickupIndexAt(c.x, c.y, c.active, ch->collectibleGrid, nx, ny, PICKUP_RADIUS);
+        if (best < 0) continue;
+        EntityRef ref; ref.band = b; ref.index = best;
+        collectCollectible(s, ref);
+        return 1;
+    }
+    return 0;
+}
+
+void collectCollectible(GameState& s, const EntityRef& ref) {
+    if (ref.band == MOVING_BAND) { s.motion.collectibles.active.set(ref.index, false); return; }
+    LevelChunk* ch = s.chunks.at(ref.band);
+    if (!ch) return;
+    // collected stars stay in the store (inactive) but leave the index
+    CollectibleStore& c = ch->collectibles; int i = ref.index;
+    c.active.set(i, false); ch->collectibleGrid.remove((uint32_t)i, c.x[i], c.y[i]); ch->dirty = true;
+}
+
+int powerupAt(GameState& s, float nx, float ny, PowerUp& out, EntityRef& ref) {
+    for (int b = chunkBand(ny - PICKUP_RADIUS), last = chunkBand(ny + PICKUP_RADIUS);b <= last;++b) {
+        LevelChunk* ch = s.chunks.at(b);
+        if (!ch) continue;
+        PowerupStore& p = ch->powerups;
+        int best = pickupIndexAt(p.x, p.y, p.active, ch->powerupGrid, nx, ny, PICKUP_RADIUS);
+        if (best < 0) continue;
+        out = p.get(best); out.active = false; ref.band = b; ref.index = best;
+        p.active.set(best, false); ch->powerupGrid.remove((uint32_t)best, p.x[best], p.y[best]); ch->dirty = true;
+        return 1;
+    }
+    return 0;
+}
+
+// Swept queries visit the bands the move's bounding box reaches. Small chunks go through the swept kernels;
+// large ones test the grid candidates under that box with the same per-entity functions the kernels use.
+// Earliest t wins, then the lowest index, so the two paths agree exactly and the grid's cell order does not
+// matter. Each goes through a RoundView's masks; a GameState's grids only hold what its masks let through,
+// and a VecEnv instance's grids (the level's) hold more, which the mask drops.
+static inline bool earlier(float ti, int i, float bt, int best) { return best < 0 || ti < bt || (ti == bt && i < best); }
+static inline bool bitOn(const uint64_t* words, size_t i) { return (words[i >> 6] >> (i & 63)) & 1u; }
+
+static int obstacleSweepIn(const LevelChunk& ch, const uint64_t* alive, const Sweep& sw, const Vec2& a, const Vec2& b, float& t) {
+    const ObstacleStore& o = ch.obstacles;
+    if (o.size() <= SMALL_LEVEL_SCAN) return earliestSweptAabbHit(o.x.data(), o.y.data(), o.w.data(), o.h.data(), alive, o.size(), sw, OBSTACLE_MARGIN, t);
+    int best = -1; float bt = 0.0f, ti;
+    const float r = ch.obstacleReach;
+    ch.obstacleGrid.queryRect(std::min(a.x, b.x) - r, std::min(a.y, b.y) - r, std::max(a.x, b.x) + r, std::max(a.y, b.y) + r, [&](uint32_t i) {
+        if ((!alive || bitOn(alive, i)) && sweepAabb(sw, o.x[i], o.y[i], o.w[i] + OBSTACLE_MARGIN, o.h[i] + OBSTACLE_MARGIN, ti) && earlier(ti, (int)i, bt, best)) { best = (int)i; bt = ti; }
+        return false;
+    });
+    if (best >= 0) t = bt;
+    return best;
+}
+
+static int pickupSweepIn(const Column<float>& xs, const Column<float>& ys, const uint64_t* active, const SpatialGrid& grid, const Sweep& sw, const Vec2& a, const Vec2& b, float r, float& t) {
+    const float r2 = r * r;
+    if (xs.size() <= SMALL_LEVEL_SCAN) return earliestSweptCircleHit(xs.data(), ys.data(), active, xs.size(), sw, r2, t);
+    int best = -1; float bt = 0.0f, ti;
+    grid.queryRect(std::min(a.x, b.x) - r, std::min(a.y, b.y) - r, std::max(a.x, b.x) + r, std::max(a.y, b.y) + r, [&](uint32_t i) {
+        if (bitOn(active, i) && sweepCircle(sw, xs[i], ys[i], r2, ti) && earlier(ti, (int)i, bt, best)) { best = (int)i; bt = ti; }
+        return false;
+    });
+    if (best >= 0) t = bt;
+    return best;
+}
+
+// earliest over the bands within reach of the move; a later band only wins with a strictly earlier t
+template <class InChunk>
+static EntityRef sweepBands(const GameState& s, const Vec2& a, const Vec2& b, float reach, float& t, InChunk&& inChunk) {
+    EntityRef ref; float bt = 0.0f;
+    for (int band = chunkBand(std::min(a.y, b.y) - reach), last = chunkBand(std::max(a.y, b.y) + reach);band <= last;++band) {
+        const LevelChunk* ch = s.chunks.at(band);
+        float ti = 0.0f;
+        int i = ch ? inChunk(*ch, ti) : -1;
+        if (i >= 0 && (!ref.valid() || ti < bt)) { ref.band = band; ref.index = i; bt = ti; }
+    }
+    if (ref.valid()) t = bt;
+    return ref;
+}
+
+// a moving entity (found by a scan of the whole store) only wins with a strictly earlier t
+static void preferEarlierMover(EntityRef& ref, float& t, int mover, float tm) {
+    if (mover >= 0 && (!ref.valid() || tm < t)) { ref.band = MOVING_BAND; ref.index = mover; t = tm; }
+}
+
+RoundView roundView(const GameState& s) {
+    RoundView v;
+    v.level = &s;
+    v.movingObstacleX = s.motion.obstacles.motion.x.data(); v.movingObstacleY = s.motion.obstacles.motion.y.data();
+    v.movingCollectibleX = s.motion.collectibles.motion.x.data(); v.movingCollectibleY = s.motion.collectibles.motion.y.data();
+    return v;
+}
+
+EntityRef sweepObstacles(const RoundView& v, const Vec2& a, const Vec2& b, float& t) {
+    const Sweep sw(a.x, a.y, b.x, b.y);
+    EntityRef ref = sweepBands(*v.level, a, b, v.level->chunks.obstacleReach(), t, [&](const LevelChunk& ch, float& ti) { return obstacleSweepIn(ch, v.obstacles(ch), sw, a, b, ti); });
+    const MovingObstacleStore& mo = v.level->motion.obstacles;
+    float tm = 0.0f;
+    if (mo.size()) preferEarlierMover(ref, t, earliestSweptAabbHit(v.movingObstacleX, v.movingObstacleY, mo.w.data(), mo.h.data(), v.movingObstacles(), mo.size(), sw, OBSTACLE_MARGIN, tm), tm);
+    return ref;
+}
+
+EntityRef sweepCollectibles(const RoundView& v, const Vec2& a, const Vec2& b, float& t) {
+    const Sweep sw(a.x, a.y, b.x, b.y);
+    EntityRef ref = sweepBands(*v.level, a, b, PICKUP_RADIUS, t, [&](const LevelChunk& ch, float& ti) {
+        const CollectibleStore& c = ch.collectibles;
+        return pickupSweepIn(c.x, c.y, v.collectibles(ch), ch.collectibleGrid, sw, a, b, PICKUP_RADIUS, ti);
+    });
+    const MovingCollectibleStore& mc = v.level->motion.collectibles;
+    float tm = 0.0f;
+    if (mc.size()) preferEarlierMover(ref, t, earliestSweptCircleHit(v.movingCollectibleX, v.movingCollectibleY, v.movingCollectibles(), mc.size(), sw, PICKUP_RADIUS * PICKUP_RADIUS, tm), tm);
+    return ref;
+}
+
+EntityRef sweepPowerups(const RoundView& v, const Vec2& a, const Vec2& b, float& t) {
+    const Sweep sw(a.x, a.y, b.x, b.y);
+    return sweepBands(*v.level, a, b, PICKUP_RADIUS, t, [&](const LevelChunk& ch, float& ti) {
+        const PowerupStore& p = ch.powerups;
+        return pickupSweepIn(p.x, p.y, v.powerups(ch), ch.powerupGrid, sw, a, b, PICKUP_RADIUS, ti);
+    });
+}
+
+EntityRef sweepObstacles(const GameState& s, const Vec2& a, const Vec2& b, float& t) { return sweepObstacles(roundView(s), a, b, t); }
+EntityRef sweepCollectibles(const GameState& s, const Vec2& a, const Vec2& b, float& t) { return sweepCollectibles(roundView(s), a, b, t); }
+EntityRef sweepPowerups(const GameState& s, const Vec2& a, const Vec2& b, float& t) { return sweepPowerups(roundView(s), a, b, t); }
+
+// chunk obstacles only, as obstacleAt()
+bool collidesWithObstacle(const RoundView& v, float nx, float ny) {
+    const float reach = v.level->chunks.obstacleReach();
+    for (int b = chunkBand(ny - reach), last = chunkBand(ny + reach);b <= last;++b) {
+        const LevelChunk* ch = v.level->chunks.at(b);
+        if (!ch) continue;
+        const ObstacleStore& o = ch->obstacles; const uint64_t* alive = v.obstacles(*ch);
+        if (o.size() <= SMALL_LEVEL_SCAN) { if (firstAabbHit(o.x.data(), o.y.data(), o.w.data(), o.h.data(), alive, o.size(), nx, ny, OBSTACLE_MARGIN) >= 0) return true; continue; }
+        if (ch->obstacleGrid.query(nx, ny, ch->obstacleReach, [&](uint32_t k) {
+            return (!alive || bitOn(alive, k)) && fabsf(nx - o.x[k]) < o.w[k] + OBSTACLE_MARGIN && fabsf(ny - o.y[k]) < o.h[k] + OBSTACLE_MARGIN;
+        })) return true;
+    }
+    return false;
+}
+
+// =====================
+// Level editing (chunk stores + spatial indices)
+// =====================
+
+void addObstacle(GameState& s, const Obstacle& o) {
+    s.solvability.addBox(o.pos.x, o.pos.y, o.w + OBSTACLE_MARGIN, o.h + OBSTACLE_MARGIN, 1);
+    LevelChunk& ch = s.chunks.ensure(chunkBand(o.pos.y));
+    ch.obstacleGrid.insert((uint32_t)ch.obstacles.size(), o.pos.x, o.pos.y);
+    ch.obstacles.push(o);
+    ch.obstacleReach = std::max(ch.obstacleReach, std::max(o.w, o.h) + OBSTACLE_MARGIN);
+    s.chunks.noteReach(ch.obstacleReach);
+    ch.dirty = true;
+}
+
+void addCollectible(GameState& s, const Collectible& c) {
+    LevelChunk& ch = s.chunks.ensure(chunkBand(c.pos.y));
+    if (c.active) ch.collectibleGrid.insert((uint32_t)ch.collectibles.size(), c.pos.x, c.pos.y);
+    ch.collectibles.push(c);
+    ch.dirty = true;
+}
+
+void addPowerup(GameState& s, const PowerUp& p) {
+    LevelChunk& ch = s.chunks.ensure(chunkBand(p.pos.y));
+    if (p.active) ch.powerupGrid.insert((uint32_t)ch.powerups.size(), p.pos.x, p.pos.y);
+    ch.powerups.push(p);
+    ch.dirty = true;
+}
+
+void addEntities(GameState& s, const std::vector<Obstacle>& obstacles, const std::vector<Collectible>& collectibles, const std::vector<PowerUp>& powerups) {
+    // per band: how many of each kind arrive, so every store grows once
+    std::vector<uint32_t> counts; // 3 per band
+    auto count = [&](float y, int kind) { size_t b = (size_t)chunkBand(y); if (3 * b + 3 > counts.size()) counts.resize(3 * b + 3, 0); ++counts[3 * b + kind]; };
+    for (const Obstacle& o : obstacles) count(o.pos.y, 0);
+    for (const Collectible& c : collectibles) count(c.pos.y, 1);
+    for (const PowerUp& p : powerups) count(p.pos.y, 2);
+    for (int b = 0;b < (int)counts.size() / 3;++b) {
+        if (!counts[3 * b] && !counts[3 * b + 1] && !counts[3 * b + 2]) continue;
+        LevelChunk& ch = s.chunks.ensure(b);
+        ObstacleStore& o = ch.obstacles; CollectibleStore& c = ch.collectibles; PowerupStore& p = ch.powerups;
+        size_t no = o.size() + counts[3 * b], nc = c.size() + counts[3 * b + 1], np = p.size() + counts[3 * b + 2];
+        o.x.reserve(no); o.y.reserve(no); o.w.reserve(no); o.h.reserve(no);
+        c.x.reserve(nc); c.y.reserve(nc); c.phase.reserve(nc);
+        p.x.reserve(np); p.y.reserve(np); p.phase.reserve(np); p.type.reserve(np);
+    }
+    for (const Obstacle& o : obstacles) {
+        s.solvability.addBox(o.pos.x, o.pos.y, o.w + OBSTACLE_MARGIN, o.h + OBSTACLE_MARGIN, 1);
+        LevelChunk& ch = *s.chunks.at(chunkBand(o.pos.y));
+        ch.obstacles.push(o);
+        ch.obstacleReach = std::max(ch.obstacleReach, std::max(o.w, o.h) + OBSTACLE_MARGIN);
+    }
+    for (const Collectible& c : collectibles) s.chunks.at(chunkBand(c.pos.y))->collectibles.push(c);
+    for (const PowerUp& p : powerups) s.chunks.at(chunkBand(p.pos.y))->powerups.push(p);
+    // then each grid is built once over its whole store
+    for (int b = 0;b < (int)counts.size() / 3;++b) {
+        if (!counts[3 * b] && !counts[3 * b + 1] && !counts[3 * b + 2]) continue;
+        LevelChunk& ch = *s.chunks.at(b);
+        ch.obstacleGrid.build(ch.obstacles.x.data(), ch.obstacles.y.data(), nullptr, ch.obstacles.size());
+        ch.collectibleGrid.build(ch.collectibles.x.data(), ch.collectibles.y.data(), ch.collectibles.active.words(), ch.collectibles.size());
+        ch.powerupGrid.build(ch.powerups.x.data(), ch.powerups.y.data(), ch.powerups.active.words(), ch.powerups.size());
+        s.chunks.noteReach(ch.obstacleReach);
+        ch.dirty = true;
+    }
+}
+
+void removeObstacle(GameState& s, const EntityRef& ref) {
+    if (ref.band == MOVING_BAND) { s.motion.obstacles.remove(ref.index); return; }
+    LevelChunk* ch = s.chunks.at(ref.band);
+    if (!ch) return;
+    ObstacleStore& o = ch->obstacles; int index = ref.index;
+    s.solvability.addBox(o.x[index], o.y[index], o.w[index] + OBSTACLE_MARGIN, o.h[index] + OBSTACLE_MARGIN, -1);
+    uint32_t last = (uint32_t)o.size() - 1;
+    ch->obstacleGrid.remove((uint32_t)index, o.x[index], o.y[index]);
+    if ((uint32_t)index != last) ch->obstacleGrid.relabel(last, (uint32_t)index, o.x[last], o.y[last]);
+    o.remove(index);
+    ch->dirty = true;
+}
+
+void removePowerup(GameState& s, const EntityRef& ref) {
+    LevelChunk* ch = s.chunks.at(ref.band);
+    if (!ch) return;
+    PowerupStore& p = ch->powerups; int index = ref.index;
+    uint32_t last = (uint32_t)p.size() - 1;
+    if (p.active.test(index)) ch->powerupGrid.remove((uint32_t)index, p.x[index], p.y[index]);
+    if ((uint32_t)index != last && p.active.test(last)) ch->powerupGrid.relabel(last, (uint32_t)index, p.x[last], p.y[last]);
+    p.remove(index);
+    ch->dirty = true;
+}
+
+void addMovingObstacle(GameState& s, int path, const Vec2& origin, float dist, float speed, float w, float h) {
+    Vec2 at = s.motion.paths.sample(path, dist);
+    MovingObstacleStore& mo = s.motion.obstacles;
+    mo.motion.push((uint32_t)path, origin, dist, speed, Vec2(origin.x + at.x, origin.y + at.y));
+    mo.w.push_back(w); mo.h.push_back(h);
+}
+
+void addMovingCollectible(GameState& s, int path, const Vec2& origin, float dist, float speed, float phase) {
+    Vec2 at = s.motion.paths.sample(path, dist);
+    MovingCollectibleStore& mc = s.motion.collectibles;
+    mc.motion.push((uint32_t)path, origin, dist, speed, Vec2(origin.x + at.x, origin.y + at.y));
+    mc.phase.push_back(phase); mc.active.push_back(true);
+}
+
+void clearLevel(GameState& s) {
+    s.chunks.clear();
+    s.motion.clear(); s.patrolPath = -1;
+    s.worldTop = WORLD_TOP;
+    s.solvability.invalidate();
+}
+
+void setTargetPath(GameState& s, const Vec2* ctrl) {
+    s.targetBezier.assign(ctrl, ctrl + 4);
+    s.targetPath.clear(); s.targetPath.addBezier(ctrl, 4, false);
+    s.targetDist = 0.0f; s.targetPos = ctrl[0];
+    s.solvability.invalidate();
+}
+
+// the editor's patrol: a flat loop through four points around the placement, added on first use
+static int patrolPath(GameState& s) {
+    if (s.patrolPath < 0) {
+        const Vec2 loop[4] = { Vec2(-0.2f, 0.0f), Vec2(0.0f, 0.06f), Vec2(0.2f, 0.0f), Vec2(0.0f, -0.06f) };
+        s.patrolPath = s.motion.paths.addCatmullRom(loop, 4, true);
+    }
+    return s.patrolPath;
+}
+
+// =====================
+// Editor clicks: tool panel selection and object placement
+// =====================
+
+void applyClick(GameState& s, const Vec2& screen) {
+    Vec2 w = screen; // the tool panel is fixed on screen; placement below works in world coordinates
+    float yPanel = -1.0f + UI_BOTTOM_HEIGHT / 2.0f;
+    float startX = TOOL_PANEL_START_X; float gap = TOOL_PANEL_GAP;
+    float epsX = 0.08f;
+    if (fabs(w.y - yPanel) < 0.12f) {
+        if (fabs(w.x - startX) < epsX) { s.selectedTool = TOOL_OBSTACLE; setStatus(s, "Obstacle drawing mode"); return; }
+        if (fabs(w.x - (startX + gap)) < epsX) { s.selectedTool = TOOL_COLLECTIBLE; setStatus(s, "Collectible drawing mode"); return; }
+        if (fabs(w.x - (startX + gap * 2)) < epsX) { s.selectedTool = TOOL_P_SHIELD; setStatus(s, "Shield powerup drawing mode"); return; }
+        if (fabs(w.x - (startX + gap * 3)) < epsX) { s.selectedTool = TOOL_P_SPEED; setStatus(s, "Speed powerup drawing mode"); return; }
+    }
+    if (!s.gameStarted && s.selectedTool != TOOL_NONE) {
+        w = screenToWorld(s, screen);
+        if (!pointInsideGameArea(s, screen, w)) { setStatus(s, "Cannot place outside game area"); s.messageTimer = 2.0f; return; }
+        if (!((w.y > s.playerY) && (w.y < s.targetPos.y))) { setStatus(s, "Place object between player and target"); s.messageTimer = 2.0f; return; }
+        if (bandsPending(s, w.y, w.y)) { setStatus(s, "Level data still loading here"); s.messageTimer = 2.0f; return; }
+        if (tooCloseToExisting(s, w, PLACEMENT_SPACING)) { setStatus(s, "Too close to another object"); s.messageTimer = 2.0f; return; }
+        if (s.placeMoving && s.selectedTool == TOOL_OBSTACLE) {
+            int path = patrolPath(s);
+            addMovingObstacle(s, path, w, randf(s, 0.0f, s.motion.paths.period(path)), PATROL_SPEED, 0.08f, 0.06f); setStatus(s, "Placed moving obstacle");
+        }
+        else if (s.placeMoving && s.selectedTool == TOOL_COLLECTIBLE) {
+            int path = patrolPath(s);
+            addMovingCollectible(s, path, w, randf(s, 0.0f, s.motion.paths.period(path)), PATROL_SPEED, randf(s, 0, 6.28f)); setStatus(s, "Placed moving collectible");
+        }
+        else if (s.selectedTool == TOOL_OBSTACLE) { Obstacle o; o.pos = w; o.w = 0.08f; o.h = 0.06f; addObstacle(s, o); setStatus(s, "Placed obstacle"); }
+        else if (s.selectedTool == TOOL_COLLECTIBLE) { Collectible c; c.pos = w; c.active = true; c.phase = randf(s, 0, 6.28f); addCollectible(s, c); setStatus(s, "Placed collectible"); }
+        else if (s.selectedTool == TOOL_P_SHIELD) { PowerUp p; p.pos = w; p.type = P_SHIELD; p.active = true; p.phase = 0.0f; addPowerup(s, p); setStatus(s, "Placed shield powerup"); }
+        else if (s.selectedTool == TOOL_P_SPEED) { PowerUp p; p.pos = w; p.type = P_SPEED; p.active = true; p.phase = 0.0f; addPowerup(s, p); setStatus(s, "Placed speed powerup"); }
+        s.messageTimer = 1.5f; return;
+    }
+}
+
+// =====================
+// Keyboard: R starts game, restarts etc.; M toggles moving placement and G fills the level while editing
+// =====================
+void applyKey(GameState& s, unsigned char key) {
+    if ((key == 'm' || key == 'M') && !s.gameStarted) {
+        s.placeMoving = !s.placeMoving;
+        setStatus(s, s.placeMoving ? "New obstacles and collectibles will move" : "New objects stay in place"); s.messageTimer = 1.5f;
+        return;
+    }
+    if ((key == 'g' || key == 'G') && !s.gameStarted) {
+        // seeded from the run's RNG, so a replay generates the same objects
+        LevelGenOptions o; o.seed = s.rngState; randf(s, 0.0f, 1.0f);
+        size_t placed = generateLevel(s, o);
+        if (placed) setStatus(s, "Generated %zu objects", placed);
+        else setStatus(s, bandsPending(s, s.playerY, s.targetPos.y) ? "Level data still loading here" : "No room for more objects");
+        s.messageTimer = 2.0f;
+        return;
+    }
+    if (key == 'r' || key == 'R') {
+        if (!s.gameStarted) { // start the game
+            s.gameStarted = true; s.gameTimer = GAME_DURATION; setStatus(s, "Game started"); s.messageTimer = 1.5f;
+            // ensure powerup state reset when starting
+            s.playerSpeed = s.basePlayerSpeed; s.speedActive = false; s.speedTimer = 0.0f; s.shieldActive = false; s.shieldTimer = 0.0f;
+        }
+        else if (s.gameOver) { // restart fully
+            clearLevel(s); resetToEditing(s); setStatus(s, "Editing mode: place objects"); s.messageTimer = 1.5f;
+        }
+    }
+}
+
+void resetToEditing(GameState& s) {
+    s.selectedTool = TOOL_NONE; s.gameStarted = false; s.gameOver = false; s.gameWin = false; s.score = 0; s.lives = START_LIVES; s.obstacleContact = false; s.playerX = 0; s.playerY = -0.9f;
+    // reset speed/shield
+    s.playerSpeed = s.basePlayerSpeed; s.speedActive = false; s.speedTimer = 0.0f; s.shieldActive = false; s.shieldTimer = 0.0f;
+    // reset game timer as well (editing mode)
+    s.gameTimer = GAME_DURATION;
+    s.cameraGoalY = CAMERA_MIN_Y; // scroll back down to the rocket
+}
+
+// =====================
+// Editor: solvability of the level as placed
+// =====================
+
+static void rebuildSolvability(GameState& s) {
+    SolvabilityMap& m = s.solvability;
+    const float speed = s.basePlayerSpeed * HELD_STEPS_PER_SECOND;
+    // where movePlayer() lets the rocket go, and no higher than a whole round can climb
+    float x0 = WORLD_LEFT + 0.02f, x1 = WORLD_RIGHT - 0.02f;
+    float y0 = WORLD_BOTTOM + UI_BOTTOM_HEIGHT + 0.02f, y1 = s.worldTop - UI_TOP_HEIGHT - 0.02f;
+    y1 = std::min(y1, std::max(s.playerY, y0) + GAME_DURATION * speed + SolvabilityMap::CELL);
+    m.reset(x0, y0, x1, y1, speed);
+    for (int b = chunkBand(y0 - s.chunks.obstacleReach()), last = chunkBand(y1 + s.chunks.obstacleReach());b <= last;++b) {
+        const LevelChunk* ch = s.chunks.at(b);
+        if (!ch) continue;
+        const ObstacleStore& o = ch->obstacles;
+        for (size_t i = 0;i < o.size();++i) m.addBox(o.x[i], o.y[i], o.w[i] + OBSTACLE_MARGIN, o.h[i] + OBSTACLE_MARGIN, 1);
+    }
+    m.setStart(Vec2(s.playerX, s.playerY));
+    // the target passes every point of its track, so reaching the track is enough (the wait is not counted)
+    if (s.targetPath.size()) {
+        const float len = s.targetPath.length(0);
+        for (float d = 0.0f;d < len;d += SolvabilityMap::CELL) m.addGoalDisc(s.targetPath.sample(0, d), TARGET_RADIUS);
+        m.addGoalDisc(s.targetPath.sample(0, len), TARGET_RADIUS);
+    }
+    s.solvabilityChunks = s.chunks.generation();
+}
+
+void updateSolvability(GameState& s) {
+    if (!s.solvability.ready() || s.solvabilityChunks != s.chunks.generation()) rebuildSolvability(s);
+    s.solvability.solve();
+}
+
+// where and how big a hit entity is, for the effect log
+static Obstacle obstacleOf(const GameState& s, const EntityRef& ref) {
+    if (ref.band != MOVING_BAND) return s.chunks.at(ref.band)->obstacles.get(ref.index);
+    const MovingObstacleStore& m = s.motion.obstacles;
+    Obstacle o; o.pos = Vec2(m.motion.x[ref.index], m.motion.y[ref.index]); o.w = m.w[ref.index]; o.h = m.h[ref.index];
+    return o;
+}
+static Vec2 collectiblePos(const GameState& s, const EntityRef& ref) {
+    if (ref.band == MOVING_BAND) return Vec2(s.motion.collectibles.motion.x[ref.index], s.motion.collectibles.motion.y[ref.index]);
+    const CollectibleStore& c = s.chunks.at(ref.band)->collectibles;
+    return Vec2(c.x[ref.index], c.y[ref.index]);
+}
+
+// =====================
+// Round rules (GameCore.h)
+// =====================
+
+void moveRound(RoundState& r, const RoundView& v, float dx, float dy, float steps, bool held, const RoundListener& on) {
+    if (r.gameOver || (dx == 0.0f && dy == 0.0f)) return;
+    const GameState& level = *v.level;
+
+    // normalize movement vector so diagonal isn't faster
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len > 0.0f) { dx /= len; dy /= len; }
+
+    // attempt move
+    float nx = r.playerX + dx * r.playerSpeed * steps;
+    float ny = r.playerY + dy * r.playerSpeed * steps;
+
+    // clamp to the world, keeping clear of the UI panels at either end of the camera's travel
+    float topLimit = level.worldTop - UI_TOP_HEIGHT - 0.02f; float bottomLimit = WORLD_BOTTOM + UI_BOTTOM_HEIGHT + 0.02f;
+    if (nx < WORLD_LEFT + 0.02f) nx = WORLD_LEFT + 0.02f;
+    if (nx > WORLD_RIGHT - 0.02f) nx = WORLD_RIGHT - 0.02f;
+    if (ny > topLimit) ny = topLimit;
+    if (ny < bottomLimit) ny = bottomLimit;
+
+    // streamed levels: hold position rather than fly into chunks that are not loaded yet
+    if (bandsPending(level, std::min(r.playerY, ny), std::max(r.playerY, ny))) return;
+
+    // the whole step is swept, so a long step (speed power-up, low input rate) cannot jump over anything
+    const Vec2 from(r.playerX, r.playerY), to(nx, ny);
+    float t = 0.0f;
+    EntityRef ref = sweepObstacles(v, from, to, t);
+    if (ref.valid()) {
+        if (!r.shieldActive) {
+            // hit obstacle: lose a life (once per held contact) and block motion
+            if (held && r.obstacleContact) return;
+            r.obstacleContact = held;
+            r.lives--; if (r.lives <= 0) { r.gameOver = true; r.gameWin = false; }
+            on(ROUND_HIT);
+            return; // do not move into obstacle
+        }
+        // shield protects: destroy every obstacle on the way and allow movement. A move that breaks
+        // through neither picks anything up nor reaches the target
+        for (;ref.valid();ref = sweepObstacles(v, from, to, t)) { r.score += 5; on(ROUND_OBSTACLE_BROKEN, ref); }
+        on(ROUND_BROKE_THROUGH);
+        r.playerX = nx; r.playerY = ny; // move into position
+        r.obstacleContact = false;
+        on(ROUND_MOVED);
+        return;
+    }
+
+    r.playerX = nx; r.playerY = ny;
+    r.obstacleContact = false;
+    on(ROUND_MOVED);
+    // collect collectibles passed on the way
+    while ((ref = sweepCollectibles(v, from, to, t)).valid()) { r.score += 5; on(ROUND_COLLECTED, ref); }
+    // powerups
+    while ((ref = sweepPowerups(v, from, to, t)).valid()) {
+        if (level.chunks.at(ref.band)->powerups.type[ref.index] == P_SHIELD) { r.shieldActive = true; r.shieldTimer = level.shieldDuration; }
+        else { // activate speed for speedDuration seconds
+            r.speedActive = true;
+            r.speedTimer = level.speedDuration;
+            r.playerSpeed = level.basePlayerSpeed * level.speedMultiplier;
+        }
+        on(ROUND_POWERUP, ref);
+    }
+    // win if the step reaches the target
+    if (sweepCircle(Sweep(from.x, from.y, to.x, to.y), r.targetPos.x, r.targetPos.y, TARGET_RADIUS * TARGET_RADIUS, t)) { r.gameWin = true; r.gameOver = true; }
+}
+
+void tickRound(RoundState& r, const GameState& level, float dt, bool playing, const RoundListener& on) {
+    // target: along its path at constant speed, starting over from the beginning after each pass
+    if (level.targetPath.size()) {
+        const float length = level.targetPath.length(0);
+        r.targetDist += dt * length / TARGET_PASS_SECONDS;
+        if (r.targetDist >= length) r.targetDist -= length * floorf(r.targetDist / length);
+        r.targetPos = level.targetPath.sample(0, r.targetDist);
+    }
+
+    if (playing && !r.gameOver) {
+        // timer
+        r.gameTimer -= dt;
+        if (r.gameTimer <= 0.0f) { // lose unless at target
+            r.gameWin = hypot(r.playerX - r.targetPos.x, r.playerY - r.targetPos.y) < TARGET_RADIUS;
+            r.gameOver = true;
+            on(ROUND_TIME_UP);
+        }
+        // shield timer
+        if (r.shieldActive) { r.shieldTimer -= dt; if (r.shieldTimer <= 0.0f) { r.shieldActive = false; r.shieldTimer = 0.0f; on(ROUND_SHIELD_EXPIRED); } }
+        // speed timer decrement & expiry handling
+        if (r.speedActive) {
+            r.speedTimer -= dt;
+            if (r.speedTimer <= 0.0f) {
+                r.speedActive = false;
+                r.speedTimer = 0.0f;
+                r.playerSpeed = level.basePlayerSpeed;
+                on(ROUND_SPEED_EXPIRED);
+            }
+        }
+    }
+}
+
+// the game's side of the rules: the level itself gives up what the round uses, with messages and effects
+static void gameEvent(void* ctx, RoundEvent e, const EntityRef& ref) {
+    GameState& s = *static_cast<GameState*>(ctx);
+    switch (e) {
+    case ROUND_MOVED: s.lastMoveTime = s.globalTime; break;
+    case ROUND_HIT:
+        setStatus(s, "Hit obstacle! -1 life"); s.messageTimer = 1.5f;
+        s.effects.push(EFFECT_HIT, Vec2(s.playerX, s.playerY));
+        break;
+    case ROUND_OBSTACLE_BROKEN: {
+        Obstacle o = obstacleOf(s, ref);
+        s.effects.push(EFFECT_OBSTACLE_BREAK, o.pos, o.w, o.h);
+        removeObstacle(s, ref);
+        break;
+    }
+    case ROUND_BROKE_THROUGH: setStatus(s, "Shield absorbed obstacle (destroyed)"); s.messageTimer = 1.5f; break;
+    case ROUND_COLLECTED:
+        s.effects.push(EFFECT_COLLECT, collectiblePos(s, ref)); collectCollectible(s, ref);
+        setStatus(s, "Collected +5"); s.messageTimer = 0.9f;
+        break;
+    case ROUND_POWERUP: {
+        PowerUp picked = s.chunks.at(ref.band)->powerups.get(ref.index);
+        removePowerup(s, ref);
+        s.effects.push(picked.type == P_SHIELD ? EFFECT_SHIELD : EFFECT_SPEED, picked.pos);
+        setStatus(s, picked.type == P_SHIELD ? "Shield picked" : "Speed Up!"); s.messageTimer = 1.5f;
+        break;
+    }
+    case ROUND_TIME_UP: s.messageTimer = 3.0f; break;
+    case ROUND_SHIELD_EXPIRED: setStatus(s, "Shield expired"); s.messageTimer = 1.5f; break;
+    case ROUND_SPEED_EXPIRED: setStatus(s, "Speed expired"); s.messageTimer = 1.5f; break;
+    }
+}
+
+static RoundListener gameListener(GameState& s) { RoundListener l; l.event = gameEvent; l.ctx = &s; return l; }
+
+// =====================
+// Player movement: while playing, a move of the round; while editing, up/down scroll the view instead
+// =====================
+static void movePlayer(GameState& s, float dx, float dy, float steps, bool held) {
+    if (s.gameOver) return;
+    if (!s.gameStarted) {
+        s.cameraGoalY = std::min(cameraMaxY(s), std::max(CAMERA_MIN_Y, s.cameraGoalY + dy * CAMERA_SCROLL_STEP * steps));
+        return;
+    }
+    if (dx == 0.0f && dy == 0.0f) return;
+    // face the movement: atan2(dy,dx) gives 0 = right, +90 = up; our rocket points up at angle 0 -> subtract 90 degrees
+    float len = sqrtf(dx * dx + dy * dy);
+    s.playerAngle = atan2f(dy / len, dx / len) * 180.0f / (float)M_PI - 90.0f;
+    moveRound(s, roundView(s), dx, dy, steps, held, gameListener(s));
+}
+
+void applyMove(GameState& s, float dx, float dy) { movePlayer(s, dx, dy, 1.0f, false); }
+
+void applyHeldMove(GameState& s, float dx, float dy, float dt) {
+    if (dx == 0.0f && dy == 0.0f) { s.obstacleContact = false; return; } // letting go ends a contact
+    movePlayer(s, dx, dy, dt * HELD_STEPS_PER_SECOND, true);
+}
+
+// =====================
+// Tick: timers and animations
+// =====================
+Vec2 bezierPoint(const Vec2* ctrl, float t) {
+    Vec2 a = ctrl[0]; Vec2 b = ctrl[1]; Vec2 c = ctrl[2]; Vec2 d = ctrl[3];
+    float u = 1 - t;
+    return Vec2(u * u * u * a.x + 3 * u * u * t * b.x + 3 * u * t * t * c.x + t * t * t * d.x,
+        u * u * u * a.y + 3 * u * u * t * b.y + 3 * u * t * t * c.y + t * t * t * d.y);
+}
+
+// element-wise, so any split gives the same phases; only dense chunks are worth more than one range
+const size_t PHASE_GRAIN = 32768;
+static void advancePhasesParallel(float* phase, size_t n, float delta) {
+    jobSystem().parallelFor(n, PHASE_GRAIN, [=](size_t b, size_t e) { advancePhases(phase + b, e - b, delta); });
+}
+
+static void tick(GameState& s, float dt) {
+    s.globalTime += dt;
+
+    // path followers, wherever they are: they collide, so they move whether or not they are in view. Most
+    // levels have none, and those should not pay for handing empty stores to the job system every tick
+    if (s.motion.obstacles.size()) advanceMovers(s.motion.paths, s.motion.obstacles.motion, dt);
+    if (s.motion.collectibles.size()) {
+        advanceMovers(s.motion.paths, s.motion.collectibles.motion, dt);
+        advancePhasesParallel(s.motion.collectibles.phase.data(), s.motion.collectibles.size(), dt * COLLECTIBLE_PHASE_RATE);
+    }
+
+    // animate collectibles & powerups (phases). Only the chunks under the view: the phases are purely visual,
+    // and chunks out of sight simply resume where they stopped when they scroll back in
+    for (int b = chunkBand(s.cameraY - 1.1f), last = chunkBand(s.cameraY + 1.1f);b <= last;++b) {
+        LevelChunk* ch = s.chunks.at(b);
+        if (!ch) continue;
+        advancePhasesParallel(ch->collectibles.phase.data(), ch->collectibles.size(), dt * COLLECTIBLE_PHASE_RATE);
+        advancePhasesParallel(ch->powerups.phase.data(), ch->powerups.size(), dt * POWERUP_PHASE_RATE);
+    }
+
+    tickRound(s, s, dt, s.gameStarted, gameListener(s));
+
+    if (!s.gameStarted) updateSolvability(s);
+
+    // camera: follow the rocket while playing, ease toward the goal either way
+    if (s.gameStarted) s.cameraGoalY = std::min(cameraMaxY(s), std::max(CAMERA_MIN_Y, s.playerY - CAMERA_PLAYER_SCREEN_Y));
+    s.cameraY += (s.cameraGoalY - s.cameraY) * std::min(1.0f, dt * CAMERA_FOLLOW_RATE);
+
+    // message timer
+    if (s.messageTimer > 0.0f) s.messageTimer -= dt;
+}
+
+void step(GameState& s, const Inputs& inputs, float dt) {
+    for (size_t i = 0;i < inputs.count;++i) {
+        const InputEvent& e = inputs.events[i];
+        switch (e.type) {
+        case INPUT_MOVE:  applyMove(s, e.dx, e.dy); break;
+        case INPUT_KEY:   applyKey(s, e.key); break;
+        case INPUT_CLICK: applyClick(s, e.pos); break;
+        }
+    }
+    applyHeldMove(s, inputs.moveX, inputs.moveY, dt);
+    tick(s, dt);
+}
+
+// =====================
+// Initialization
+// =====================
+void initGame(GameState& s, uint32_t seed) {
+    s.rngState = seed ? seed : 0x9E3779B9u; // xorshift must not start at zero
+    // prepare bezier control points for the target near the top of the world (the camera scrolls up to it)
+    float left = -0.6f, right = 0.6f, y = WORLD_TOP - 0.3f;
+    const Vec2 target[4] = { Vec2(left, y), Vec2(-0.2f, y + 0.3f), Vec2(0.2f, y - 0.3f), Vec2(right, y) };
+    setTargetPath(s, target);
+    s.cameraY = s.cameraGoalY = CAMERA_MIN_Y;
+    // clear editor arrays
+    clearLevel(s); s.selectedTool = TOOL_NONE; s.placeMoving = false;
+    s.playerX = 0; s.playerY = -0.9f; s.score = 0; s.lives = START_LIVES; s.obstacleContact = false; s.gameStarted = false; s.gameOver = false; s.shieldActive = false; s.shieldTimer = 0.0f; setStatus(s, "Editing mode: place objects"); s.messageTimer = 2.0f;
+    // reset player speed state
+    s.playerSpeed = s.basePlayerSpeed; s.speedActive = false; s.speedTimer = 0.0f;
+    s.gameTimer = GAME_DURATION;
+}
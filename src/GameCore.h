@@ -0,0 +1,316 @@
+#pragma once
+
+// =====================
+// Headless simulation core: all game state lives in GameState and advances through step().
+// Nothing in here touches GLUT or GL, so the simulation can run without a window.
+// =====================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EntityStore.h"
+#include "LevelChunk.h"
+#include "PathSystem.h"
+#include "Solvability.h"
+#include "Vec2.h"
+
+// =====================
+// Data structures (entity value types and their SoA stores are in EntityStore.h, chunks in LevelChunk.h)
+// =====================
+// placement tools
+enum Tool { TOOL_NONE = 0, TOOL_OBSTACLE, TOOL_COLLECTIBLE, TOOL_P_SHIELD, TOOL_P_SPEED };
+
+// UI and world extents
+const float UI_TOP_HEIGHT = 0.12f;   // normalized screen units for panels
+const float UI_BOTTOM_HEIGHT = 0.10f;
+const float WORLD_LEFT = -1.0f, WORLD_RIGHT = 1.0f;
+const float WORLD_BOTTOM = -1.0f, WORLD_TOP = 3.0f; // taller world; a loaded level may set its own top (GameState::worldTop)
+
+// level chunks: band b holds the entities whose centre y lies in [WORLD_BOTTOM + b * CHUNK_HEIGHT, + CHUNK_HEIGHT)
+const float CHUNK_HEIGHT = 4.0f; // the default world is exactly one chunk
+inline int chunkBand(float y) { float b = floorf((y - WORLD_BOTTOM) / CHUNK_HEIGHT); return b > 0.0f ? (int)b : 0; }
+
+// bottom tool panel layout (shared by the click handling here and the panel drawing in the front end)
+const float TOOL_PANEL_START_X = -0.8f;
+const float TOOL_PANEL_GAP = 0.45f;
+
+const float GAME_DURATION = 30.0f; // seconds per round
+
+// editor placement: object centres stay at least this far apart (tooCloseToExisting)
+const float PLACEMENT_SPACING = 0.08f;
+
+// camera: vertical scrolling only, the view is always the full world width. cameraY is the world y at the
+// centre of the screen, so world = screen + (0, cameraY); it stays within [CAMERA_MIN_Y, cameraMaxY()].
+const float CAMERA_MIN_Y = WORLD_BOTTOM + 1.0f;
+const float CAMERA_PLAYER_SCREEN_Y = -0.4f; // where the camera holds the rocket while playing
+const float CAMERA_FOLLOW_RATE = 6.0f;      // per second; the camera closes this fraction of the gap (capped at 1) each second
+const float CAMERA_SCROLL_STEP = 0.25f;     // editor scroll per movement step
+
+// held arrow keys move this many steps (playerSpeed, or CAMERA_SCROLL_STEP while editing) per second,
+// about the rate a keyboard's auto-repeat used to give
+const float HELD_STEPS_PER_SECOND = 30.0f;
+
+// animation phase speeds (radians per second)
+const float COLLECTIBLE_PHASE_RATE = 2.0f;
+const float POWERUP_PHASE_RATE = 1.5f;
+
+// moving objects placed in the editor (M toggles) patrol a small loop around where they were placed
+const float PATROL_SPEED = 0.25f;       // world units per second along the loop
+const float TARGET_PASS_SECONDS = 8.0f; // the target takes this long per pass along its path
+const int START_LIVES = 5;
+
+// hit distances: the rocket's half size, added to obstacle boxes by the hit tests (and by the solvability grid);
+// the radius within which it takes a collectible or power-up; and the distance to the target that wins
+const float OBSTACLE_MARGIN = 0.04f;
+const float PICKUP_RADIUS = 0.07f;
+const float TARGET_RADIUS = 0.12f;
+
+// effects worth a particle burst, logged by the simulation for the renderer (src/Particles.h). The log keeps
+// the last EFFECT_RING events and a running total, so a reader that skips ticks (the render thread only takes
+// the newest snapshot) still sees every event as long as fewer than EFFECT_RING arrive in between.
+enum EffectType : uint8_t { EFFECT_OBSTACLE_BREAK = 0, EFFECT_COLLECT, EFFECT_SHIELD, EFFECT_SPEED, EFFECT_HIT };
+struct EffectEvent { EffectType type = EFFECT_HIT; Vec2 pos; float w = 0.0f, h = 0.0f; };
+const int EFFECT_RING = 64;
+struct EffectLog {
+    EffectEvent ring[EFFECT_RING];
+    uint64_t total = 0; // events ever logged; event k is in ring[k % EFFECT_RING] while k >= total - EFFECT_RING
+    void push(EffectType type, const Vec2& pos, float w = 0.0f, float h = 0.0f) { EffectEvent& e = ring[total++ % EFFECT_RING]; e.type = type; e.pos = pos; e.w = w; e.h = h; }
+};
+
+// =====================
+// Round state: what one play of a level changes. GameState is a round over the level it holds; VecEnv
+// (VecEnv.h) keeps many rounds over one shared level. Both advance them with the round rules below.
+// =====================
+struct RoundState {
+    float playerX = 0.0f, playerY = -0.9f;
+    float playerSpeed = 0.05f;
+    int score = 0;
+    int lives = START_LIVES;
+    float gameTimer = GAME_DURATION;
+    bool gameOver = false;
+    bool gameWin = false;
+
+    // powerup active state
+    bool shieldActive = false;
+    float shieldTimer = 0.0f; // seconds remaining
+    bool speedActive = false;
+    float speedTimer = 0.0f;
+    bool obstacleContact = false; // held movement is pushing against an obstacle; costs a life once, not every tick
+
+    // the target, along GameState::targetPath
+    Vec2 targetPos = Vec2(0.0f, 0.7f);
+    float targetDist = 0.0f; // in [0, length)
+};
+
+// =====================
+// Game state: the round (RoundState), the level it is played on, and what only the editor and front end use
+// =====================
+struct GameState : RoundState {
+    float playerAngle = 0.0f; // rotation to face movement
+    bool gameStarted = false; // editing mode initially
+
+    // level entities, one chunk per band of the world; edit them through addObstacle()/removeObstacle() etc.
+    // so each chunk's spatial grids stay in sync. Only resident chunks are in the table.
+    ChunkTable chunks;
+    float worldTop = WORLD_TOP;
+    // entities that follow paths. They are few enough to keep resident and scan whole, and they cross chunk
+    // boundaries as they move, so they live outside the chunks; positions are recomputed every tick.
+    LevelMotion motion;
+    int patrolPath = -1;      // motion.paths id of the editor's patrol loop, once one has been placed
+    bool placeMoving = false; // editor: new obstacles and collectibles patrol instead of staying put
+    // editor: fastest route from the rocket to the target's track at base speed, kept current by updateSolvability()
+    SolvabilityMap solvability;
+    uint64_t solvabilityChunks = 0; // chunks.generation() the map was built from
+
+    Tool selectedTool = TOOL_NONE;
+
+    // powerup tuning
+    float shieldDuration = 5.0f;
+    float speedDuration = 5.0f; // speed lasts this many seconds
+    float basePlayerSpeed = 0.05f;
+    float speedMultiplier = 1.8f; // how much faster when speed powerup active
+
+    // animations
+    float globalTime = 0.0f;
+    float lastMoveTime = -100.0f; // used to show brief thruster flame when player recently moved
+
+    // camera: cameraY eases toward cameraGoalY (the rocket while playing, arrow-key scrolling while editing)
+    float cameraY = 0.0f, cameraGoalY = 0.0f;
+
+    // target movement: along a cubic Bezier at constant speed, restarting at its start after each pass (set through
+    // setTargetPath()); where it is now is part of the round
+    std::vector<Vec2> targetBezier;  // the four control points, as saved
+    PathSet targetPath;
+
+    // UI messages: a fixed buffer (set through setStatus()), so showing one never allocates
+    char statusMessage[96] = "Place objects then press R to start";
+    float messageTimer = 0.0f;
+    EffectLog effects; // never reset, so a reader's position stays valid across rounds
+
+    // private RNG so a run is reproducible from its seed
+    uint32_t rngState = 1u;
+};
+
+// =====================
+// Inputs: everything the front end can feed into a tick
+// =====================
+enum InputType {
+    INPUT_MOVE = 0, // one movement step in direction (dx, dy) (scripts; the keyboard drives Inputs::moveX/moveY)
+    INPUT_KEY,      // plain keyboard key
+    INPUT_CLICK     // left click at a screen position in [-1, 1]^2 (tool panel, or placement through the camera)
+};
+
+struct InputEvent {
+    InputType type = INPUT_KEY;
+    float dx = 0.0f, dy = 0.0f; // INPUT_MOVE
+    unsigned char key = 0;      // INPUT_KEY
+    Vec2 pos;                   // INPUT_CLICK, screen coordinates
+};
+
+inline InputEvent moveInput(float dx, float dy) { InputEvent e; e.type = INPUT_MOVE; e.dx = dx; e.dy = dy; return e; }
+inline InputEvent keyInput(unsigned char key) { InputEvent e; e.type = INPUT_KEY; e.key = key; return e; }
+inline InputEvent clickInput(const Vec2& pos) { InputEvent e; e.type = INPUT_CLICK; e.pos = pos; return e; }
+
+struct Inputs {
+    const InputEvent* events = nullptr;
+    size_t count = 0;
+    // held movement direction for this tick (arrow keys: -1, 0 or 1 per axis); moves dt * HELD_STEPS_PER_SECOND steps
+    float moveX = 0.0f, moveY = 0.0f;
+};
+
+// an entity in a chunk: band and index within that chunk's store; band MOVING_BAND indexes GameState::motion's stores
+const int MOVING_BAND = -2;
+struct EntityRef {
+    int band = -1, index = -1;
+    bool valid() const { return index >= 0; }
+};
+
+// =====================
+// Simulation API
+// =====================
+
+// resets the level to an empty editor session; the seed drives every random choice the simulation makes
+void initGame(GameState& s, uint32_t seed);
+
+// applies the input events in order, then the held movement, then advances timers and animations by dt seconds
+void step(GameState& s, const Inputs& inputs, float dt);
+
+// individual input handlers (step() dispatches to these)
+void applyMove(GameState& s, float dx, float dy);
+void applyHeldMove(GameState& s, float dx, float dy, float dt);
+void applyKey(GameState& s, unsigned char key);
+void applyClick(GameState& s, const Vec2& screen);
+
+// level editing: entities go to the chunk of their band (created if needed) and into its spatial grids.
+// Removal swaps the chunk's last entity into the freed slot, so indices past the removed one are not stable.
+void addObstacle(GameState& s, const Obstacle& o);
+void addCollectible(GameState& s, const Collectible& c);
+void addPowerup(GameState& s, const PowerUp& p);
+// many at once (generated levels): the same as adding them one by one, but each chunk they land in has its
+// grids rebuilt once in bulk instead of taking an insert per entity
+void addEntities(GameState& s, const std::vector<Obstacle>& obstacles, const std::vector<Collectible>& collectibles, const std::vector<PowerUp>& powerups);
+void removeObstacle(GameState& s, const EntityRef& ref);
+void removePowerup(GameState& s, const EntityRef& ref);
+// path followers, placed at their starting distance; path is an id in s.motion.paths
+void addMovingObstacle(GameState& s, int path, const Vec2& origin, float dist, float speed, float w, float h);
+void addMovingCollectible(GameState& s, int path, const Vec2& origin, float dist, float speed, float phase);
+// drops every chunk and moving entity and returns to the default world height
+void clearLevel(GameState& s);
+// the target's four Bezier control points; it restarts from the first
+void setTargetPath(GameState& s, const Vec2* ctrl);
+// back to editing mode with a fresh round (score, lives, timers, player position); the level is kept
+void resetToEditing(GameState& s);
+// brings s.solvability up to date (runs every editing tick): rebuilt when chunks come or go or the level or
+// target changes, repaired incrementally after placements. Static obstacles only; path followers move on.
+void updateSolvability(GameState& s);
+
+// chunks with up to this many entities of a kind are hit-tested with a linear SIMD scan instead of the grid
+const size_t SMALL_LEVEL_SCAN = 256;
+
+// queries and helpers
+float randf(GameState& s, float a, float b);
+// printf-style status message, cut to fit GameState::statusMessage; the caller sets messageTimer
+void setStatus(GameState& s, const char* fmt, ...);
+// screen position (as clicked) to world position through the current camera
+inline Vec2 screenToWorld(const GameState& s, const Vec2& screen) { return Vec2(screen.x, screen.y + s.cameraY); }
+inline float cameraMaxY(const GameState& s) { return s.worldTop - 1.0f; }
+// the click is clear of the UI panels on screen and inside the world extent
+bool pointInsideGameArea(const GameState& s, const Vec2& screen, const Vec2& world);
+// true while some band within reach of [y0, y1] exists on disk but is not resident (streaming)
+bool bandsPending(const GameState& s, float y0, float y1);
+// cubic Bezier through the four control points at t in [0, 1] (direct evaluation; the target itself moves by arc length)
+Vec2 bezierPoint(const Vec2* ctrl, float t);
+bool tooCloseToExisting(const GameState& s, const Vec2& p, float minDist);
+// hit tests over the resident chunks; the lowest (band, index) wins
+EntityRef obstacleAt(const GameState& s, float nx, float ny);
+bool collidesWithObstacle(const GameState& s, float nx, float ny);
+int collectAt(GameState& s, float nx, float ny);
+int powerupAt(GameState& s, float nx, float ny, PowerUp& out, EntityRef& ref);
+// swept hit tests for a move from a to b (hit rules in EntityKernels.h): the earliest hit along the move and
+// its t in [0, 1); ties go to the lowest (band, index), then to moving entities. The pickups count only active
+// entities.
+EntityRef sweepObstacles(const GameState& s, const Vec2& a, const Vec2& b, float& t);
+EntityRef sweepCollectibles(const GameState& s, const Vec2& a, const Vec2& b, float& t);
+EntityRef sweepPowerups(const GameState& s, const Vec2& a, const Vec2& b, float& t);
+// deactivates a collectible (it stays in its store, out of the grid)
+void collectCollectible(GameState& s, const EntityRef& ref);
+
+// =====================
+// Round rules: a move and a tick of a started round, shared by step() and VecEnv so the two agree bit for
+// bit. They see the level through a RoundView and report what happens to a RoundListener. Taking a used-up
+// entity out of the view is the listener's job, as is everything only the front end sees (messages, effects).
+// =====================
+
+// A round's view of its level: the entities still in play and where the path followers are. Masks have a bit
+// per entity, set while it is in play, and a null mask counts every entity in the store. Without bits, the view
+// is a GameState's own round (roundView()): destroyed obstacles have left their stores, the pickups' active
+// bits are their masks, and the followers are where advanceMovers() put them. VecEnv points bits at one
+// instance's copy, with each store's first word in it (per band for the chunks) and the instance's followers.
+struct RoundView {
+    const GameState* level = nullptr;
+    const uint64_t* bits = nullptr;
+    const uint32_t* obstacleRun = nullptr; const uint32_t* collectibleRun = nullptr; const uint32_t* powerupRun = nullptr;
+    uint32_t movingObstacleRun = 0, movingCollectibleRun = 0;
+    const float* movingObstacleX = nullptr; const float* movingObstacleY = nullptr;
+    const float* movingCollectibleX = nullptr; const float* movingCollectibleY = nullptr;
+
+    const uint64_t* obstacles(const LevelChunk& ch) const { return bits ? bits + obstacleRun[ch.band] : nullptr; }
+    const uint64_t* collectibles(const LevelChunk& ch) const { return bits ? bits + collectibleRun[ch.band] : ch.collectibles.active.words(); }
+    const uint64_t* powerups(const LevelChunk& ch) const { return bits ? bits + powerupRun[ch.band] : ch.powerups.active.words(); }
+    const uint64_t* movingObstacles() const { return bits ? bits + movingObstacleRun : nullptr; }
+    const uint64_t* movingCollectibles() const { return bits ? bits + movingCollectibleRun : level->motion.collectibles.active.words(); }
+};
+RoundView roundView(const GameState& s);
+
+enum RoundEvent {
+    ROUND_MOVED,           // the rocket moved (possibly not at all, against the edge of the world)
+    ROUND_HIT,             // it ran into an obstacle without a shield; a life is gone
+    ROUND_OBSTACLE_BROKEN, // the shield destroyed obstacle ref (5 points): take it out of the view
+    ROUND_BROKE_THROUGH,   // the shield cleared the way; the rocket moves, and takes nothing else this move
+    ROUND_COLLECTED,       // collectible ref (5 points): take it out of the view
+    ROUND_POWERUP,         // power-up ref, already in effect: take it out of the view
+    ROUND_TIME_UP,         // the round ended on the timer (gameWin: on the target)
+    ROUND_SHIELD_EXPIRED,
+    ROUND_SPEED_EXPIRED
+};
+struct RoundListener {
+    void (*event)(void* ctx, RoundEvent e, const EntityRef& ref) = nullptr;
+    void* ctx = nullptr;
+    void operator()(RoundEvent e, const EntityRef& ref = EntityRef()) const { if (event) event(ctx, e, ref); }
+};
+
+// steps steps of the rocket's speed in direction (dx, dy), swept against everything in the view. held marks
+// movement from held keys, which repeats every tick, so staying pressed against an obstacle costs a life only
+// when the contact begins. Nothing happens once the round is over or while bands on the way are pending.
+void moveRound(RoundState& r, const RoundView& v, float dx, float dy, float steps, bool held, const RoundListener& on);
+// the target's motion always; the round's timers while playing
+void tickRound(RoundState& r, const GameState& level, float dt, bool playing, const RoundListener& on);
+
+// the queries the rules use, through a view: sweeps as above, and whether (nx, ny) is inside a chunk obstacle
+EntityRef sweepObstacles(const RoundView& v, const Vec2& a, const Vec2& b, float& t);
+EntityRef sweepCollectibles(const RoundView& v, const Vec2& a, const Vec2& b, float& t);
+EntityRef sweepPowerups(const RoundView& v, const Vec2& a, const Vec2& b, float& t);
+bool collidesWithObstacle(const RoundView& v, float nx, float ny);
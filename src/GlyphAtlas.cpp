@@ -0,0 +1,64 @@
+#include "GlyphAtlas.h"
+
+#include <cmath>
+
+#include "FontData.h"
+
+static const int ATLAS_COLUMNS = 16;
+
+GlyphAtlas::GlyphAtlas() {
+    const int cell = FONT_CELL_HEIGHT; // glyphs are at most 16 px wide, so cells are square
+    int rows = (FONT_CHAR_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    atlasW = ATLAS_COLUMNS * cell; atlasH = rows * cell;
+    alpha.assign((size_t)atlasW * atlasH, 0);
+    glyphs.resize(FONT_CHAR_COUNT);
+
+    for (int g = 0;g < FONT_CHAR_COUNT;++g) {
+        int x0 = (g % ATLAS_COLUMNS) * cell, y0 = (g / ATLAS_COLUMNS) * cell;
+        for (int row = 0;row < cell;++row)
+            for (int col = 0;col < cell;++col)
+                if (FONT_ROWS[g][row] & (0x8000 >> col)) alpha[(size_t)(y0 + row) * atlasW + x0 + col] = 255;
+        GlyphInfo& info = glyphs[g];
+        info.advance = FONT_ADVANCE[g];
+        info.u0 = (float)x0 / atlasW; info.u1 = (float)(x0 + info.advance) / atlasW;
+        info.v0 = (float)y0 / atlasH; info.v1 = (float)(y0 + cell) / atlasH;
+    }
+}
+
+const GlyphInfo& GlyphAtlas::glyph(char c) const {
+    int g = (unsigned char)c - FONT_FIRST_CHAR;
+    if (g < 0 || g >= FONT_CHAR_COUNT) g = '?' - FONT_FIRST_CHAR;
+    return glyphs[g];
+}
+
+void GlyphAtlas::layoutText(DrawList& dl, int viewportW, int viewportH) const {
+    const std::vector<char>& chars = dl.textChars();
+    const float sx = 2.0f / viewportW, sy = 2.0f / viewportH;
+    const float halfW = viewportW * 0.5f, halfH = viewportH * 0.5f;
+    for (const DrawText& t : dl.texts()) {
+        std::vector<TextVertex>& out = dl.glyphVertices(t.layer);
+        // raster position in window pixels, computed the way the GL viewport transform does (strings
+        // often sit on exact pixel edges); like glBitmap, the glyph box starts at floor(raster - origin)
+        float rx = t.x * halfW + halfW;
+        float ry = t.y * halfH + halfH;
+        float py = std::floor(ry - FONT_BASELINE);
+        float y0 = py * sy - 1.0f, y1 = (py + FONT_CELL_HEIGHT) * sy - 1.0f;
+        for (uint32_t i = 0;i < t.count;++i) {
+            const GlyphInfo& g = glyph(chars[t.first + i]);
+            float px = std::floor(rx);
+            float x0 = px * sx - 1.0f, x1 = (px + g.advance) * sx - 1.0f;
+            TextVertex a = { x0, y0, g.u0, g.v0, t.r, t.g, t.b, t.a };
+            TextVertex b = { x1, y0, g.u1, g.v0, t.r, t.g, t.b, t.a };
+            TextVertex c = { x1, y1, g.u1, g.v1, t.r, t.g, t.b, t.a };
+            TextVertex d = { x0, y1, g.u0, g.v1, t.r, t.g, t.b, t.a };
+            out.push_back(a); out.push_back(b); out.push_back(c);
+            out.push_back(a); out.push_back(c); out.push_back(d);
+            rx += g.advance;
+        }
+    }
+}
+
+const GlyphAtlas& glyphAtlas() {
+    static const GlyphAtlas atlas;
+    return atlas;
+}
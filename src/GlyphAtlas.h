@@ -0,0 +1,38 @@
+#pragma once
+
+// =====================
+// Glyph atlas for the embedded Helvetica 12 bitmap font (FontData.h). Holds the atlas pixels for the
+// renderer to upload once, and lays queued DrawList text out as textured quads, one quad per glyph,
+// so every string of a layer ends up in a single batch. Pixel placement follows glBitmap rules, so
+// the result matches what glutBitmapCharacter drew.
+// =====================
+
+#include <cstdint>
+#include <vector>
+
+#include "DrawList.h"
+
+struct GlyphInfo { int advance; float u0, v0, u1, v1; };
+
+class GlyphAtlas {
+public:
+    GlyphAtlas();
+
+    int width() const { return atlasW; }
+    int height() const { return atlasH; }
+    // one alpha byte per texel, bottom row first (GL texture order)
+    const std::vector<uint8_t>& pixels() const { return alpha; }
+
+    const GlyphInfo& glyph(char c) const;
+
+    // fills dl's per-layer glyph vertices from its queued text for a viewport of the given pixel size
+    void layoutText(DrawList& dl, int viewportW, int viewportH) const;
+
+private:
+    int atlasW = 0, atlasH = 0;
+    std::vector<uint8_t> alpha;
+    std::vector<GlyphInfo> glyphs;
+};
+
+// process-wide atlas (thread-safe lazy construction)
+const GlyphAtlas& glyphAtlas();
@@ -0,0 +1,45 @@
+#include "GLFunctions.h"
+
+#include "GpuTimer.h"
+
+bool GpuTimer::init() {
+    ok = loadTimerQueries();
+    if (ok) glGenQueries(RING, queries);
+    return ok;
+}
+
+void GpuTimer::begin(ProfileZone zone) {
+    if (!ok || open >= 0) return;
+    if (pending[next]) collect();
+    if (pending[next]) return; // ring full of unfinished queries: skip this sample rather than stall
+    zones[next] = zone; startUs[next] = profiler().nowUs();
+    glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+    open = next;
+}
+
+void GpuTimer::end() {
+    if (open < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[open] = true;
+    next = (open + 1) % RING;
+    open = -1;
+}
+
+void GpuTimer::collect() {
+    if (!ok) return;
+    // oldest first, stopping at the first query the GPU hasn't finished
+    for (int i = 0;i < RING;++i) {
+        int q = (next + i) % RING;
+        if (!pending[q] || q == open) continue;
+        GLint ready = 0;
+        glGetQueryObjectiv(queries[q], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready) break;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[q], GL_QUERY_RESULT, &ns);
+        pending[q] = false;
+        // some drivers (llvmpipe) answer the context's first query with a raw timestamp; a frame's draws
+        // never take a whole second, so such results are dropped
+        if (ns > 1000000000ull) continue;
+        profiler().addSample(zones[q], ns * 1e-6, startUs[q], TRACE_GPU);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// =====================
+// GPU zone timing with GL_TIME_ELAPSED queries. Results are read back a few frames later without
+// stalling (a small ring of query objects) and fed to profiler() as samples on the trace's GPU track.
+// Only one zone can be open at a time, as GL allows one elapsed-time query per target.
+// =====================
+
+#include "Profiler.h"
+
+class GpuTimer {
+public:
+    // call once with the GL context current; false when the driver has no timer queries
+    bool init();
+    bool available() const { return ok; }
+
+    void begin(ProfileZone zone);
+    void end();
+    // hands every finished query to the profiler
+    void collect();
+
+private:
+    static const int RING = 8;
+
+    unsigned int queries[RING] = {};
+    ProfileZone zones[RING] = {};
+    double startUs[RING] = {}; // CPU time the zone was issued, used to place it in the trace
+    bool pending[RING] = {};
+    int next = 0;
+    int open = -1;
+    bool ok = false;
+};
@@ -0,0 +1,125 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+thread_local bool JobSystem::insideJob = false;
+
+JobSystem::JobSystem(int threads) {
+    if (threads <= 0) threads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int i = 0;i < threads;++i) queues.emplace_back(new Queue());
+    for (int i = 0;i + 1 < threads;++i) workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+JobSystem::~JobSystem() {
+    { std::lock_guard<std::mutex> lock(sleepMutex); quit = true; }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+// =====================
+// Queues
+// =====================
+
+void JobSystem::push(int queue, const Range& r) {
+    { std::lock_guard<std::mutex> lock(queues[queue]->mutex); queues[queue]->ranges.push_back(r); }
+    queued.fetch_add(1);
+    { std::lock_guard<std::mutex> lock(sleepMutex); } // a worker between its check and its wait sees the count
+    wake.notify_one();
+}
+
+bool JobSystem::pop(int queue, Range& out, const Batch* only) {
+    Queue& q = *queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    for (size_t k = q.ranges.size();k-- > 0;) {
+        if (only && q.ranges[k].batch != only) continue;
+        out = q.ranges[k]; q.ranges.erase(q.ranges.begin() + k);
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::steal(int thief, Range& out, const Batch* only) {
+    const int n = (int)queues.size();
+    for (int k = 1;k < n;++k) {
+        Queue& q = *queues[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        for (size_t j = 0;j < q.ranges.size();++j) {
+            if (only && q.ranges[j].batch != only) continue;
+            out = q.ranges[j]; q.ranges.erase(q.ranges.begin() + j);
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// =====================
+// Execution
+// =====================
+
+void JobSystem::execute(int queue, Range r) {
+    Batch& batch = *r.batch;
+    const size_t grain = batch.grain;
+    // split down to one grain, leaving the upper halves for thieves; r.begin is always a multiple of grain
+    while (r.end - r.begin > grain) {
+        size_t chunks = (r.end - r.begin + grain - 1) / grain;
+        size_t mid = r.begin + chunks / 2 * grain;
+        push(queue, Range{ r.batch, mid, r.end });
+        r.end = mid;
+    }
+    bool outer = insideJob;
+    insideJob = true;
+    batch.call(batch.ctx, r.begin, r.end);
+    insideJob = outer;
+    batch.remaining.fetch_sub(r.end - r.begin, std::memory_order_acq_rel); // the batch may be gone after this
+}
+
+void JobSystem::workerLoop(int self) {
+    for (;;) {
+        Range r;
+        if (pop(self, r) || steal(self, r)) { execute(self, r); continue; }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return quit || queued.load() > 0; });
+        if (quit && queued.load() == 0) return;
+    }
+}
+
+void JobSystem::run(Batch& batch, size_t n) {
+    const int mine = (int)queues.size() - 1; // the callers' queue
+    push(mine, Range{ &batch, 0, n });
+    // another caller's ranges may sit in the same queue: leave them to it and the workers
+    while (batch.remaining.load(std::memory_order_acquire) != 0) {
+        Range r;
+        if (pop(mine, r, &batch) || steal(mine, r, &batch)) execute(mine, r);
+        else std::this_thread::yield(); // the last ranges are running on workers
+    }
+}
+
+// =====================
+// Process-wide pool
+// =====================
+
+// Callers read the pool through an atomic pointer, so a parallelFor call site costs one load; the mutex
+// only serializes creating and replacing it.
+static std::mutex poolMutex;
+static std::unique_ptr<JobSystem> pool;
+static std::atomic<JobSystem*> poolPtr{nullptr};
+
+JobSystem& jobSystem() {
+    if (JobSystem* js = poolPtr.load(std::memory_order_acquire)) return *js;
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (!pool) {
+        pool.reset(new JobSystem(0));
+        poolPtr.store(pool.get(), std::memory_order_release);
+    }
+    return *pool;
+}
+
+void setJobThreads(int threads) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    poolPtr.store(nullptr, std::memory_order_release);
+    pool.reset(); // joins the old workers first
+    pool.reset(new JobSystem(threads));
+    poolPtr.store(pool.get(), std::memory_order_release);
+}
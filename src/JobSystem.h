@@ -0,0 +1,82 @@
+#pragma once
+
+// =====================
+// Work-stealing thread pool with a parallel for. parallelFor(n, grain, fn) cuts [0, n) into ranges of
+// grain elements at fixed boundaries (k * grain) and calls fn(begin, end) once per range. Which thread runs
+// a range varies from run to run, but the ranges themselves never do, so code that writes only its own
+// range's outputs (or a per-range slot, begin / grain) and combines slots in order gets bit-identical
+// results for any thread count.
+//
+// Each worker owns a deque of ranges. A worker splits its range in half at a grain boundary, keeps the
+// lower half and pushes the upper one; idle workers steal from the other end of someone else's deque, so
+// they take the biggest pieces and the owner keeps working on cache-warm data. The calling thread takes
+// part until its own parallelFor is complete, but only in ranges of that parallelFor: several threads (the
+// simulation and the render thread) may call at once, and none of them waits on another's work.
+// =====================
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+public:
+    // threads counts the caller: 1 runs everything inline, 0 picks the hardware thread count
+    explicit JobSystem(int threads = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int threadCount() const { return (int)workers.size() + 1; }
+
+    // fn(begin, end) over [0, n) in ranges of grain; returns when every range has run. A parallelFor
+    // issued from inside a range runs inline on that thread.
+    template <class F>
+    void parallelFor(size_t n, size_t grain, F&& fn) {
+        if (grain == 0) grain = 1;
+        if (workers.empty() || n <= grain || insideJob) {
+            for (size_t b = 0;b < n;b += grain) fn(b, b + grain < n ? b + grain : n);
+            return;
+        }
+        Batch batch;
+        batch.call = [](void* ctx, size_t b, size_t e) { (*static_cast<F*>(ctx))(b, e); };
+        batch.ctx = &fn; batch.grain = grain; batch.remaining = n;
+        run(batch, n);
+    }
+
+private:
+    struct Batch {
+        void (*call)(void*, size_t, size_t);
+        void* ctx;
+        size_t grain;
+        std::atomic<size_t> remaining; // elements not yet processed
+    };
+    struct Range { Batch* batch; size_t begin, end; };
+    struct Queue { std::mutex mutex; std::deque<Range> ranges; };
+
+    void run(Batch& batch, size_t n);
+    void workerLoop(int self);
+    void push(int queue, const Range& r);
+    // own end (newest) of queue, or far end (oldest) of another queue; with only set, just ranges of that batch
+    bool pop(int queue, Range& out, const Batch* only = nullptr);
+    bool steal(int thief, Range& out, const Batch* only = nullptr);
+    void execute(int queue, Range r);
+
+    std::vector<std::unique_ptr<Queue>> queues; // one per worker, the last one shared by callers
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{ 0 };
+    bool quit = false;
+
+    static thread_local bool insideJob;
+};
+
+// process-wide pool used by the simulation and scene code; created on first use
+JobSystem& jobSystem();
+// replaces the process-wide pool (0 = hardware threads); only while nothing is running on it
+void setJobThreads(int threads);
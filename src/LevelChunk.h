@@ -0,0 +1,100 @@
+#pragma once
+
+// =====================
+// Level chunks. The world is cut into horizontal bands CHUNK_HEIGHT tall (see chunkBand() in GameCore.h);
+// a LevelChunk holds the entities whose centre lies in one band, with its own SoA stores and spatial
+// grids, and is the unit of saving, loading and streaming. The simulation and the renderer only ever
+// see the chunks that are resident in the GameState's ChunkTable.
+// =====================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "EntityStore.h"
+#include "SpatialGrid.h"
+
+struct LevelChunk {
+    int band = 0;
+    ObstacleStore obstacles;
+    CollectibleStore collectibles;
+    PowerupStore powerups;
+    SpatialGrid obstacleGrid, collectibleGrid, powerupGrid;
+    float obstacleReach = 0.0f; // largest obstacle half-extent plus the collision margin
+    bool dirty = false;         // edited since it was loaded (a streamed chunk must then be written back)
+
+    size_t entityCount() const { return obstacles.size() + collectibles.size() + powerups.size(); }
+    // approximate footprint, heap and mapped alike (the streaming budget counts both)
+    size_t memoryBytes() const {
+        return sizeof(LevelChunk) + obstacles.size() * 16 + collectibles.size() * 12 + powerups.size() * 13 + (collectibles.size() + powerups.size()) / 8 +
+               obstacleGrid.memoryBytes() + collectibleGrid.memoryBytes() + powerupGrid.memoryBytes();
+    }
+};
+
+// band-indexed chunk slots. A slot is empty when its band has no entities or, while streaming, when the
+// band is not resident; pending() marks the latter so the simulation can keep away from missing data.
+// Copies are deep, so a copied GameState never shares chunks.
+class ChunkTable {
+public:
+    ChunkTable() {}
+    ChunkTable(const ChunkTable& o) : pendingBands(o.pendingBands), maxReach(o.maxReach), gen(o.gen) {
+        slots.resize(o.slots.size());
+        for (size_t i = 0;i < slots.size();++i) if (o.slots[i]) slots[i].reset(new LevelChunk(*o.slots[i]));
+    }
+    ChunkTable& operator=(const ChunkTable& o) { if (this != &o) { ChunkTable t(o); *this = std::move(t); } return *this; }
+    ChunkTable(ChunkTable&&) = default;
+    ChunkTable& operator=(ChunkTable&&) = default;
+
+    int bandCount() const { return (int)slots.size(); }
+    LevelChunk* at(int band) { return band >= 0 && band < (int)slots.size() ? slots[band].get() : nullptr; }
+    const LevelChunk* at(int band) const { return band >= 0 && band < (int)slots.size() ? slots[band].get() : nullptr; }
+
+    // the band's chunk, created empty if the band has none yet
+    LevelChunk& ensure(int band) {
+        grow(band);
+        if (!slots[band]) { slots[band].reset(new LevelChunk()); slots[band]->band = band; }
+        return *slots[band];
+    }
+    // puts a loaded chunk in its band (replacing any chunk there) and clears the band's pending mark
+    void install(std::unique_ptr<LevelChunk> c) {
+        int band = c->band;
+        grow(band);
+        noteReach(c->obstacleReach);
+        slots[band] = std::move(c); pendingBands[band] = 0;
+        gen = nextGeneration();
+    }
+    // takes the band's chunk out of the table (null if it had none)
+    std::unique_ptr<LevelChunk> release(int band) { gen = nextGeneration(); return band >= 0 && band < (int)slots.size() ? std::move(slots[band]) : nullptr; }
+
+    bool pending(int band) const { return band >= 0 && band < (int)pendingBands.size() && pendingBands[band]; }
+    void setPending(int band, bool on) { grow(band); pendingBands[band] = on; }
+
+    // upper bound on any obstacle's reach, resident or not; only ever grows until clear()
+    float obstacleReach() const { return maxReach; }
+    void noteReach(float reach) { if (reach > maxReach) maxReach = reach; }
+
+    void clear() { slots.clear(); pendingBands.clear(); maxReach = 0.0f; gen = nextGeneration(); }
+
+    // changes whenever whole chunks come or go (install, release, clear), never for edits within a chunk; unique
+    // across tables, so a table moved in from a loaded level never matches an old value
+    uint64_t generation() const { return gen; }
+
+    template <class F> void forEachResident(F&& f) { for (auto& c : slots) if (c) f(*c); }
+    template <class F> void forEachResident(F&& f) const { for (auto& c : slots) if (c) f((const LevelChunk&)*c); }
+
+    // entity totals over the resident chunks
+    size_t obstacleCount() const { size_t n = 0; forEachResident([&](const LevelChunk& c) { n += c.obstacles.size(); }); return n; }
+    size_t collectibleCount() const { size_t n = 0; forEachResident([&](const LevelChunk& c) { n += c.collectibles.size(); }); return n; }
+    size_t powerupCount() const { size_t n = 0; forEachResident([&](const LevelChunk& c) { n += c.powerups.size(); }); return n; }
+
+private:
+    static uint64_t nextGeneration() { static std::atomic<uint64_t> counter{ 0 }; return ++counter; }
+    void grow(int band) { if (band >= (int)slots.size()) { slots.resize(band + 1); pendingBands.resize(band + 1, 0); } }
+
+    std::vector<std::unique_ptr<LevelChunk>> slots;
+    std::vector<uint8_t> pendingBands;
+    float maxReach = 0.0f;
+    uint64_t gen = 0;
+};
@@ -0,0 +1,455 @@
+#include "LevelFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+const char* levelStatusText(LevelStatus status) {
+    switch (status) {
+    case LEVEL_OK: return "ok";
+    case LEVEL_OPEN_FAILED: return "could not open file";
+    case LEVEL_WRITE_FAILED: return "could not write file";
+    case LEVEL_NOT_A_LEVEL: return "not a level file";
+    case LEVEL_NEWER_VERSION: return "level was saved by a newer version";
+    case LEVEL_CORRUPT: return "level file is damaged";
+    }
+    return "unknown error";
+}
+
+static uint64_t alignBlock(uint64_t offset) { return (offset + 63) & ~uint64_t(63); }
+
+static bool seekTo(FILE* f, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(f, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static bool writePadding(FILE* f, uint64_t& pos, uint64_t to) {
+    static const char zeros[64] = {};
+    bool ok = true;
+    while (ok && pos < to) { size_t n = (size_t)std::min<uint64_t>(to - pos, sizeof(zeros)); ok = fwrite(zeros, 1, n, f) == n; pos += n; }
+    return ok;
+}
+
+// =====================
+// Saving
+// =====================
+
+struct PendingBlock { uint32_t id; uint32_t elementBytes; uint64_t count; const void* data; };
+
+template <class T>
+static void addBlock(std::vector<PendingBlock>& blocks, uint32_t id, const T* data, size_t count) {
+    PendingBlock b; b.id = id; b.elementBytes = sizeof(T); b.count = count; b.data = data; blocks.push_back(b);
+}
+
+// header, table and data for blocks laid out from `base` (the file position offsets are relative to)
+static void layoutBlocks(LevelHeader& h, const char* magic, const std::vector<PendingBlock>& blocks, std::vector<LevelBlock>& table, uint64_t start) {
+    memcpy(h.magic, magic, 4);
+    h.version = LEVEL_FORMAT_VERSION;
+    h.headerBytes = (uint32_t)(sizeof(LevelHeader) + blocks.size() * sizeof(LevelBlock));
+    h.blockCount = (uint32_t)blocks.size();
+    table.resize(blocks.size());
+    uint64_t end = alignBlock(start);
+    for (size_t i = 0;i < blocks.size();++i) {
+        table[i].id = blocks[i].id; table[i].elementBytes = blocks[i].elementBytes; table[i].count = blocks[i].count; table[i].offset = end;
+        end = alignBlock(end + blocks[i].count * blocks[i].elementBytes);
+    }
+    h.fileBytes = end;
+}
+
+static bool writeBlockData(FILE* f, const std::vector<PendingBlock>& blocks, const std::vector<LevelBlock>& table, uint64_t base, uint64_t& pos, uint64_t end) {
+    bool ok = true;
+    for (size_t i = 0;ok && i < blocks.size();++i) {
+        size_t bytes = (size_t)(blocks[i].count * blocks[i].elementBytes);
+        ok = writePadding(f, pos, base + table[i].offset) && (bytes == 0 || fwrite(blocks[i].data, 1, bytes, f) == bytes);
+        pos += bytes;
+    }
+    return ok && writePadding(f, pos, base + end);
+}
+
+LevelStatus writeChunkBlob(FILE* f, const LevelChunk& ch, uint64_t& bytes) {
+    const ObstacleStore& o = ch.obstacles; const CollectibleStore& c = ch.collectibles; const PowerupStore& p = ch.powerups;
+    std::vector<PendingBlock> blocks;
+    addBlock(blocks, BLOCK_OBSTACLE_X, o.x.data(), o.size()); addBlock(blocks, BLOCK_OBSTACLE_Y, o.y.data(), o.size());
+    addBlock(blocks, BLOCK_OBSTACLE_W, o.w.data(), o.size()); addBlock(blocks, BLOCK_OBSTACLE_H, o.h.data(), o.size());
+    addBlock(blocks, BLOCK_COLLECTIBLE_X, c.x.data(), c.size()); addBlock(blocks, BLOCK_COLLECTIBLE_Y, c.y.data(), c.size());
+    addBlock(blocks, BLOCK_COLLECTIBLE_PHASE, c.phase.data(), c.size()); addBlock(blocks, BLOCK_COLLECTIBLE_ACTIVE, c.active.words(), c.active.wordCount());
+    addBlock(blocks, BLOCK_POWERUP_X, p.x.data(), p.size()); addBlock(blocks, BLOCK_POWERUP_Y, p.y.data(), p.size());
+    addBlock(blocks, BLOCK_POWERUP_PHASE, p.phase.data(), p.size()); addBlock(blocks, BLOCK_POWERUP_TYPE, p.type.data(), p.size());
+    addBlock(blocks, BLOCK_POWERUP_ACTIVE, p.active.words(), p.active.wordCount());
+    std::vector<GridCell> cells[3]; std::vector<uint32_t> ids[3];
+    const SpatialGrid* grids[3] = { &ch.obstacleGrid, &ch.collectibleGrid, &ch.powerupGrid };
+    for (int g = 0;g < 3;++g) {
+        grids[g]->exportCells(cells[g], ids[g]);
+        addBlock(blocks, BLOCK_OBSTACLE_GRID_CELLS + 2 * g, cells[g].data(), cells[g].size());
+        addBlock(blocks, BLOCK_OBSTACLE_GRID_IDS + 2 * g, ids[g].data(), ids[g].size());
+    }
+
+    LevelHeader h = {}; std::vector<LevelBlock> table;
+    layoutBlocks(h, "SPLC", blocks, table, sizeof(LevelHeader) + blocks.size() * sizeof(LevelBlock));
+    h.gridCellSize = ch.obstacleGrid.cell();
+    h.obstacleReach = ch.obstacleReach;
+    uint64_t pos = h.headerBytes;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(table.data(), sizeof(LevelBlock), table.size(), f) == table.size() &&
+              writeBlockData(f, blocks, table, 0, pos, h.fileBytes);
+    bytes = h.fileBytes;
+    return ok ? LEVEL_OK : LEVEL_WRITE_FAILED;
+}
+
+LevelWriter::~LevelWriter() {
+    if (f) { fclose(f); remove(tmp.c_str()); }
+}
+
+LevelStatus LevelWriter::open(const char* target) {
+    // write next to the target and rename over it: the old file may still be mapped by this process
+    path = target; tmp = path + ".tmp";
+    entries.clear(); failed = false; pos = 0;
+    f = fopen(tmp.c_str(), "wb");
+    if (!f) return LEVEL_WRITE_FAILED;
+    if (!writePadding(f, pos, LEVEL_TABLE_BYTES)) failed = true; // the table is written last, once the directory is known
+    return failed ? LEVEL_WRITE_FAILED : LEVEL_OK;
+}
+
+LevelStatus LevelWriter::addChunk(const LevelChunk& chunk) {
+    if (!f || failed) return LEVEL_WRITE_FAILED;
+    if (chunk.entityCount() == 0) return LEVEL_OK;
+    ChunkEntry e; e.band = chunk.band; e.entities = (uint32_t)chunk.entityCount(); e.offset = pos;
+    if (writeChunkBlob(f, chunk, e.bytes) != LEVEL_OK) { failed = true; return LEVEL_WRITE_FAILED; }
+    pos += e.bytes;
+    entries.push_back(e);
+    return LEVEL_OK;
+}
+
+LevelStatus LevelWriter::finish(const std::vector<Vec2>& targetBezier, float worldTop, float obstacleReach, const LevelMotion& motion) {
+    if (!f) return LEVEL_WRITE_FAILED;
+    std::vector<PendingBlock> blocks;
+    addBlock(blocks, BLOCK_TARGET_BEZIER, targetBezier.data(), targetBezier.size());
+    addBlock(blocks, BLOCK_WORLD_TOP, &worldTop, 1);
+    addBlock(blocks, BLOCK_CHUNK_DIRECTORY, entries.data(), entries.size());
+    std::vector<MovingObstacleRecord> movingObstacles; std::vector<MovingCollectibleRecord> movingCollectibles;
+    if (!motion.empty()) {
+        const MovingObstacleStore& mo = motion.obstacles; const MovingCollectibleStore& mc = motion.collectibles;
+        for (size_t i = 0;i < mo.size();++i) {
+            const MoverStore& m = mo.motion;
+            MovingObstacleRecord r = { m.path[i], m.originX[i], m.originY[i], m.dist[i], m.speed[i], mo.w[i], mo.h[i] };
+            movingObstacles.push_back(r);
+        }
+        for (size_t i = 0;i < mc.size();++i) {
+            const MoverStore& m = mc.motion;
+            MovingCollectibleRecord r = { m.path[i], (uint32_t)mc.active.test(i), m.originX[i], m.originY[i], m.dist[i], m.speed[i], mc.phase[i] };
+            movingCollectibles.push_back(r);
+        }
+        addBlock(blocks, BLOCK_PATH_POINTS, motion.paths.points().data(), motion.paths.points().size());
+        addBlock(blocks, BLOCK_PATH_DEFS, motion.paths.definitions().data(), motion.paths.definitions().size());
+        addBlock(blocks, BLOCK_MOVING_OBSTACLES, movingObstacles.data(), movingObstacles.size());
+        addBlock(blocks, BLOCK_MOVING_COLLECTIBLES, movingCollectibles.data(), movingCollectibles.size());
+    }
+    LevelHeader h = {}; std::vector<LevelBlock> table;
+    layoutBlocks(h, "SPLV", blocks, table, pos);
+    h.gridCellSize = SpatialGrid().cell();
+    h.obstacleReach = obstacleReach;
+    bool ok = !failed && h.headerBytes <= LEVEL_TABLE_BYTES && writeBlockData(f, blocks, table, 0, pos, h.fileBytes) &&
+              seekTo(f, 0) && fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(table.data(), sizeof(LevelBlock), table.size(), f) == table.size();
+    ok = fclose(f) == 0 && ok;
+    f = nullptr;
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) { remove(tmp.c_str()); return LEVEL_WRITE_FAILED; }
+    return LEVEL_OK;
+}
+
+LevelStatus saveLevel(const GameState& s, const char* path) {
+    LevelWriter w;
+    LevelStatus st = w.open(path);
+    for (int b = 0;st == LEVEL_OK && b < s.chunks.bandCount();++b) if (const LevelChunk* ch = s.chunks.at(b)) st = w.addChunk(*ch);
+    return st == LEVEL_OK ? w.finish(s.targetBezier, s.worldTop, s.chunks.obstacleReach(), s.motion) : st;
+}
+
+// =====================
+// Loading
+// =====================
+
+// validated block table: at most one block per known id
+struct BlockView { uint8_t* data = nullptr; uint64_t offset = 0, count = 0; bool present = false; };
+
+static const uint32_t elementBytes[BLOCK_ID_COUNT] = { 0, 4, 4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 1, 8, sizeof(Vec2), sizeof(GridCell), 4, sizeof(GridCell), 4, sizeof(GridCell), 4,
+                                                       4, sizeof(ChunkEntry), sizeof(Vec2), sizeof(PathDef), sizeof(MovingObstacleRecord), sizeof(MovingCollectibleRecord) };
+
+// Coordinates and phases are finite and well inside float's exact range, so a band or grid cell index fits an
+// int. A reach is one obstacle's extent plus the margin: under 1, or a query would walk a huge range of cells.
+static bool validCoord(float v) { return std::isfinite(v) && fabsf(v) < 1.0e6f; }
+static bool validReach(float reach) { return reach >= 0.0f && reach < 1.0f; }
+static bool validExtent(float e) { return e >= 0.0f && e + OBSTACLE_MARGIN < 1.0f; }
+
+// checks the header against `size` bytes of file (or blob) and fills blocks; data pointers are set when base is given
+static LevelStatus readBlockTable(const LevelHeader& h, const char* magic, const LevelBlock* table, uint64_t size, uint8_t* base, BlockView blocks[BLOCK_ID_COUNT]) {
+    if (memcmp(h.magic, magic, 4) != 0) return LEVEL_NOT_A_LEVEL;
+    if (h.version > LEVEL_FORMAT_VERSION) return LEVEL_NEWER_VERSION;
+    if (h.fileBytes != size || h.headerBytes < sizeof(LevelHeader) || h.headerBytes > size ||
+        (h.headerBytes - sizeof(LevelHeader)) / sizeof(LevelBlock) < h.blockCount || !validReach(h.obstacleReach)) return LEVEL_CORRUPT;
+    for (uint32_t i = 0;i < h.blockCount;++i) {
+        LevelBlock b = table[i];
+        if (b.id == 0 || b.id >= BLOCK_ID_COUNT) continue; // written by a newer version: not ours to read
+        if (b.elementBytes != elementBytes[b.id] || blocks[b.id].present || b.offset % 64 != 0 || b.offset > size || b.count > (size - b.offset) / b.elementBytes) return LEVEL_CORRUPT;
+        blocks[b.id].data = base ? base + b.offset : nullptr; blocks[b.id].offset = b.offset; blocks[b.id].count = b.count; blocks[b.id].present = true;
+    }
+    return LEVEL_OK;
+}
+
+template <class T>
+static bool viewBlock(const std::shared_ptr<void>& keep, const BlockView& b, uint64_t count, Column<T>& out) {
+    if (!b.present || b.count != count) return false;
+    out.view(keep, (T*)b.data, (size_t)count);
+    return true;
+}
+
+static bool activeTailClear(const BlockView& words, uint64_t n) {
+    if (words.count != (n + 63) / 64) return false;
+    return (n & 63) == 0 || (((const uint64_t*)words.data)[words.count - 1] >> (n & 63)) == 0;
+}
+
+// grid blocks are optional; ids must name existing entities, everything else is checked lazily by the grid
+static bool adoptGrid(const std::shared_ptr<void>& keep, const BlockView& cellsBlock, const BlockView& idsBlock, size_t entities, SpatialGrid& grid) {
+    if (!cellsBlock.present || !idsBlock.present) return false;
+    const uint64_t slots = cellsBlock.count;
+    if (slots == 0 || (slots & (slots - 1)) != 0) return false;
+    const uint32_t* ids = (const uint32_t*)idsBlock.data;
+    uint32_t worst = 0;
+    for (uint64_t i = 0;i < idsBlock.count;++i) worst = ids[i] > worst ? ids[i] : worst;
+    if (idsBlock.count && worst >= entities) return false;
+    Column<GridCell> cells; Column<uint32_t> idCol;
+    cells.view(keep, (GridCell*)cellsBlock.data, (size_t)slots);
+    idCol.view(keep, (uint32_t*)idsBlock.data, (size_t)idsBlock.count);
+    grid.adoptCells(std::move(cells), std::move(idCol), (size_t)idsBlock.count);
+    return true;
+}
+
+// the entity and grid blocks of a chunk blob (or of a whole version 1 file)
+static LevelStatus viewChunk(const std::shared_ptr<void>& keep, const LevelHeader& h, const BlockView* blocks, LevelChunk& out) {
+    ObstacleStore o; CollectibleStore c; PowerupStore p;
+    const uint64_t no = blocks[BLOCK_OBSTACLE_X].count, nc = blocks[BLOCK_COLLECTIBLE_X].count, np = blocks[BLOCK_POWERUP_X].count;
+    Column<uint64_t> cActive, pActive;
+    bool ok = viewBlock(keep, blocks[BLOCK_OBSTACLE_X], no, o.x) && viewBlock(keep, blocks[BLOCK_OBSTACLE_Y], no, o.y) &&
+              viewBlock(keep, blocks[BLOCK_OBSTACLE_W], no, o.w) && viewBlock(keep, blocks[BLOCK_OBSTACLE_H], no, o.h) &&
+              viewBlock(keep, blocks[BLOCK_COLLECTIBLE_X], nc, c.x) && viewBlock(keep, blocks[BLOCK_COLLECTIBLE_Y], nc, c.y) &&
+              viewBlock(keep, blocks[BLOCK_COLLECTIBLE_PHASE], nc, c.phase) &&
+              activeTailClear(blocks[BLOCK_COLLECTIBLE_ACTIVE], nc) && viewBlock(keep, blocks[BLOCK_COLLECTIBLE_ACTIVE], (nc + 63) / 64, cActive) &&
+              viewBlock(keep, blocks[BLOCK_POWERUP_X], np, p.x) && viewBlock(keep, blocks[BLOCK_POWERUP_Y], np, p.y) &&
+              viewBlock(keep, blocks[BLOCK_POWERUP_PHASE], np, p.phase) && viewBlock(keep, blocks[BLOCK_POWERUP_TYPE], np, p.type) &&
+              activeTailClear(blocks[BLOCK_POWERUP_ACTIVE], np) && viewBlock(keep, blocks[BLOCK_POWERUP_ACTIVE], (np + 63) / 64, pActive) &&
+              no < 0xFFFFFFFFull && nc < 0xFFFFFFFFull && np < 0xFFFFFFFFull;
+    if (!ok) return LEVEL_CORRUPT;
+    // a chunk blob's reach is what queries trust to find its obstacles, so it has to cover every one of them
+    // (a version 1 file's obstacles are refiled through addObstacle(), which works the reach out again)
+    const bool blob = memcmp(h.magic, "SPLC", 4) == 0;
+    for (size_t i = 0;i < o.size();++i) {
+        if (!validCoord(o.x[i]) || !validCoord(o.y[i]) || !validExtent(o.w[i]) || !validExtent(o.h[i])) return LEVEL_CORRUPT;
+        if (blob && std::max(o.w[i], o.h[i]) + OBSTACLE_MARGIN > h.obstacleReach) return LEVEL_CORRUPT;
+    }
+    for (size_t i = 0;i < c.size();++i)
+        if (!validCoord(c.x[i]) || !validCoord(c.y[i]) || !validCoord(c.phase[i])) return LEVEL_CORRUPT;
+    for (size_t i = 0;i < p.size();++i)
+        if (!validCoord(p.x[i]) || !validCoord(p.y[i]) || !validCoord(p.phase[i]) || p.type[i] > P_SPEED) return LEVEL_CORRUPT;
+    c.active.adopt(std::move(cActive), (size_t)nc);
+    p.active.adopt(std::move(pActive), (size_t)np);
+
+    // grids: taken from the file when it was built with our cell size, otherwise rebuilt
+    SpatialGrid og, cg, pg;
+    bool sameCells = h.gridCellSize == og.cell();
+    if (!sameCells || !adoptGrid(keep, blocks[BLOCK_OBSTACLE_GRID_CELLS], blocks[BLOCK_OBSTACLE_GRID_IDS], o.size(), og)) {
+        og.build(o.x.data(), o.y.data(), nullptr, o.size());
+    }
+    if (!sameCells || !adoptGrid(keep, blocks[BLOCK_COLLECTIBLE_GRID_CELLS], blocks[BLOCK_COLLECTIBLE_GRID_IDS], c.size(), cg)) {
+        cg.build(c.x.data(), c.y.data(), c.active.words(), c.size());
+    }
+    if (!sameCells || !adoptGrid(keep, blocks[BLOCK_POWERUP_GRID_CELLS], blocks[BLOCK_POWERUP_GRID_IDS], p.size(), pg)) {
+        pg.build(p.x.data(), p.y.data(), p.active.words(), p.size());
+    }
+    out.obstacles = std::move(o); out.collectibles = std::move(c); out.powerups = std::move(p);
+    out.obstacleGrid = std::move(og); out.collectibleGrid = std::move(cg); out.powerupGrid = std::move(pg);
+    out.obstacleReach = h.obstacleReach;
+    out.dirty = false;
+    return LEVEL_OK;
+}
+
+LevelStatus parseChunkBlob(std::shared_ptr<void> keep, uint8_t* data, uint64_t size, int band, LevelChunk& out) {
+    if (size < sizeof(LevelHeader)) return LEVEL_CORRUPT;
+    LevelHeader h; memcpy(&h, data, sizeof(h));
+    BlockView blocks[BLOCK_ID_COUNT];
+    LevelStatus st = readBlockTable(h, "SPLC", (const LevelBlock*)(data + sizeof(LevelHeader)), size, data, blocks);
+    if (st == LEVEL_NOT_A_LEVEL) return LEVEL_CORRUPT;
+    if (st != LEVEL_OK) return st;
+    out.band = band;
+    return viewChunk(keep, h, blocks, out);
+}
+
+LevelStatus readChunkBlob(FILE* f, const ChunkEntry& entry, LevelChunk& out) {
+    if (entry.bytes < sizeof(LevelHeader) || entry.bytes > (uint64_t)SIZE_MAX / 2) return LEVEL_CORRUPT;
+    // 64-byte aligned like a mapped file, so the blocks keep their alignment
+    std::shared_ptr<uint8_t> buffer((uint8_t*)::operator new((size_t)entry.bytes, std::align_val_t(64)), [](uint8_t* q) { ::operator delete(q, std::align_val_t(64)); });
+    if (!seekTo(f, entry.offset) || fread(buffer.get(), 1, (size_t)entry.bytes, f) != entry.bytes) return LEVEL_CORRUPT;
+    return parseChunkBlob(buffer, buffer.get(), entry.bytes, entry.band, out);
+}
+
+// bands are small non-negative integers, each at most once
+static bool validDirectory(const ChunkEntry* dir, uint64_t count, uint64_t size) {
+    std::vector<uint8_t> seen;
+    for (uint64_t i = 0;i < count;++i) {
+        const ChunkEntry& e = dir[i];
+        if (e.band < 0 || e.band >= (1 << 20) || e.offset % 64 != 0 || e.offset > size || e.bytes > size - e.offset) return false;
+        if ((size_t)e.band >= seen.size()) seen.resize(e.band + 1, 0);
+        if (seen[e.band]) return false;
+        seen[e.band] = 1;
+    }
+    return true;
+}
+
+static bool validWorldTop(float top) { return std::isfinite(top) && top >= WORLD_TOP && top < 1.0e6f; }
+
+// path followers from their blocks (all four or none); false if anything is out of range. They are copied,
+// not mapped: there are few of them and they change every tick.
+static bool readMotion(const Vec2* points, uint64_t np, const PathDef* defs, uint64_t nd,
+                       const MovingObstacleRecord* obstacles, uint64_t no, const MovingCollectibleRecord* collectibles, uint64_t nc, LevelMotion& out) {
+    out.clear();
+    if (!out.paths.assign(points, (size_t)np, defs, (size_t)nd)) return false;
+    MovingObstacleStore& mo = out.obstacles; MovingCollectibleStore& mc = out.collectibles;
+    for (uint64_t i = 0;i < no;++i) {
+        const MovingObstacleRecord& r = obstacles[i];
+        if (r.path >= nd || !validCoord(r.originX) || !validCoord(r.originY) || !validCoord(r.dist) || !validCoord(r.speed) || !(r.w >= 0.0f && r.w < 1.0f) || !(r.h >= 0.0f && r.h < 1.0f)) return false;
+        mo.motion.push(r.path, Vec2(r.originX, r.originY), r.dist, r.speed, Vec2()); mo.w.push_back(r.w); mo.h.push_back(r.h);
+    }
+    for (uint64_t i = 0;i < nc;++i) {
+        const MovingCollectibleRecord& r = collectibles[i];
+        if (r.path >= nd || r.active > 1 || !validCoord(r.originX) || !validCoord(r.originY) || !validCoord(r.dist) || !validCoord(r.speed) || !validCoord(r.phase)) return false;
+        mc.motion.push(r.path, Vec2(r.originX, r.originY), r.dist, r.speed, Vec2()); mc.phase.push_back(r.phase); mc.active.push_back(r.active != 0);
+    }
+    advanceMovers(out.paths, mo.motion, 0.0f); advanceMovers(out.paths, mc.motion, 0.0f);
+    return true;
+}
+
+static bool motionBlocksPresent(const BlockView* blocks, bool& any) {
+    int n = blocks[BLOCK_PATH_POINTS].present + blocks[BLOCK_PATH_DEFS].present + blocks[BLOCK_MOVING_OBSTACLES].present + blocks[BLOCK_MOVING_COLLECTIBLES].present;
+    any = n > 0;
+    return n == 0 || n == 4;
+}
+
+LevelStatus readLevelIndex(FILE* f, LevelIndex& out) {
+    LevelHeader h;
+    if (!seekTo(f, 0) || fread(&h, sizeof(h), 1, f) != 1) return LEVEL_NOT_A_LEVEL;
+    if (memcmp(h.magic, "SPLV", 4) != 0) return LEVEL_NOT_A_LEVEL;
+    if (h.headerBytes < sizeof(LevelHeader) || h.headerBytes > (1u << 20)) return LEVEL_CORRUPT;
+    std::vector<LevelBlock> table((h.headerBytes - sizeof(LevelHeader)) / sizeof(LevelBlock));
+    if (fread(table.data(), sizeof(LevelBlock), table.size(), f) != table.size()) return LEVEL_CORRUPT;
+    uint64_t size = 0;
+    if (fseek(f, 0, SEEK_END) == 0) {
+#ifdef _WIN32
+        size = (uint64_t)_ftelli64(f);
+#else
+        size = (uint64_t)ftello(f);
+#endif
+    }
+    BlockView blocks[BLOCK_ID_COUNT];
+    LevelStatus st = readBlockTable(h, "SPLV", table.data(), size, nullptr, blocks);
+    if (st != LEVEL_OK) return st;
+    auto readBlock = [&](const BlockView& b, void* to) { return seekTo(f, b.offset) && fread(to, elementBytes[&b - blocks], (size_t)b.count, f) == b.count; };
+
+    LevelIndex index;
+    index.version = h.version;
+    index.obstacleReach = h.obstacleReach;
+    const BlockView& bezier = blocks[BLOCK_TARGET_BEZIER];
+    if (!bezier.present || bezier.count != 4) return LEVEL_CORRUPT;
+    index.targetBezier.resize(4);
+    if (!readBlock(bezier, index.targetBezier.data())) return LEVEL_CORRUPT;
+    if (h.version >= 2) {
+        const BlockView& top = blocks[BLOCK_WORLD_TOP]; const BlockView& dir = blocks[BLOCK_CHUNK_DIRECTORY];
+        if (!top.present || top.count != 1 || !dir.present || !readBlock(top, &index.worldTop) || !validWorldTop(index.worldTop)) return LEVEL_CORRUPT;
+        index.chunks.resize((size_t)dir.count);
+        if (!readBlock(dir, index.chunks.data()) || !validDirectory(index.chunks.data(), dir.count, size)) return LEVEL_CORRUPT;
+    }
+    bool moving = false;
+    if (!motionBlocksPresent(blocks, moving)) return LEVEL_CORRUPT;
+    if (moving) {
+        const BlockView& pts = blocks[BLOCK_PATH_POINTS]; const BlockView& defs = blocks[BLOCK_PATH_DEFS];
+        const BlockView& mo = blocks[BLOCK_MOVING_OBSTACLES]; const BlockView& mc = blocks[BLOCK_MOVING_COLLECTIBLES];
+        std::vector<Vec2> points((size_t)pts.count); std::vector<PathDef> paths((size_t)defs.count);
+        std::vector<MovingObstacleRecord> obstacles((size_t)mo.count); std::vector<MovingCollectibleRecord> collectibles((size_t)mc.count);
+        if (!readBlock(pts, points.data()) || !readBlock(defs, paths.data()) || !readBlock(mo, obstacles.data()) || !readBlock(mc, collectibles.data()) ||
+            !readMotion(points.data(), pts.count, paths.data(), defs.count, obstacles.data(), mo.count, collectibles.data(), mc.count, index.motion)) return LEVEL_CORRUPT;
+    }
+    out = std::move(index);
+    return LEVEL_OK;
+}
+
+LevelStatus loadLevel(GameState& s, const char* path) {
+    std::shared_ptr<MappedFile> file = MappedFile::openPrivate(path);
+    if (!file) return LEVEL_OPEN_FAILED;
+    const uint64_t size = file->size();
+    if (size < sizeof(LevelHeader)) return LEVEL_NOT_A_LEVEL;
+    LevelHeader h; memcpy(&h, file->data(), sizeof(h));
+    BlockView blocks[BLOCK_ID_COUNT];
+    LevelStatus st = readBlockTable(h, "SPLV", (const LevelBlock*)(file->data() + sizeof(LevelHeader)), size, file->data(), blocks);
+    if (st != LEVEL_OK) return st;
+    if (!blocks[BLOCK_TARGET_BEZIER].present || blocks[BLOCK_TARGET_BEZIER].count != 4) return LEVEL_CORRUPT;
+
+    GameState loaded; // only its chunks, world top and path followers are used
+    bool moving = false;
+    if (!motionBlocksPresent(blocks, moving)) return LEVEL_CORRUPT;
+    if (moving && !readMotion((const Vec2*)blocks[BLOCK_PATH_POINTS].data, blocks[BLOCK_PATH_POINTS].count, (const PathDef*)blocks[BLOCK_PATH_DEFS].data, blocks[BLOCK_PATH_DEFS].count,
+                              (const MovingObstacleRecord*)blocks[BLOCK_MOVING_OBSTACLES].data, blocks[BLOCK_MOVING_OBSTACLES].count,
+                              (const MovingCollectibleRecord*)blocks[BLOCK_MOVING_COLLECTIBLES].data, blocks[BLOCK_MOVING_COLLECTIBLES].count, loaded.motion)) return LEVEL_CORRUPT;
+    if (h.version < 2) {
+        // version 1: one unchunked level; file its entities into bands (copies them to the heap)
+        LevelChunk whole;
+        if ((st = viewChunk(file, h, blocks, whole)) != LEVEL_OK) return st;
+        const ObstacleStore& o = whole.obstacles; const CollectibleStore& c = whole.collectibles; const PowerupStore& p = whole.powerups;
+        for (size_t i = 0;i < o.size();++i) addObstacle(loaded, o.get(i));
+        for (size_t i = 0;i < c.size();++i) addCollectible(loaded, c.get(i));
+        for (size_t i = 0;i < p.size();++i) addPowerup(loaded, p.get(i));
+        loaded.chunks.forEachResident([](LevelChunk& ch) { ch.dirty = false; });
+    }
+    else {
+        const BlockView& top = blocks[BLOCK_WORLD_TOP]; const BlockView& dir = blocks[BLOCK_CHUNK_DIRECTORY];
+        if (!top.present || top.count != 1 || !dir.present) return LEVEL_CORRUPT;
+        memcpy(&loaded.worldTop, top.data, sizeof(float));
+        const ChunkEntry* entries = (const ChunkEntry*)dir.data;
+        if (!validWorldTop(loaded.worldTop) || !validDirectory(entries, dir.count, size)) return LEVEL_CORRUPT;
+        for (uint64_t i = 0;i < dir.count;++i) {
+            std::unique_ptr<LevelChunk> ch(new LevelChunk());
+            if ((st = parseChunkBlob(file, file->data() + entries[i].offset, entries[i].bytes, entries[i].band, *ch)) != LEVEL_OK) return st;
+            if (ch->obstacleReach > h.obstacleReach) return LEVEL_CORRUPT; // the level's reach covers every chunk
+            loaded.chunks.install(std::move(ch));
+        }
+        loaded.chunks.noteReach(h.obstacleReach);
+    }
+
+    clearLevel(s);
+    s.chunks = std::move(loaded.chunks); s.worldTop = loaded.worldTop; s.motion = std::move(loaded.motion);
+    setTargetPath(s, (const Vec2*)blocks[BLOCK_TARGET_BEZIER].data);
+    resetToEditing(s);
+    return LEVEL_OK;
+}
+
+void detachLevel(GameState& s) {
+    s.chunks.forEachResident([](LevelChunk& ch) {
+        ch.obstacles.x.detach(); ch.obstacles.y.detach(); ch.obstacles.w.detach(); ch.obstacles.h.detach();
+        ch.collectibles.x.detach(); ch.collectibles.y.detach(); ch.collectibles.phase.detach(); ch.collectibles.active.detach();
+        ch.powerups.x.detach(); ch.powerups.y.detach(); ch.powerups.phase.detach(); ch.powerups.type.detach(); ch.powerups.active.detach();
+        ch.obstacleGrid.detach(); ch.collectibleGrid.detach(); ch.powerupGrid.detach();
+    });
+}
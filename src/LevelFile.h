@@ -0,0 +1,134 @@
+#pragma once
+
+// =====================
+// Binary level files. Layout (little-endian, as on every platform this builds for):
+//
+//   LevelHeader | LevelBlock[blockCount] | padding to LEVEL_TABLE_BYTES | chunk blobs | level blocks
+//
+// A chunk blob is one LevelChunk (see LevelChunk.h), self-contained so it can be read on its own:
+//
+//   LevelHeader ("SPLC") | LevelBlock[blockCount] | block data, each block starting on a 64-byte boundary
+//
+// with block offsets relative to the blob. Each block is one flat array: a field of an entity store
+// (obstacle x, y, w, h; collectible x, y, phase, active bits; power-up x, y, phase, type, active bits) or a
+// spatial grid's cell table and id list. The level's own blocks are the target's Bezier control points, the
+// world top, the chunk directory and the path followers (their paths' control points and definitions, and one
+// record per moving obstacle or collectible). Loading a whole level maps the file privately and points the
+// stores and grids straight at the blobs, so it opens without parsing or copying; a ChunkStreamer instead
+// reads single blobs as the camera reaches them. Readers skip block ids they do not know, and LEVEL_FORMAT_VERSION only
+// changes when an existing block changes meaning. Version 1 files (one unchunked level, entity blocks at the
+// top) still load.
+// =====================
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GameCore.h"
+
+const uint32_t LEVEL_FORMAT_VERSION = 2;
+const uint32_t LEVEL_TABLE_BYTES = 256; // room reserved for the header and block table of a level file
+
+struct LevelHeader {
+    char magic[4];        // "SPLV" for a level, "SPLC" for a chunk blob
+    uint32_t version;     // LEVEL_FORMAT_VERSION of the writer
+    uint32_t headerBytes; // header plus block table, before padding
+    uint32_t blockCount;
+    uint64_t fileBytes;   // of the whole file, or of the blob
+    float gridCellSize;   // cell size the grid blocks were built with
+    float obstacleReach;  // largest LevelChunk::obstacleReach in the level, or the chunk's own
+};
+
+struct LevelBlock {
+    uint32_t id;           // LevelBlockId
+    uint32_t elementBytes; // size of one element, checked against the reader's type
+    uint64_t count;        // elements
+    uint64_t offset;       // from the start of the file (or blob), 64-byte aligned
+};
+
+enum LevelBlockId {
+    BLOCK_OBSTACLE_X = 1, BLOCK_OBSTACLE_Y, BLOCK_OBSTACLE_W, BLOCK_OBSTACLE_H,
+    BLOCK_COLLECTIBLE_X, BLOCK_COLLECTIBLE_Y, BLOCK_COLLECTIBLE_PHASE, BLOCK_COLLECTIBLE_ACTIVE,
+    BLOCK_POWERUP_X, BLOCK_POWERUP_Y, BLOCK_POWERUP_PHASE, BLOCK_POWERUP_TYPE, BLOCK_POWERUP_ACTIVE,
+    BLOCK_TARGET_BEZIER,
+    // optional: without them (or with another cell size) the grids are rebuilt on load
+    BLOCK_OBSTACLE_GRID_CELLS, BLOCK_OBSTACLE_GRID_IDS,
+    BLOCK_COLLECTIBLE_GRID_CELLS, BLOCK_COLLECTIBLE_GRID_IDS,
+    BLOCK_POWERUP_GRID_CELLS, BLOCK_POWERUP_GRID_IDS,
+    // version 2
+    BLOCK_WORLD_TOP, BLOCK_CHUNK_DIRECTORY,
+    // optional: path followers (PathSystem.h)
+    BLOCK_PATH_POINTS, BLOCK_PATH_DEFS, BLOCK_MOVING_OBSTACLES, BLOCK_MOVING_COLLECTIBLES,
+    BLOCK_ID_COUNT
+};
+
+// one BLOCK_CHUNK_DIRECTORY element: where band's blob lives
+struct ChunkEntry {
+    int32_t band;
+    uint32_t entities;
+    uint64_t offset; // 64-byte aligned
+    uint64_t bytes;
+};
+
+// one BLOCK_MOVING_OBSTACLES / BLOCK_MOVING_COLLECTIBLES element; path indexes BLOCK_PATH_DEFS
+struct MovingObstacleRecord { uint32_t path; float originX, originY, dist, speed, w, h; };
+struct MovingCollectibleRecord { uint32_t path; uint32_t active; float originX, originY, dist, speed, phase; };
+
+enum LevelStatus { LEVEL_OK = 0, LEVEL_OPEN_FAILED, LEVEL_WRITE_FAILED, LEVEL_NOT_A_LEVEL, LEVEL_NEWER_VERSION, LEVEL_CORRUPT };
+const char* levelStatusText(LevelStatus status);
+
+// writes the level (every chunk in the table, target path, world top, path followers) to a temporary file and renames it over path
+LevelStatus saveLevel(const GameState& s, const char* path);
+
+// replaces the level with the file's and returns to editing mode; on failure s is left untouched
+LevelStatus loadLevel(GameState& s, const char* path);
+
+// copies every array still backed by a level file to the heap, releasing the mapping
+// (Windows cannot replace a file while it is mapped)
+void detachLevel(GameState& s);
+
+// =====================
+// Chunk-level access, for writing levels piecewise and for streaming
+// =====================
+
+// everything in a level file but the chunks themselves; a version 1 file has no directory
+struct LevelIndex {
+    uint32_t version = 0;
+    std::vector<Vec2> targetBezier;
+    float worldTop = WORLD_TOP;
+    float obstacleReach = 0.0f;
+    std::vector<ChunkEntry> chunks;
+    LevelMotion motion;
+};
+LevelStatus readLevelIndex(FILE* f, LevelIndex& out);
+
+// builds out from the blob at data (size bytes, 64-byte aligned); the chunk's columns view the blob and keep `keep` alive
+LevelStatus parseChunkBlob(std::shared_ptr<void> keep, uint8_t* data, uint64_t size, int band, LevelChunk& out);
+// reads and parses one blob; the chunk owns the buffer it was read into
+LevelStatus readChunkBlob(FILE* f, const ChunkEntry& entry, LevelChunk& out);
+// appends the chunk's blob at the current (64-byte aligned) position of f
+LevelStatus writeChunkBlob(FILE* f, const LevelChunk& chunk, uint64_t& bytes);
+
+// writes a level one chunk at a time, so a level never has to be in memory all at once
+class LevelWriter {
+public:
+    LevelWriter() {}
+    ~LevelWriter(); // an unfinished file is abandoned
+    LevelWriter(const LevelWriter&) = delete;
+    LevelWriter& operator=(const LevelWriter&) = delete;
+
+    LevelStatus open(const char* path);
+    LevelStatus addChunk(const LevelChunk& chunk); // at most once per band; empty chunks are skipped
+    // writes the level blocks and renames the file into place
+    LevelStatus finish(const std::vector<Vec2>& targetBezier, float worldTop, float obstacleReach, const LevelMotion& motion);
+    const std::vector<ChunkEntry>& directory() const { return entries; }
+
+private:
+    FILE* f = nullptr;
+    std::string path, tmp;
+    uint64_t pos = 0;
+    std::vector<ChunkEntry> entries;
+    bool failed = false;
+};
@@ -0,0 +1,127 @@
+#include "LevelGen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// the band starts this far above the rocket, so no obstacle box (half height 0.06 plus the hit margin) covers it
+static const float START_CLEARANCE = 0.12f;
+// candidates per accepted point, evenly spaced on a ring just past the spacing (a denser, faster packing than
+// Bridson's random annulus)
+static const int RING_CANDIDATES = 8;
+// points per square unit the sampler reaches at PLACEMENT_SPACING, a little under what it measures, so a band
+// sized from it always holds the requested count
+static const float PACKED_DENSITY = 115.0f;
+
+namespace {
+// xorshift32 like randf(), on its own state so a generated level depends only on its seed
+struct GenRng {
+    uint32_t state;
+    uint32_t next() { uint32_t x = state; x ^= x << 13; x ^= x >> 17; x ^= x << 5; return state = x; }
+    float uniform(float a, float b) { return a + (float(next() >> 8) / float(1u << 24)) * (b - a); }
+};
+
+// Poisson-disk sampler over [x0, x1] x (y0, y1): a grid of cells small enough (spacing / sqrt 2) to hold at
+// most one sample, so a candidate only has to look at the 5x5 cells around its own, minus the corners. Cells
+// hold the sample itself (an empty cell holds a point far away, which no test finds close) and the grid has a
+// two-cell border, so the 21 tests need no bounds checks or branches on emptiness.
+class DiskSampler {
+public:
+    DiskSampler(float x0, float y0, float x1, float y1, float spacing) : x0(x0), y0(y0), x1(x1), y1(y1), r2(spacing * spacing) {
+        invCell = 1.0f / (spacing * 0.7071f);
+        cols = (int)ceilf((x1 - x0) * invCell) + 4; rows = (int)ceilf((y1 - y0) * invCell) + 4;
+        grid.assign((size_t)cols * rows, Vec2(FAR, FAR));
+        // nearest cells first: a rejected candidate usually stops at the first or second test
+        int n = 0;
+        for (int d2 = 0;d2 <= 5;++d2) for (int dy = -2;dy <= 2;++dy) for (int dx = -2;dx <= 2;++dx) if (dx * dx + dy * dy == d2) near[n++] = dy * cols + dx;
+    }
+    bool inside(const Vec2& p) const { return p.x >= x0 && p.x <= x1 && p.y > y0 && p.y < y1; }
+    // same test as tooCloseToExisting: squared distance below the squared spacing
+    bool clear(const Vec2& p) const {
+        const Vec2* c = &grid[cellOf(p)];
+        for (int i = 0;i < 21;++i) { float dx = c[near[i]].x - p.x, dy = c[near[i]].y - p.y; if (dx * dx + dy * dy < r2) return false; }
+        return true;
+    }
+    void add(const Vec2& p) { grid[cellOf(p)] = p; points.push_back(p); }
+    std::vector<Vec2> points; // in the order they were accepted
+
+private:
+    static constexpr float FAR = 1.0e9f;
+    size_t cellOf(const Vec2& p) const { return (size_t)((int)((p.y - y0) * invCell) + 2) * cols + (int)((p.x - x0) * invCell) + 2; }
+    float x0, y0, x1, y1, r2, invCell;
+    int cols, rows;
+    int near[21];
+    std::vector<Vec2> grid;
+};
+}
+
+size_t generateLevel(GameState& s, const LevelGenOptions& o) {
+    const float spacing = PLACEMENT_SPACING;
+    const float x0 = WORLD_LEFT + 0.02f, x1 = WORLD_RIGHT - 0.02f; // pointInsideGameArea()
+    const float y0 = s.playerY + START_CLEARANCE;
+    // the target's track stays inside the hull of its control points, so below the lowest one is below the target
+    float trackLow = s.targetPos.y;
+    for (const Vec2& c : s.targetBezier) trackLow = std::min(trackLow, c.y);
+    float y1 = trackLow;
+    if (o.count) {
+        float needed = y0 + o.count / (PACKED_DENSITY * (x1 - x0));
+        if (needed > y1 && s.targetBezier.size() == 4) {
+            // raise the target (and the world's top with it) until the band holds count objects
+            Vec2 ctrl[4];
+            float top = s.worldTop;
+            for (int i = 0;i < 4;++i) { ctrl[i] = Vec2(s.targetBezier[i].x, s.targetBezier[i].y + needed - y1); top = std::max(top, ctrl[i].y); }
+            setTargetPath(s, ctrl);
+            s.worldTop = top;
+            y1 = needed;
+        }
+    }
+    if (y1 <= y0 || bandsPending(s, y0, y1)) return 0;
+
+    // objects already in the band are honoured through the editor's own test
+    bool existing = false;
+    for (int b = chunkBand(y0 - spacing), last = chunkBand(y1 + spacing);b <= last && !existing;++b) existing = s.chunks.at(b) && s.chunks.at(b)->entityCount();
+    GenRng rng = { o.seed ? o.seed : 0x9E3779B9u };
+    DiskSampler disk(x0, y0, x1, y1, spacing);
+    auto accept = [&](const Vec2& p) { return disk.inside(p) && disk.clear(p) && !(existing && tooCloseToExisting(s, p, spacing)); };
+
+    // the ring's directions, turned by a random angle per point
+    Vec2 ring[RING_CANDIDATES];
+    for (int i = 0;i < RING_CANDIDATES;++i) { float a = 6.2831853f * i / RING_CANDIDATES; ring[i] = Vec2(cosf(a) * spacing * 1.001f, sinf(a) * spacing * 1.001f); }
+    // a few tries for the first point in case it lands on existing objects; the front then spreads through the
+    // band in first-in first-out order, which keeps the grid rows it touches close together
+    for (int tries = 0;tries < 64 && disk.points.empty();++tries) { Vec2 p(rng.uniform(x0, x1), rng.uniform(y0, y1)); if (accept(p)) disk.add(p); }
+    for (size_t head = 0;head < disk.points.size();++head) {
+        const Vec2 base = disk.points[head];
+        float a = rng.uniform(0.0f, 6.2831853f), c = cosf(a), sn = sinf(a);
+        for (int i = 0;i < RING_CANDIDATES;++i) {
+            Vec2 p(base.x + ring[i].x * c - ring[i].y * sn, base.y + ring[i].x * sn + ring[i].y * c);
+            if (accept(p)) disk.add(p);
+        }
+    }
+
+    s.solvability.invalidate(); // one rebuild is cheaper than repairing it object by object
+    const float total = o.obstacles + o.collectibles + o.shields + o.speeds;
+    std::vector<Obstacle> obstacles; std::vector<Collectible> collectibles; std::vector<PowerUp> powerups;
+    // a full band is thinned to count at random in one pass (selection sampling: each point is kept with
+    // probability still needed / still left)
+    const size_t n = disk.points.size();
+    size_t wanted = o.count && o.count < n ? o.count : n, placed = 0;
+    for (size_t i = 0;i < n && placed < wanted;++i) {
+        if (wanted < n && (uint64_t)rng.next() * (n - i) >= (uint64_t)(wanted - placed) << 32) continue;
+        const Vec2& p = disk.points[i];
+        ++placed;
+        float k = rng.uniform(0.0f, total);
+        if (k < o.obstacles) { Obstacle ob; ob.pos = p; ob.w = 0.08f; ob.h = 0.06f; obstacles.push_back(ob); }
+        else if (k < o.obstacles + o.collectibles) { Collectible c; c.pos = p; c.phase = rng.uniform(0, 6.28f); collectibles.push_back(c); }
+        else { PowerUp pu; pu.pos = p; pu.type = k < o.obstacles + o.collectibles + o.shields ? P_SHIELD : P_SPEED; powerups.push_back(pu); }
+    }
+    addEntities(s, obstacles, collectibles, powerups);
+    return placed;
+}
+
+LevelStatus generateLevelFile(const char* path, size_t count, uint32_t seed, size_t& placed) {
+    GameState s; initGame(s, seed);
+    LevelGenOptions o; o.count = count; o.seed = seed;
+    placed = generateLevel(s, o);
+    return saveLevel(s, path);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// =====================
+// Procedural levels: Poisson-disk sampling of the band between the rocket and the target's track, so big
+// stress levels no longer have to be clicked in. Samples grow outward from a seed (Bridson's algorithm): each
+// accepted point tries a ring of candidates just past the spacing, and a background grid with at most one
+// point per cell answers "anything too close?" from 21 cells. Work is linear in the number of objects.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GameCore.h"
+#include "LevelFile.h"
+
+struct LevelGenOptions {
+    size_t count = 0; // objects to add; 0 fills the band
+    float obstacles = 2.0f, collectibles = 2.0f, shields = 0.5f, speeds = 0.5f; // relative weights of the kinds
+    uint32_t seed = 1u;
+};
+
+// adds objects under the editor's placement rules: inside the world, above the rocket and below the lowest
+// point of the target's track, PLACEMENT_SPACING from each other and from everything already placed (the
+// rocket's start is kept clear too). When count objects do not fit below the target, the target and the top
+// of the world move up to make room. Returns how many were placed (0 while the band is still streaming in).
+size_t generateLevel(GameState& s, const LevelGenOptions& o);
+
+// --generate: a fresh level (initGame(seed), then count objects of the default mix) written to path
+LevelStatus generateLevelFile(const char* path, size_t count, uint32_t seed, size_t& placed);
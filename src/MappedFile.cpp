@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<MappedFile> MappedFile::openPrivate(const char* path) {
+    std::shared_ptr<MappedFile> m(new MappedFile());
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return nullptr; }
+    // PAGE_WRITECOPY + FILE_MAP_COPY is the Windows spelling of MAP_PRIVATE
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+    void* p = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping); // the view keeps the mapping object alive
+    if (!p) return nullptr;
+    m->base = (uint8_t*)p; m->length = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return nullptr; }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping holds its own reference to the file
+    if (p == MAP_FAILED) return nullptr;
+    m->base = (uint8_t*)p; m->length = (size_t)st.st_size;
+#endif
+    return m;
+}
+
+MappedFile::~MappedFile() {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+#else
+    munmap(base, length);
+#endif
+}
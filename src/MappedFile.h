@@ -0,0 +1,71 @@
+#pragma once
+
+// =====================
+// Private (copy-on-write) file mappings and the array type the entity stores are built from.
+// A Column either owns heap storage or views a slice of a mapping: loading a level points the
+// columns straight at the file, and pages are only copied when something writes to them.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// read/write view of a whole file; writes stay private to the process and never reach the file
+class MappedFile {
+public:
+    static std::shared_ptr<MappedFile> openPrivate(const char* path); // nullptr on failure
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    MappedFile() {}
+    uint8_t* base = nullptr;
+    size_t length = 0;
+};
+
+// vector-like array of trivially copyable T. It owns heap storage or views memory kept alive by a backing
+// object (a MappedFile, or a buffer a chunk was read into). Growing a viewing column first copies it to the
+// heap; copies of a column are always heap-owned, so a copied GameState never shares storage.
+template <class T>
+class Column {
+public:
+    Column() {}
+    Column(const Column& o) : heap(o.ptr, o.ptr + o.n) { sync(); }
+    Column(Column&& o) noexcept : heap(std::move(o.heap)), backing(std::move(o.backing)), ptr(o.ptr), n(o.n) { o.heap.clear(); o.sync(); }
+    Column& operator=(Column o) noexcept { heap.swap(o.heap); backing.swap(o.backing); std::swap(ptr, o.ptr); std::swap(n, o.n); return *this; }
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    T& back() { return ptr[n - 1]; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + n; }
+
+    void push_back(const T& v) { if (backing) detach(); heap.push_back(v); sync(); }
+    void pop_back() { if (backing) --n; else { heap.pop_back(); sync(); } }
+    void reserve(size_t count) { if (backing) detach(); heap.reserve(count); sync(); }
+    void clear() { heap.clear(); backing.reset(); sync(); }
+
+    // points the column at count elements owned by `keep` (which the column keeps alive)
+    void view(std::shared_ptr<void> keep, T* first, size_t count) { heap.clear(); backing = std::move(keep); ptr = first; n = count; }
+    bool mapped() const { return backing != nullptr; }
+    // copies viewed contents to the heap and releases the backing
+    void detach() { if (!backing) return; std::vector<T> own(ptr, ptr + n); heap.swap(own); backing.reset(); sync(); }
+
+private:
+    void sync() { ptr = heap.data(); n = heap.size(); }
+
+    std::vector<T> heap;
+    std::shared_ptr<void> backing;
+    T* ptr = nullptr;
+    size_t n = 0;
+};
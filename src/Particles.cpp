@@ -0,0 +1,126 @@
+#define _USE_MATH_DEFINES
+
+#include "Particles.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "EntityKernels.h"
+
+// drag as the fraction of velocity lost per second (exp(-drag * dt) per step); no gravity in space
+const float SPARK_DRAG = 2.0f, DEBRIS_DRAG = 1.0f;
+const float EXHAUST_RATE = 400.0f;  // particles per second while the thruster fires
+const float EXHAUST_NOZZLE = 0.12f; // nozzle distance behind the rocket's centre (the flame in drawPlayer)
+const float DEBRIS_SPIN = 6.0f;     // radians per second
+const size_t SPARK_DRAW_RESERVE = 4096; // points batch room kept from the first frame: everyday effects never grow it
+
+bool ParticlePool::spawn(float px, float py, float pvx, float pvy, float lifetime, float halfSize, uint32_t color) {
+    if (live == capacity()) return false;
+    size_t i = live++;
+    x[i] = px; y[i] = py; vx[i] = pvx; vy[i] = pvy; age[i] = 0.0f; life[i] = lifetime; size[i] = halfSize; rgba[i] = color;
+    return true;
+}
+
+void ParticlePool::update(float dt, float damping, float gravity) {
+    integrateParticles(x.data(), y.data(), vx.data(), vy.data(), age.data(), live, dt, damping, gravity);
+    // swap-and-pop the expired ones; the swapped-in particle is tested in turn
+    for (size_t i = 0;i < live;) {
+        if (age[i] < life[i]) { ++i; continue; }
+        size_t last = --live;
+        x[i] = x[last]; y[i] = y[last]; vx[i] = vx[last]; vy[i] = vy[last]; age[i] = age[last]; life[i] = life[last]; size[i] = size[last]; rgba[i] = rgba[last];
+    }
+}
+
+// xorshift32 like randf(), uniform in [a, b)
+static float uniform(ParticleSystem& ps, float a, float b) {
+    ps.rng ^= ps.rng << 13; ps.rng ^= ps.rng >> 17; ps.rng ^= ps.rng << 5;
+    return a + float(ps.rng >> 8) / float(1u << 24) * (b - a);
+}
+
+// n sparks from (x, y) in every direction at speeds in [v0, v1)
+static void sparkBurst(ParticleSystem& ps, const Vec2& at, int n, float v0, float v1, float life, float r, float g, float b) {
+    for (int i = 0;i < n;++i) {
+        float a = uniform(ps, 0.0f, 2.0f * (float)M_PI), v = uniform(ps, v0, v1);
+        if (!ps.sparks.spawn(at.x, at.y, cosf(a) * v, sinf(a) * v, life * uniform(ps, 0.6f, 1.0f), 0.0f, packColor(r, g, b, 1.0f))) { ps.dropped += n - i; return; }
+    }
+}
+
+static void burst(ParticleSystem& ps, const EffectEvent& e) {
+    switch (e.type) {
+    case EFFECT_OBSTACLE_BREAK: {
+        // fragments from all over the box, flung outwards from its centre, plus a flash of sparks
+        int pieces = std::min(24, std::max(6, (int)((e.w * e.h) * 4000.0f)));
+        for (int i = 0;i < pieces;++i) {
+            float ox = uniform(ps, -e.w, e.w), oy = uniform(ps, -e.h, e.h), v = uniform(ps, 0.2f, 0.6f);
+            float len = sqrtf(ox * ox + oy * oy) + 1e-4f, shade = uniform(ps, 0.35f, 0.6f);
+            if (!ps.debris.spawn(e.pos.x + ox, e.pos.y + oy, ox / len * v, oy / len * v, uniform(ps, 0.6f, 1.1f), uniform(ps, 0.006f, 0.016f), packColor(shade, shade * 0.75f, shade * 0.5f, 1.0f))) { ps.dropped += pieces - i; break; }
+        }
+        sparkBurst(ps, e.pos, 60, 0.2f, 0.9f, 0.6f, 1.0f, 0.7f, 0.3f);
+        break;
+    }
+    case EFFECT_COLLECT: sparkBurst(ps, e.pos, 40, 0.1f, 0.5f, 0.5f, 1.0f, 0.95f, 0.3f); break;
+    case EFFECT_SHIELD: sparkBurst(ps, e.pos, 50, 0.15f, 0.6f, 0.7f, 0.3f, 0.8f, 1.0f); break;
+    case EFFECT_SPEED: sparkBurst(ps, e.pos, 50, 0.15f, 0.6f, 0.7f, 1.0f, 0.3f, 0.9f); break;
+    case EFFECT_HIT: sparkBurst(ps, e.pos, 30, 0.1f, 0.4f, 0.4f, 1.0f, 0.25f, 0.2f); break;
+    }
+}
+
+void spawnEffects(ParticleSystem& ps, const EffectLog& log) {
+    if (log.total < ps.effectsSeen) ps.effectsSeen = 0;
+    uint64_t k = std::max(ps.effectsSeen, log.total > (uint64_t)EFFECT_RING ? log.total - EFFECT_RING : 0);
+    for (;k < log.total;++k) burst(ps, log.ring[k % EFFECT_RING]);
+    ps.effectsSeen = log.total;
+}
+
+void emitExhaust(ParticleSystem& ps, float x, float y, float angleDeg, float dt) {
+    // the rocket's backward direction: its local -y through the same rotation as DrawList::pushTransform
+    float a = angleDeg * (float)M_PI / 180.0f, bx = sinf(a), by = -cosf(a);
+    ps.exhaustCarry += EXHAUST_RATE * dt;
+    int n = (int)ps.exhaustCarry;
+    ps.exhaustCarry -= (float)n;
+    for (int i = 0;i < n;++i) {
+        float v = uniform(ps, 0.3f, 0.5f), side = uniform(ps, -0.08f, 0.08f), heat = uniform(ps, 0.0f, 1.0f);
+        if (!ps.sparks.spawn(x + bx * EXHAUST_NOZZLE, y + by * EXHAUST_NOZZLE, bx * v - by * side, by * v + bx * side, uniform(ps, 0.25f, 0.5f), 0.0f, packColor(1.0f, 0.35f + 0.45f * heat, 0.1f * heat, 0.9f))) { ps.dropped += n - i; break; }
+    }
+}
+
+void updateParticles(ParticleSystem& ps, float dt) {
+    ps.sparks.update(dt, expf(-SPARK_DRAG * dt), 0.0f);
+    ps.debris.update(dt, expf(-DEBRIS_DRAG * dt), 0.0f);
+}
+
+void drawParticles(const ParticleSystem& ps, DrawList& dl) {
+    const ParticlePool& s = ps.sparks;
+    dl.pointSize(3.0f);
+    dl.reservePoints(std::max(s.live, SPARK_DRAW_RESERVE));
+    if (s.live) {
+        // alpha fades out over the particle's life; colours are bytes r, g, b, a, so a is byte 3
+        uint32_t* faded = dl.arena().alloc<uint32_t>(s.live);
+        for (size_t i = 0;i < s.live;++i) {
+            uint8_t c[4]; memcpy(c, &s.rgba[i], 4);
+            c[3] = (uint8_t)(c[3] * std::max(0.0f, 1.0f - s.age[i] / s.life[i]));
+            memcpy(&faded[i], c, 4);
+        }
+        dl.points(s.x.data(), s.y.data(), faded, s.live);
+    }
+    dl.pointSize(1.0f);
+    const ParticlePool& d = ps.debris;
+    if (d.live) {
+        dl.begin(PRIM_QUADS);
+        for (size_t i = 0;i < d.live;++i) {
+            uint8_t c[4]; memcpy(c, &d.rgba[i], 4);
+            float left = std::max(0.0f, 1.0f - d.age[i] / d.life[i]);
+            dl.color(c[0] / 255.0f, c[1] / 255.0f, c[2] / 255.0f, left);
+            // oriented along the flight direction, turning as it ages and shrinking as it fades
+            float speed = sqrtf(d.vx[i] * d.vx[i] + d.vy[i] * d.vy[i]) + 1e-6f, spin = d.age[i] * DEBRIS_SPIN;
+            float ux = d.vx[i] / speed, uy = d.vy[i] / speed, cs = cosf(spin), sn = sinf(spin);
+            float h = d.size[i] * (0.4f + 0.6f * left);
+            float ax = (ux * cs - uy * sn) * h, ay = (uy * cs + ux * sn) * h; // half of one side; the other is (-ay, ax)
+            dl.vertex(d.x[i] + ax - ay, d.y[i] + ay + ax);
+            dl.vertex(d.x[i] - ax - ay, d.y[i] - ay + ax);
+            dl.vertex(d.x[i] - ax + ay, d.y[i] - ay - ax);
+            dl.vertex(d.x[i] + ax + ay, d.y[i] + ay - ax);
+        }
+        dl.end();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// =====================
+// Particle effects: thruster exhaust, obstacle break-up and pickup bursts. Purely visual: the renderer spawns
+// them from the effects the simulation logs (GameState::effects) and nothing flows back, so replays and the
+// simulation's determinism are untouched. Each pool allocates its capacity up front and keeps the live
+// particles packed at the front of struct-of-arrays columns: spawning appends (and fails once the pool is
+// full), integration is one SIMD pass over the live range (integrateParticles), and an expired particle is
+// replaced by the last one. A steady frame therefore neither allocates nor touches dead slots.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "DrawList.h"
+#include "GameCore.h"
+
+const size_t PARTICLE_BUDGET = 100000; // sparks and exhaust, drawn as points
+const size_t DEBRIS_BUDGET = 4096;     // obstacle fragments, drawn as quads
+
+// a colour as DrawList::points() takes it: the bytes r, g, b, a in memory order
+inline uint32_t packColor(float r, float g, float b, float a) {
+    uint8_t c[4] = { (uint8_t)(r * 255.0f + 0.5f), (uint8_t)(g * 255.0f + 0.5f), (uint8_t)(b * 255.0f + 0.5f), (uint8_t)(a * 255.0f + 0.5f) };
+    uint32_t v; memcpy(&v, c, 4); return v;
+}
+
+struct ParticlePool {
+    // positions and velocities in world units; age and life in seconds; size is a half extent (debris only)
+    std::vector<float> x, y, vx, vy, age, life, size;
+    std::vector<uint32_t> rgba;
+    size_t live = 0; // [0, live) of every column is in use
+
+    explicit ParticlePool(size_t capacity) : x(capacity), y(capacity), vx(capacity), vy(capacity), age(capacity), life(capacity), size(capacity), rgba(capacity) {}
+    size_t capacity() const { return x.size(); }
+    // false (and nothing spawned) when the pool is full
+    bool spawn(float px, float py, float pvx, float pvy, float lifetime, float halfSize, uint32_t color);
+    // moves every particle dt seconds (velocity times damping, plus gravity, as in integrateParticles) and
+    // drops the ones past their life
+    void update(float dt, float damping, float gravity);
+    void clear() { live = 0; }
+};
+
+struct ParticleSystem {
+    ParticlePool sparks{ PARTICLE_BUDGET }, debris{ DEBRIS_BUDGET };
+    uint64_t effectsSeen = 0;  // GameState::effects total up to which bursts were spawned
+    float exhaustCarry = 0.0f; // fraction of an exhaust particle owed to the next frame
+    uint32_t rng = 0x2545F491u;
+    size_t dropped = 0;        // spawns refused because a pool was full
+};
+
+// spawns a burst for every effect logged since the last call (at most the log's ring, EFFECT_RING). A log
+// whose total went backwards belongs to a new GameState and is followed from its start.
+void spawnEffects(ParticleSystem& ps, const EffectLog& log);
+// exhaust over dt seconds from a rocket at (x, y) (world) facing angleDeg (0 = up, as FramePose::playerAngle)
+void emitExhaust(ParticleSystem& ps, float x, float y, float angleDeg, float dt);
+// advances both pools by dt seconds
+void updateParticles(ParticleSystem& ps, float dt);
+// sparks as points fading with age, debris as shrinking, tumbling quads, through dl's current transform and
+// layer; the faded colours go in dl's arena
+void drawParticles(const ParticleSystem& ps, DrawList& dl);
@@ -0,0 +1,123 @@
+#include "PathSystem.h"
+
+#include <algorithm>
+
+#include "JobSystem.h"
+
+// forward-difference steps per Bezier segment when measuring; the table is resampled from this polyline
+static const int MEASURE_STEPS = 64;
+// table entries per path at most (a path 16 world units long still gets TABLE_STEP spacing)
+static const size_t MAX_TABLE_ENTRIES = 4096;
+
+// =====================
+// Building
+// =====================
+
+int PathSet::addBezier(const Vec2* points, size_t count, bool closed) {
+    if (count < 4 || (count - 1) % 3 != 0) return -1;
+    for (size_t i = 0;i < count;++i) if (!std::isfinite(points[i].x) || !std::isfinite(points[i].y)) return -1;
+    PathDef def; def.firstPoint = (uint32_t)ctrl.size(); def.segments = (uint32_t)((count - 1) / 3); def.flags = closed ? (uint32_t)PATH_CLOSED : 0u;
+    ctrl.insert(ctrl.end(), points, points + count);
+    defs.push_back(def);
+    buildTable(def);
+    return (int)defs.size() - 1;
+}
+
+int PathSet::addCatmullRom(const Vec2* pts, size_t count, bool closed) {
+    if (count < 2) return -1;
+    // span i runs from pts[i] to pts[i + 1] with tangents (next - previous) / 2, i.e. Bezier handles a sixth of
+    // the way along them; an open spline repeats its end points as their own neighbours
+    const size_t n = count, spans = closed ? n : n - 1;
+    auto at = [&](long i) { return closed ? pts[((i % (long)n) + (long)n) % (long)n] : pts[std::min(std::max(i, 0L), (long)n - 1)]; };
+    std::vector<Vec2> bez;
+    bez.reserve(3 * spans + 1);
+    bez.push_back(pts[0]);
+    for (size_t i = 0;i < spans;++i) {
+        Vec2 p0 = at((long)i - 1), p1 = at((long)i), p2 = at((long)i + 1), p3 = at((long)i + 2);
+        bez.push_back(Vec2(p1.x + (p2.x - p0.x) / 6.0f, p1.y + (p2.y - p0.y) / 6.0f));
+        bez.push_back(Vec2(p2.x - (p3.x - p1.x) / 6.0f, p2.y - (p3.y - p1.y) / 6.0f));
+        bez.push_back(p2);
+    }
+    return addBezier(bez.data(), bez.size(), closed);
+}
+
+bool PathSet::assign(const Vec2* points, size_t pointCount, const PathDef* saved, size_t pathCount) {
+    clear();
+    for (size_t p = 0;p < pathCount;++p) {
+        const PathDef& d = saved[p];
+        if (d.segments == 0 || d.segments > (1u << 20) || d.firstPoint > pointCount || 3 * (size_t)d.segments + 1 > pointCount - d.firstPoint ||
+            addBezier(points + d.firstPoint, 3 * (size_t)d.segments + 1, (d.flags & PATH_CLOSED) != 0) < 0) { clear(); return false; }
+    }
+    return true;
+}
+
+void PathSet::clear() {
+    ctrl.clear(); defs.clear(); tables.clear(); tableX.clear(); tableY.clear();
+}
+
+void PathSet::buildTable(const PathDef& def) {
+    // the polyline through every segment at MEASURE_STEPS steps, by forward differencing the cubic
+    // p(t) = a t^3 + b t^2 + c t + d: with step h the differences start at a h^3 + b h^2 + c h, 6 a h^3 + 2 b h^2
+    // and 6 a h^3, and each step is three additions
+    const Vec2* q = &ctrl[def.firstPoint];
+    const float h = 1.0f / MEASURE_STEPS, h2 = h * h, h3 = h2 * h;
+    std::vector<float> px, py, len;
+    px.reserve(def.segments * MEASURE_STEPS + 1); py.reserve(px.capacity()); len.reserve(px.capacity());
+    px.push_back(q[0].x); py.push_back(q[0].y); len.push_back(0.0f);
+    for (uint32_t s = 0;s < def.segments;++s, q += 3) {
+        float ax = -q[0].x + 3 * q[1].x - 3 * q[2].x + q[3].x, ay = -q[0].y + 3 * q[1].y - 3 * q[2].y + q[3].y;
+        float bx = 3 * q[0].x - 6 * q[1].x + 3 * q[2].x, by = 3 * q[0].y - 6 * q[1].y + 3 * q[2].y;
+        float cx = 3 * (q[1].x - q[0].x), cy = 3 * (q[1].y - q[0].y);
+        float fx = q[0].x, fy = q[0].y;
+        float d1x = ax * h3 + bx * h2 + cx * h, d1y = ay * h3 + by * h2 + cy * h;
+        float d2x = 6 * ax * h3 + 2 * bx * h2, d2y = 6 * ay * h3 + 2 * by * h2;
+        const float d3x = 6 * ax * h3, d3y = 6 * ay * h3;
+        for (int i = 1;i <= MEASURE_STEPS;++i) {
+            fx += d1x; fy += d1y; d1x += d2x; d1y += d2y; d2x += d3x; d2y += d3y;
+            if (i == MEASURE_STEPS) { fx = q[3].x; fy = q[3].y; } // no drift into the next segment
+            float dx = fx - px.back(), dy = fy - py.back();
+            len.push_back(len.back() + sqrtf(dx * dx + dy * dy));
+            px.push_back(fx); py.push_back(fy);
+        }
+    }
+
+    // resample at even distances along the polyline
+    Table t;
+    t.length = len.back();
+    size_t count = std::min(MAX_TABLE_ENTRIES, std::max((size_t)2, (size_t)ceilf(t.length / TABLE_STEP) + 1));
+    float step = t.length / (float)(count - 1);
+    t.first = (uint32_t)tableX.size(); t.count = (uint32_t)count;
+    t.invStep = step > 0.0f ? 1.0f / step : 0.0f;
+    t.period = (def.flags & PATH_CLOSED) ? t.length : 2.0f * t.length;
+    t.invPeriod = t.period > 0.0f ? 1.0f / t.period : 0.0f;
+    size_t j = 0;
+    for (size_t k = 0;k < count;++k) {
+        float d = k + 1 < count ? step * (float)k : t.length;
+        while (j + 2 < len.size() && len[j + 1] < d) ++j;
+        float span = len[j + 1] - len[j], f = span > 0.0f ? std::min(1.0f, std::max(0.0f, (d - len[j]) / span)) : 0.0f;
+        tableX.push_back(px[j] + (px[j + 1] - px[j]) * f);
+        tableY.push_back(py[j] + (py[j + 1] - py[j]) * f);
+    }
+    tables.push_back(t);
+}
+
+// =====================
+// Following
+// =====================
+
+// followers per job range; only big stores are worth splitting
+static const size_t MOVER_GRAIN = 8192;
+
+void advanceMovers(const PathSet& paths, const MoverStore& m, float* dist, float* x, float* y, size_t begin, size_t end, float dt) {
+    for (size_t i = begin;i < end;++i) {
+        const int p = (int)m.path[i];
+        const float d = paths.wrap(p, dist[i] + m.speed[i] * dt);
+        dist[i] = d;
+        Vec2 at = paths.sample(p, d);
+        x[i] = m.originX[i] + at.x; y[i] = m.originY[i] + at.y;
+    }
+}
+
+void advanceMovers(const PathSet& paths, MoverStore& m, float dt) {
+    jobSystem().parallelFor(m.size(), MOVER_GRAIN, [&](size_t b, size_t e) { advanceMovers(paths, m, m.dist.data(), m.x.data(), m.y.data(), b, e, dt); });
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+// =====================
+// Path engine: piecewise cubic Bezier paths (given as control points, or as a Catmull-Rom spline through
+// points) and the entities that follow them. Each path is resampled once into points evenly spaced along its
+// length (an arc-length table), so the point at distance d is one lerp between two table entries: constant
+// speed whatever the curve's parameterization, and no curve evaluation per tick. Tables are built by forward
+// differencing each segment (three vector additions per step) and measuring the resulting polyline.
+//
+// A follower's distance lives in [0, period): closed paths are travelled round and round (period = length),
+// open ones back and forth (period = twice the length), so nothing ever jumps.
+// =====================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EntityStore.h"
+#include "Vec2.h"
+
+enum PathFlags : uint32_t { PATH_CLOSED = 1 };
+
+// one path in PathSet::points(): 3 * segments + 1 Bezier control points from firstPoint (p0 c0 c1 p1 c2 c3 p2 ...)
+struct PathDef { uint32_t firstPoint, segments, flags; };
+
+class PathSet {
+public:
+    // world units between table entries; chords this short are within a hair of the curve at any size on screen
+    static constexpr float TABLE_STEP = 0.004f;
+
+    // control points p0 c0 c1 p1 ... (3 * segments + 1 of them); returns the path id, -1 if count does not fit
+    int addBezier(const Vec2* ctrl, size_t count, bool closed);
+    // uniform Catmull-Rom spline through count >= 2 points (a closed one returns to the first); returns the path id
+    int addCatmullRom(const Vec2* pts, size_t count, bool closed);
+    // replaces every path with saved definitions; false (leaving the set empty) if they do not fit the points
+    bool assign(const Vec2* ctrl, size_t pointCount, const PathDef* defs, size_t pathCount);
+    void clear();
+
+    size_t size() const { return defs.size(); }
+    float length(int path) const { return tables[path].length; }
+    float period(int path) const { return tables[path].period; }
+    bool closed(int path) const { return (defs[path].flags & PATH_CLOSED) != 0; }
+
+    // d modulo period (one step past either end costs a compare, not a floor)
+    float wrap(int path, float d) const {
+        const Table& t = tables[path];
+        if (d >= t.period) d -= t.period; else if (d < 0.0f) d += t.period;
+        if (d >= t.period || d < 0.0f) d -= t.period * floorf(d * t.invPeriod);
+        return d < t.period && d >= 0.0f ? d : 0.0f; // rounding at the seam, or a path of length 0
+    }
+
+    // point at distance d, taken modulo period (so the way back along an open path follows the first period)
+    Vec2 sample(int path, float d) const {
+        const Table& t = tables[path];
+        d = wrap(path, d);
+        if (d > t.length) d = t.period - d;
+        float u = d * t.invStep;
+        int k = u > 0.0f ? (int)u : 0;
+        if (k > (int)t.count - 2) k = (int)t.count - 2;
+        float f = u - (float)k;
+        const float* x = &tableX[t.first + k]; const float* y = &tableY[t.first + k];
+        return Vec2(x[0] + (x[1] - x[0]) * f, y[0] + (y[1] - y[0]) * f);
+    }
+
+    // the saved form
+    const std::vector<Vec2>& points() const { return ctrl; }
+    const std::vector<PathDef>& definitions() const { return defs; }
+
+private:
+    struct Table { uint32_t first, count; float length, period, invPeriod, invStep; };
+
+    void buildTable(const PathDef& def);
+
+    std::vector<Vec2> ctrl;
+    std::vector<PathDef> defs;
+    std::vector<Table> tables;
+    std::vector<float> tableX, tableY; // every path's table, back to back
+};
+
+// =====================
+// Path followers, struct of arrays: position = origin + the path's point at dist. dist advances by speed
+// (world units per second; negative runs backwards) and is kept in [0, period).
+// =====================
+struct MoverStore {
+    std::vector<uint32_t> path;
+    std::vector<float> originX, originY, dist, speed;
+    std::vector<float> x, y; // positions as of the last advanceMovers()
+
+    size_t size() const { return path.size(); }
+    void push(uint32_t p, const Vec2& origin, float d, float v, const Vec2& pos) {
+        path.push_back(p); originX.push_back(origin.x); originY.push_back(origin.y); dist.push_back(d); speed.push_back(v);
+        x.push_back(pos.x); y.push_back(pos.y);
+    }
+    // swap-and-pop
+    void remove(size_t i) {
+        size_t last = size() - 1;
+        path[i] = path[last]; originX[i] = originX[last]; originY[i] = originY[last]; dist[i] = dist[last]; speed[i] = speed[last]; x[i] = x[last]; y[i] = y[last];
+        path.pop_back(); originX.pop_back(); originY.pop_back(); dist.pop_back(); speed.pop_back(); x.pop_back(); y.pop_back();
+    }
+    void clear() { path.clear(); originX.clear(); originY.clear(); dist.clear(); speed.clear(); x.clear(); y.clear(); }
+};
+
+// moving obstacles: half extents as in ObstacleStore
+struct MovingObstacleStore {
+    MoverStore motion;
+    std::vector<float> w, h;
+
+    size_t size() const { return motion.size(); }
+    void remove(size_t i) { motion.remove(i); size_t last = w.size() - 1; w[i] = w[last]; h[i] = h[last]; w.pop_back(); h.pop_back(); }
+    void clear() { motion.clear(); w.clear(); h.clear(); }
+};
+
+// moving collectibles: collected ones stay in the store, inactive, as in CollectibleStore
+struct MovingCollectibleStore {
+    MoverStore motion;
+    std::vector<float> phase;
+    ActiveBits active;
+
+    size_t size() const { return motion.size(); }
+    void clear() { motion.clear(); phase.clear(); active.clear(); }
+};
+
+// everything in a level that follows a path (the target keeps its own path, see GameState)
+struct LevelMotion {
+    PathSet paths;
+    MovingObstacleStore obstacles;
+    MovingCollectibleStore collectibles;
+
+    bool empty() const { return paths.size() == 0 && obstacles.size() == 0 && collectibles.size() == 0; }
+    void clear() { paths.clear(); obstacles.clear(); collectibles.clear(); }
+};
+
+// advances every follower dt seconds along its path and writes its position (dt 0 just places them);
+// element-wise, so stores of tens of thousands are split across the job system with identical results
+void advanceMovers(const PathSet& paths, MoverStore& movers, float dt);
+// followers begin..end of movers, with dist, x and y kept elsewhere (VecEnv keeps one copy per instance)
+void advanceMovers(const PathSet& paths, const MoverStore& movers, float* dist, float* x, float* y, size_t begin, size_t end, float dt);
@@ -0,0 +1,82 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static const size_t MAX_TRACE_EVENTS = 4000000;
+
+static const char* ZONE_NAMES[ZONE_COUNT] = {
+    "frame", "update", "stream", "snapshot", "build scene", "background", "panels", "obstacles",
+    "collectibles", "powerups", "player", "particles", "submit", "swap", "gpu draw"
+};
+
+const char* profileZoneName(ProfileZone zone) { return zone >= 0 && zone < ZONE_COUNT ? ZONE_NAMES[zone] : "?"; }
+
+Profiler::Profiler() : origin(Clock::now()) {
+    for (int z = 0;z < ZONE_COUNT;++z) { openUs[z] = 0.0; frameMs[z] = 0.0; }
+    for (auto& h : history) for (float& v : h) v = 0.0f;
+    scratch.reserve(HISTORY);
+}
+
+void Profiler::beginFrame() {
+    for (double& ms : frameMs) ms = 0.0;
+    enter(ZONE_FRAME);
+}
+
+void Profiler::endFrame() {
+    leave(ZONE_FRAME);
+    for (int z = 0;z < ZONE_COUNT;++z) history[z][historyNext] = (float)frameMs[z];
+    historyNext = (historyNext + 1) % HISTORY;
+    if (historyCount < HISTORY) ++historyCount;
+}
+
+void Profiler::enter(ProfileZone zone) { openUs[zone] = nowUs(); }
+
+void Profiler::leave(ProfileZone zone) {
+    double end = nowUs();
+    double dur = end - openUs[zone];
+    frameMs[zone] += dur * 0.001;
+    if (tracing && events.size() < MAX_TRACE_EVENTS) { TraceEvent e = { (uint8_t)zone, TRACE_RENDER, openUs[zone], dur }; events.push_back(e); }
+}
+
+void Profiler::addSample(ProfileZone zone, double ms, double startUs, int traceThread) {
+    // GPU results arrive a few frames late; they count toward the frame in which they were read back
+    frameMs[zone] += ms;
+    if (tracing && events.size() < MAX_TRACE_EVENTS) { TraceEvent e = { (uint8_t)zone, (uint8_t)traceThread, startUs, ms * 1000.0 }; events.push_back(e); }
+}
+
+ZoneStats Profiler::stats(ProfileZone zone) const {
+    ZoneStats s;
+    if (historyCount == 0) return s;
+    scratch.assign(history[zone], history[zone] + historyCount);
+    double sum = 0.0;
+    for (float v : scratch) sum += v;
+    s.samples = historyCount;
+    s.avgMs = sum / historyCount;
+    s.minMs = *std::min_element(scratch.begin(), scratch.end());
+    size_t k = (size_t)(0.99 * (historyCount - 1) + 0.5);
+    std::nth_element(scratch.begin(), scratch.begin() + k, scratch.end());
+    s.p99Ms = scratch[k];
+    return s;
+}
+
+bool Profiler::writeTrace(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    // trace-event format: complete ("X") events in microseconds, one track per thread id
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    static const char* trackNames[TRACE_THREAD_COUNT] = { "CPU", "GPU", "simulation" };
+    static const char* trackCats[TRACE_THREAD_COUNT] = { "cpu", "gpu", "sim" };
+    for (int t = 0;t < TRACE_THREAD_COUNT;++t)
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", t ? ",\n" : "", t, trackNames[t]);
+    for (const TraceEvent& e : events)
+        fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+            ZONE_NAMES[e.zone], trackCats[e.thread], e.startUs, e.durUs, e.thread);
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// =====================
+// Frame profiler. Scoped CPU zones (PROFILE_SCOPE) and externally measured samples (GPU timer
+// queries, the simulation thread's zones) are summed per zone per frame and kept in a rolling window
+// for min/avg/p99 readouts.
+// Optionally records every zone instance as a Chrome trace event (chrome://tracing, Perfetto).
+// No GL in here; the GPU side feeds in through addSample(). Not thread-safe: only the render thread calls
+// it, other threads measure their own times and hand them over.
+// =====================
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+enum ProfileZone {
+    ZONE_FRAME = 0,
+    ZONE_UPDATE,
+    ZONE_STREAM,   // ChunkStreamer::update (installs and requests chunks; never waits for the disk)
+    ZONE_SNAPSHOT, // captureSnapshot: culls the level to the view and copies it for the scene
+    ZONE_BUILD_SCENE,
+    ZONE_BACKGROUND,
+    ZONE_PANELS,
+    ZONE_OBSTACLES,
+    ZONE_COLLECTIBLES,
+    ZONE_POWERUPS,
+    ZONE_PLAYER,
+    ZONE_PARTICLES, // particle spawn, integration and drawing (src/Particles.h)
+    ZONE_SUBMIT,
+    ZONE_SWAP,
+    ZONE_GPU_DRAW, // GPU time of the frame's draws (timer query)
+    ZONE_COUNT
+};
+
+const char* profileZoneName(ProfileZone zone);
+
+// trace tracks: zones timed on the render thread, GPU timer queries, and zones timed on the simulation thread
+enum TraceThread { TRACE_RENDER = 0, TRACE_GPU, TRACE_SIM, TRACE_THREAD_COUNT };
+
+struct ZoneStats { double minMs = 0, avgMs = 0, p99Ms = 0; int samples = 0; };
+
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const int HISTORY = 240; // frames in the rolling window
+
+    Profiler();
+
+    // frame boundaries: zone totals of the finished frame go into the history
+    void beginFrame();
+    void endFrame();
+
+    void enter(ProfileZone zone);
+    void leave(ProfileZone zone);
+    // adds a duration measured elsewhere; startUs places it in the trace (microseconds, see nowUs())
+    void addSample(ProfileZone zone, double ms, double startUs, int traceThread);
+
+    ZoneStats stats(ProfileZone zone) const;
+    double nowUs() const { return std::chrono::duration<double, std::micro>(Clock::now() - origin).count(); }
+
+    // trace recording; events are capped so a forgotten session can't eat all memory
+    void startTrace() { tracing = true; }
+    bool traceEnabled() const { return tracing; }
+    bool writeTrace(const char* path) const;
+
+private:
+    struct TraceEvent { uint8_t zone; uint8_t thread; double startUs, durUs; };
+
+    Clock::time_point origin;
+    double openUs[ZONE_COUNT];
+    double frameMs[ZONE_COUNT]; // totals of the frame in progress
+    float history[ZONE_COUNT][HISTORY];
+    int historyCount = 0, historyNext = 0;
+    mutable std::vector<float> scratch;
+
+    bool tracing = false;
+    std::vector<TraceEvent> events;
+};
+
+// process-wide instance used by PROFILE_SCOPE
+Profiler& profiler();
+
+struct ProfileScope {
+    ProfileZone zone;
+    explicit ProfileScope(ProfileZone z) : zone(z) { profiler().enter(zone); }
+    ~ProfileScope() { profiler().leave(zone); }
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(zone)
@@ -0,0 +1,260 @@
+#include "Replay.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "LevelFile.h"
+
+const char* replayStatusText(ReplayStatus status) {
+    switch (status) {
+    case REPLAY_OK: return "ok";
+    case REPLAY_OPEN_FAILED: return "could not open file";
+    case REPLAY_WRITE_FAILED: return "could not write file";
+    case REPLAY_NOT_A_REPLAY: return "not a replay file";
+    case REPLAY_NEWER_VERSION: return "replay was recorded by a newer version";
+    case REPLAY_CORRUPT: return "replay file is damaged";
+    case REPLAY_LEVEL_FAILED: return "could not load or save the replay's level";
+    case REPLAY_LEVEL_CHANGED: return "the level file has changed since the replay was recorded";
+    }
+    return "unknown error";
+}
+
+ReplayOutcome replayOutcome(const GameState& s, uint64_t ticks) {
+    ReplayOutcome o;
+    o.ticks = ticks; o.score = s.score; o.lives = s.lives; o.gameTimer = s.gameTimer;
+    o.flags = (s.gameStarted ? (uint32_t)REPLAY_STARTED : 0u) | (s.gameOver ? (uint32_t)REPLAY_OVER : 0u) | (s.gameWin ? (uint32_t)REPLAY_WON : 0u);
+    return o;
+}
+
+bool sameOutcome(const ReplayOutcome& a, const ReplayOutcome& b) {
+    return a.ticks == b.ticks && a.score == b.score && a.lives == b.lives && memcmp(&a.gameTimer, &b.gameTimer, sizeof(float)) == 0 && a.flags == b.flags;
+}
+
+// =====================
+// Files
+// =====================
+
+ReplayStatus readReplay(const char* path, Replay& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return REPLAY_OPEN_FAILED;
+    ReplayHeader h;
+    ReplayStatus st = REPLAY_OK;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, "SPRP", 4) != 0) st = REPLAY_NOT_A_REPLAY;
+    else if (h.version > REPLAY_FORMAT_VERSION) st = REPLAY_NEWER_VERSION;
+    else if (h.levelBytes > 4096 || !(h.dt > 0.0f)) st = REPLAY_CORRUPT;
+    else {
+        Replay r; r.version = h.version; r.seed = h.seed; r.dt = h.dt;
+        r.levelPath.resize(h.levelBytes); r.stream.resize(h.streamBytes);
+        if ((h.levelBytes && fread(&r.levelPath[0], 1, h.levelBytes, f) != h.levelBytes) ||
+            (h.streamBytes && fread(r.stream.data(), 1, h.streamBytes, f) != h.streamBytes) ||
+            fread(&r.outcome, sizeof(r.outcome), 1, f) != 1) st = REPLAY_CORRUPT;
+        else out = std::move(r);
+    }
+    fclose(f);
+    return st;
+}
+
+ReplayStatus writeReplay(const char* path, const Replay& r) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return REPLAY_OPEN_FAILED;
+    ReplayHeader h;
+    memcpy(h.magic, "SPRP", 4); h.version = r.version; h.seed = r.seed; h.dt = r.dt;
+    h.levelBytes = (uint32_t)r.levelPath.size(); h.streamBytes = (uint32_t)r.stream.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+        fwrite(r.levelPath.data(), 1, r.levelPath.size(), f) == r.levelPath.size() &&
+        fwrite(r.stream.data(), 1, r.stream.size(), f) == r.stream.size() &&
+        fwrite(&r.outcome, sizeof(r.outcome), 1, f) == 1;
+    if (fclose(f) != 0) ok = false;
+    return ok ? REPLAY_OK : REPLAY_WRITE_FAILED;
+}
+
+bool hashLevelFile(const char* path, uint64_t& hash) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> buffer((size_t)1 << 20);
+    uint64_t h = 0xCBF29CE484222325ull;
+    size_t n;
+    while ((n = fread(buffer.data(), 1, buffer.size(), f)) > 0) {
+        // whole buffers are a multiple of 8 bytes, so only the file's last read has a partial word
+        for (size_t i = 0;i < n;i += 8) {
+            uint64_t w = 0; memcpy(&w, buffer.data() + i, n - i < 8 ? n - i : 8);
+            h = (h ^ w) * 0x100000001B3ull;
+        }
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    hash = h;
+    return ok;
+}
+
+// =====================
+// Recording
+// =====================
+
+void ReplayRecorder::begin(uint32_t seed, float dt, const char* levelPath) {
+    replay = Replay();
+    replay.seed = seed; replay.dt = dt; replay.levelPath = levelPath ? levelPath : "";
+    tickCount = lastRecordTick = 0; holdX = holdY = 0.0f;
+    pendingRecorded.clear();
+}
+
+// 7 bits per byte, low bits first
+void ReplayRecorder::varint(uint64_t v) {
+    for (;;v >>= 7) {
+        if (v < 0x80) { replay.stream.push_back((uint8_t)v); break; }
+        replay.stream.push_back((uint8_t)(v | 0x80));
+    }
+}
+
+void ReplayRecorder::record(ReplayRecord kind) {
+    varint(tickCount - lastRecordTick); // ticks since the previous entry
+    lastRecordTick = tickCount;
+    replay.stream.push_back(kind);
+}
+
+void ReplayRecorder::levelLoaded() {
+    uint64_t hash = 0;
+    hashLevelFile(replay.levelPath.c_str(), hash); // just loaded, so readable; a failure only costs the check
+    record(REC_LOAD);
+    const uint8_t* p = (const uint8_t*)&hash; replay.stream.insert(replay.stream.end(), p, p + sizeof(hash));
+    pendingRecorded.clear(); // playback loads the level whole, with nothing pending
+}
+
+void ReplayRecorder::recordFloats(ReplayRecord kind, float a, float b) {
+    record(kind);
+    const uint8_t* p = (const uint8_t*)&a; replay.stream.insert(replay.stream.end(), p, p + sizeof(float));
+    p = (const uint8_t*)&b; replay.stream.insert(replay.stream.end(), p, p + sizeof(float));
+}
+
+void ReplayRecorder::tick(const Inputs& in, const GameState& s) {
+    for (size_t i = 0;i < in.count;++i) {
+        const InputEvent& e = in.events[i];
+        switch (e.type) {
+        case INPUT_MOVE:  recordFloats(REC_MOVE, e.dx, e.dy); break;
+        case INPUT_KEY:   record(REC_KEY); replay.stream.push_back(e.key); break;
+        case INPUT_CLICK: recordFloats(REC_CLICK, e.pos.x, e.pos.y); break;
+        }
+    }
+    if (in.moveX != holdX || in.moveY != holdY) { holdX = in.moveX; holdY = in.moveY; recordFloats(REC_HOLD, holdX, holdY); }
+    // bands still streaming in hold the rocket (bandsPending()); only a streamed session ever has any
+    pendingNow.clear();
+    for (int b = 0;b < s.chunks.bandCount();++b) pendingNow.push_back(s.chunks.pending(b));
+    while (!pendingNow.empty() && !pendingNow.back()) pendingNow.pop_back();
+    if (pendingNow != pendingRecorded) { recordPending(); pendingRecorded = pendingNow; }
+    ++tickCount;
+}
+
+void ReplayRecorder::recordPending() {
+    record(REC_PENDING);
+    size_t ranges = 0;
+    for (size_t b = 0;b < pendingNow.size();++b) if (pendingNow[b] && (b == 0 || !pendingNow[b - 1])) ++ranges;
+    varint(ranges);
+    for (size_t b = 0, end = 0;b < pendingNow.size();) {
+        if (!pendingNow[b]) { ++b; continue; }
+        size_t start = b;
+        while (b < pendingNow.size() && pendingNow[b]) ++b;
+        varint(start - end); varint(b - start);
+        end = b;
+    }
+}
+
+ReplayStatus ReplayRecorder::write(const char* path, const GameState& s) const {
+    Replay r = replay;
+    r.outcome = replayOutcome(s, tickCount);
+    return writeReplay(path, r);
+}
+
+// =====================
+// Playback
+// =====================
+
+namespace {
+struct StreamReader {
+    const uint8_t* p; const uint8_t* end;
+    bool varint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0;shift < 64 && p < end;shift += 7) { uint8_t b = *p++; v |= (uint64_t)(b & 0x7F) << shift; if (!(b & 0x80)) return true; }
+        return false;
+    }
+    bool byte(uint8_t& v) { if (p >= end) return false; v = *p++; return true; }
+    bool u64(uint64_t& v) { if (end - p < (long)sizeof(v)) return false; memcpy(&v, p, sizeof(v)); p += sizeof(v); return true; }
+    bool floats(float& a, float& b) {
+        if (end - p < 2 * (long)sizeof(float)) return false;
+        memcpy(&a, p, sizeof(float)); memcpy(&b, p + sizeof(float), sizeof(float)); p += 2 * sizeof(float);
+        return true;
+    }
+};
+}
+
+// marks exactly the recorded bands pending; their chunks stay resident, but nothing that tests for pending
+// bands (a move, a placement, generation) looks past them
+static bool readPending(StreamReader& in, GameState& s) {
+    uint64_t ranges = 0;
+    if (!in.varint(ranges)) return false;
+    for (int b = 0;b < s.chunks.bandCount();++b) s.chunks.setPending(b, false);
+    for (uint64_t i = 0, end = 0;i < ranges;++i) {
+        uint64_t skip = 0, length = 0;
+        if (!in.varint(skip) || !in.varint(length) || skip > (1u << 20) || length > (1u << 20) || end + skip + length > (1u << 20)) return false;
+        for (uint64_t b = end + skip;b < end + skip + length;++b) s.chunks.setPending((int)b, true);
+        end += skip + length;
+    }
+    return true;
+}
+
+ReplayStatus playReplay(const Replay& r, const char* levelPath, const char* scratchPath, GameState& s, ReplayOutcome& outcome) {
+    if (!levelPath) levelPath = r.levelPath.c_str();
+    initGame(s, r.seed);
+    StreamReader in = { r.stream.data(), r.stream.data() + r.stream.size() };
+    uint64_t delta = 0, nextTick = 0;
+    bool more = in.p < in.end;
+    if (more && !in.varint(delta)) return REPLAY_CORRUPT;
+    nextTick = delta;
+    std::vector<InputEvent> events;
+    float holdX = 0.0f, holdY = 0.0f;
+    bool saved = false;
+    ReplayStatus st = REPLAY_OK;
+    // records stamped with the tick count itself came after the last tick (a load just before quitting)
+    for (uint64_t t = 0;t <= r.outcome.ticks && st == REPLAY_OK;++t) {
+        events.clear();
+        for (;more && nextTick == t && st == REPLAY_OK;) {
+            uint8_t kind = 0, key = 0; float a = 0.0f, b = 0.0f;
+            if (!in.byte(kind)) { st = REPLAY_CORRUPT; break; }
+            switch (kind) {
+            case REC_MOVE:  if (in.floats(a, b)) events.push_back(moveInput(a, b)); else st = REPLAY_CORRUPT; break;
+            case REC_KEY:   if (in.byte(key)) events.push_back(keyInput(key)); else st = REPLAY_CORRUPT; break;
+            case REC_CLICK: if (in.floats(a, b)) events.push_back(clickInput(Vec2(a, b))); else st = REPLAY_CORRUPT; break;
+            case REC_HOLD:  if (!in.floats(holdX, holdY)) st = REPLAY_CORRUPT; break;
+            case REC_SAVE:
+#ifdef _WIN32
+                detachLevel(s); // the scratch file being replaced may be mapped
+#endif
+                if (saveLevel(s, scratchPath) == LEVEL_OK) saved = true; else st = REPLAY_LEVEL_FAILED;
+                break;
+            case REC_LOAD: {
+                // the recorded file is checked until the session's first save; from then on loads read playback's own save
+                uint64_t recorded = 0, now = 0;
+                if (r.version >= 2 && !in.u64(recorded)) { st = REPLAY_CORRUPT; break; }
+                if (r.version >= 2 && !saved && hashLevelFile(levelPath, now) && now != recorded) { st = REPLAY_LEVEL_CHANGED; break; }
+                if (loadLevel(s, saved ? scratchPath : levelPath) != LEVEL_OK) st = REPLAY_LEVEL_FAILED;
+                break;
+            }
+            case REC_PENDING: st = r.version >= 2 && readPending(in, s) ? st : REPLAY_CORRUPT; break;
+            default: st = REPLAY_CORRUPT; break;
+            }
+            more = in.p < in.end;
+            if (more) { if (in.varint(delta)) nextTick += delta; else st = REPLAY_CORRUPT; }
+        }
+        if (st != REPLAY_OK || t == r.outcome.ticks) break;
+        Inputs tickIn; tickIn.events = events.data(); tickIn.count = events.size(); tickIn.moveX = holdX; tickIn.moveY = holdY;
+        step(s, tickIn, r.dt);
+    }
+    if (st == REPLAY_OK && more) st = REPLAY_CORRUPT; // records past the end
+    if (saved) {
+#ifdef _WIN32
+        detachLevel(s);
+#endif
+        remove(scratchPath);
+    }
+    outcome = replayOutcome(s, r.outcome.ticks);
+    return st;
+}
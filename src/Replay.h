@@ -0,0 +1,106 @@
+#pragma once
+
+// =====================
+// Session replays. step() is deterministic given the seed, the tick length and each tick's inputs, so a
+// session is recorded as just those plus the level file it started from:
+//
+//   ReplayHeader | level path | record stream | ReplayOutcome
+//
+// The record stream only has entries for ticks where something happened. Each entry is the number of ticks
+// since the previous entry (LEB128), a ReplayRecord kind and its payload. Held arrow keys are recorded when
+// they change, not every tick. Saves and loads of the level file are recorded too. On playback a save goes
+// to a scratch file and later loads read it back, so a session that saved and reloaded replays the same.
+// A load carries a hash of the file it read, so playback refuses a level file that has changed since (a later
+// session saving over it, say) instead of playing on to a mismatch. With a streamed level, the bands still
+// loading hold the rocket back; they are recorded whenever they change, and playback, which loads the level
+// whole, marks the same bands pending on the same ticks.
+// The outcome (score, lives, timer) is stored with the recording so playback can check it.
+// =====================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameCore.h"
+
+const uint32_t REPLAY_FORMAT_VERSION = 2;
+
+struct ReplayHeader {
+    char magic[4];        // "SPRP"
+    uint32_t version;     // REPLAY_FORMAT_VERSION of the writer
+    uint32_t seed;        // initGame seed
+    float dt;             // seconds per tick, exactly as passed to step()
+    uint32_t levelBytes;  // length of the level path that follows (0: none, the session starts empty)
+    uint32_t streamBytes; // length of the record stream that follows
+};
+
+// state at the end of a session, compared field by field (the timer bit for bit)
+struct ReplayOutcome {
+    uint64_t ticks;
+    int32_t score, lives;
+    float gameTimer;
+    uint32_t flags; // REPLAY_STARTED | REPLAY_OVER | REPLAY_WON
+};
+enum ReplayOutcomeFlags : uint32_t { REPLAY_STARTED = 1, REPLAY_OVER = 2, REPLAY_WON = 4 };
+
+enum ReplayRecord : uint8_t {
+    REC_MOVE = 1, // float dx, dy
+    REC_KEY,      // uint8 key
+    REC_CLICK,    // float x, y (screen)
+    REC_HOLD,     // float moveX, moveY from this tick on
+    REC_SAVE,     // the level was saved to its file
+    REC_LOAD,     // the level was loaded from its file (or from the last save); version 2: uint64 hash of the file
+    REC_PENDING   // version 2: the bands pending from this tick on, as a LEB128 range count, then each range's
+                  // start (from the end of the previous one) and length
+};
+
+enum ReplayStatus { REPLAY_OK = 0, REPLAY_OPEN_FAILED, REPLAY_WRITE_FAILED, REPLAY_NOT_A_REPLAY, REPLAY_NEWER_VERSION, REPLAY_CORRUPT, REPLAY_LEVEL_FAILED,
+                    REPLAY_LEVEL_CHANGED };
+const char* replayStatusText(ReplayStatus status);
+
+ReplayOutcome replayOutcome(const GameState& s, uint64_t ticks);
+bool sameOutcome(const ReplayOutcome& a, const ReplayOutcome& b);
+
+struct Replay {
+    uint32_t version = REPLAY_FORMAT_VERSION;
+    uint32_t seed = 1;
+    float dt = 1.0f / 60.0f;
+    std::string levelPath;
+    std::vector<uint8_t> stream;
+    ReplayOutcome outcome = {};
+};
+
+ReplayStatus readReplay(const char* path, Replay& out);
+ReplayStatus writeReplay(const char* path, const Replay& replay);
+
+// FNV-1a over the file's 64-bit words (and its last partial one); false if it cannot be read
+bool hashLevelFile(const char* path, uint64_t& hash);
+
+// builds a replay as the session runs: begin() right after initGame, levelSaved()/levelLoaded() after a
+// successful save or load (of begin()'s level path), tick() with each tick's inputs and the state just before step()
+class ReplayRecorder {
+public:
+    void begin(uint32_t seed, float dt, const char* levelPath);
+    void levelSaved() { record(REC_SAVE); }
+    void levelLoaded();
+    void tick(const Inputs& in, const GameState& s);
+    // the recording with s as its outcome
+    ReplayStatus write(const char* path, const GameState& s) const;
+    uint64_t ticks() const { return tickCount; }
+
+private:
+    void varint(uint64_t v);
+    void record(ReplayRecord kind);
+    void recordFloats(ReplayRecord kind, float a, float b);
+    void recordPending();
+
+    Replay replay;
+    uint64_t tickCount = 0, lastRecordTick = 0;
+    float holdX = 0.0f, holdY = 0.0f;
+    // one flag per band, trailing clear bands dropped: as of this tick, and as playback will have them
+    std::vector<uint8_t> pendingNow, pendingRecorded;
+};
+
+// plays the replay as fast as step() goes, with no rendering, and fills in the outcome. levelPath overrides
+// the recorded level file (its contents still have to match); saves go to scratchPath, which is removed afterwards.
+ReplayStatus playReplay(const Replay& replay, const char* levelPath, const char* scratchPath, GameState& s, ReplayOutcome& outcome);
@@ -0,0 +1,574 @@
+#define _USE_MATH_DEFINES
+
+#include "Scene.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "ShapeCache.h"
+
+// =====================
+// Drawing helpers & primitives (the GL primitive each one maps to is noted; DrawList converts them to batches)
+// =====================
+
+static void drawQuad(DrawList& dl, float x, float y, float w, float h) { // GL_QUADS
+    dl.begin(PRIM_QUADS);
+    dl.vertex(x - w, y - h);
+    dl.vertex(x + w, y - h);
+    dl.vertex(x + w, y + h);
+    dl.vertex(x - w, y + h);
+    dl.end();
+}
+
+static void drawCircle(DrawList& dl, float cx, float cy, float r, int segs = 24) { // GL_TRIANGLE_FAN
+    dl.begin(PRIM_TRIANGLE_FAN);
+    dl.vertex(cx, cy);
+    for (const Vec2& u : shapeCache().circle(segs)) dl.vertex(cx + u.x * r, cy + u.y * r);
+    dl.end();
+}
+
+static void drawLine(DrawList& dl, float x1, float y1, float x2, float y2) { // GL_LINES
+    dl.begin(PRIM_LINES); dl.vertex(x1, y1); dl.vertex(x2, y2); dl.end();
+}
+
+static void drawLineStrip(DrawList& dl, const Vec2* pts, size_t n) { // GL_LINE_STRIP
+    dl.begin(PRIM_LINE_STRIP); for (size_t i = 0;i < n;++i) dl.vertex(pts[i].x, pts[i].y); dl.end();
+}
+
+static void drawLineLoop(DrawList& dl, const Vec2* pts, size_t n) { // GL_LINE_LOOP
+    dl.begin(PRIM_LINE_LOOP); for (size_t i = 0;i < n;++i) dl.vertex(pts[i].x, pts[i].y); dl.end();
+}
+
+static void drawPoint(DrawList& dl, float x, float y) { dl.begin(PRIM_POINTS); dl.vertex(x, y); dl.end(); } // GL_POINTS (allowed in earlier description)
+
+// heart (used for health and extra life powerup) - GL_POLYGON
+static void drawHeart(DrawList& dl, float x, float y, float size) {
+    dl.begin(PRIM_POLYGON);
+    for (const Vec2& u : shapeCache().heart) dl.vertex(x + u.x * size, y + u.y * size);
+    dl.end();
+}
+
+// star as GL_TRIANGLES (for collectibles) - uses GL_TRIANGLES primitive
+static void drawStarTriangles(DrawList& dl, float cx, float cy, float outerR) {
+    // one triangle per point: outer[i], inner[i], outer[i+1]
+    dl.begin(PRIM_TRIANGLES);
+    for (const Vec2& u : shapeCache().starTriangles) dl.vertex(cx + u.x * outerR, cy + u.y * outerR);
+    dl.end();
+}
+
+// score powerup drawn with GL_TRIANGLE_STRIP + GL_LINE_STRIP (two different primitives)
+static void drawScorePowerupShape(DrawList& dl, float cx, float cy, float s) {
+    // diamond using triangle strip
+    dl.begin(PRIM_TRIANGLE_STRIP);
+    dl.vertex(cx, cy + s);
+    dl.vertex(cx + s, cy);
+    dl.vertex(cx, cy - s);
+    dl.vertex(cx - s, cy);
+    dl.end();
+    // outline using line strip
+    Vec2* outline = dl.arena().alloc<Vec2>(5);
+    outline[0] = Vec2(cx, cy + s); outline[1] = Vec2(cx + s, cy); outline[2] = Vec2(cx, cy - s); outline[3] = Vec2(cx - s, cy); outline[4] = outline[0];
+    dl.color(0, 0, 0);
+    drawLineStrip(dl, outline, 5);
+}
+
+// shield icon: GL_POLYGON + GL_LINE_LOOP (two primitives)
+static void drawShieldIcon(DrawList& dl, float cx, float cy, float s) {
+    dl.begin(PRIM_POLYGON);
+    dl.vertex(cx - s * 0.5f, cy + s * 0.2f);
+    dl.vertex(cx + s * 0.5f, cy + s * 0.2f);
+    dl.vertex(cx + s * 0.25f, cy - s * 0.1f);
+    dl.vertex(cx, cy - s * 0.5f);
+    dl.vertex(cx - s * 0.25f, cy - s * 0.1f);
+    dl.end();
+    const std::vector<Vec2>& ring = shapeCache().circle(20);
+    dl.begin(PRIM_LINE_LOOP);
+    for (int i = 0;i < 20;i++) dl.vertex(cx + ring[i].x * s * 0.25f, cy + ring[i].y * s * 0.15f);
+    dl.end();
+}
+
+// obstacle primitive: GL_QUADS + GL_LINE_LOOP (2 primitives)
+static void drawObstacleIcon(DrawList& dl, float cx, float cy, float w, float h) {
+    dl.begin(PRIM_QUADS); dl.vertex(cx - w, cy - h); dl.vertex(cx + w, cy - h); dl.vertex(cx + w, cy + h); dl.vertex(cx - w, cy + h); dl.end();
+    Vec2* loop = dl.arena().alloc<Vec2>(4);
+    loop[0] = Vec2(cx - w, cy - h); loop[1] = Vec2(cx + w, cy - h); loop[2] = Vec2(cx + w, cy + h); loop[3] = Vec2(cx - w, cy + h);
+    drawLineLoop(dl, loop, 4);
+}
+
+// collectible icon: GL_TRIANGLES (star), GL_TRIANGLE_FAN (circle), GL_LINES (line) -> 3 different primitives
+static void drawCollectibleIcon(DrawList& dl, float cx, float cy, float s) {
+    dl.color(1.0f, 0.9f, 0.2f); drawStarTriangles(dl, cx, cy, s * 0.9f);
+    dl.color(1, 1, 1); drawCircle(dl, cx, cy, s * 0.25f, 12);
+    dl.color(0, 0, 0); drawLine(dl, cx - s * 0.6f, cy, cx + s * 0.6f, cy);
+}
+
+// =====================
+// Player (uses >=4 different primitives: GL_POLYGON, GL_TRIANGLES, GL_TRIANGLE_FAN, GL_LINES)
+// =====================
+static void drawPlayer(DrawList& dl, const FrameSnapshot& game) {
+    // Draw rocket centered at origin (local coordinates). Caller should translate/rotate to the player's world position.
+    // fuselage (GL_POLYGON)
+    dl.color(0.9f, 0.9f, 0.95f);
+    dl.begin(PRIM_POLYGON);
+    dl.vertex(0.0f, 0.10f);
+    dl.vertex(0.035f, 0.06f);
+    dl.vertex(0.035f, -0.06f);
+    dl.vertex(0.0f, -0.11f);
+    dl.vertex(-0.035f, -0.06f);
+    dl.vertex(-0.035f, 0.06f);
+    dl.end();
+
+    // nose cone (GL_TRIANGLES)
+    dl.color(0.95f, 0.6f, 0.2f);
+    dl.begin(PRIM_TRIANGLES);
+    dl.vertex(0.0f, 0.10f);
+    dl.vertex(-0.02f, 0.045f);
+    dl.vertex(0.02f, 0.045f);
+    dl.end();
+
+    // fins (GL_TRIANGLES)
+    dl.color(0.8f, 0.15f, 0.15f);
+    dl.begin(PRIM_TRIANGLES);
+    dl.vertex(-0.02f, -0.02f);
+    dl.vertex(-0.09f, -0.06f);
+    dl.vertex(-0.02f, -0.06f);
+    dl.vertex(0.02f, -0.02f);
+    dl.vertex(0.09f, -0.06f);
+    dl.vertex(0.02f, -0.06f);
+    dl.end();
+
+    // cockpit/window (GL_TRIANGLE_FAN) and outline (GL_LINE_LOOP)
+    dl.color(0.2f, 0.45f, 0.85f);
+    drawCircle(dl, 0.0f, 0.02f, 0.02f, 20);
+    dl.color(0.02f, 0.02f, 0.02f);
+    dl.begin(PRIM_LINE_LOOP);
+    for (const Vec2& u : shapeCache().circle(20)) dl.vertex(u.x * 0.02f, 0.02f + u.y * 0.02f);
+    dl.end();
+
+    // antenna lines (GL_LINES)
+    dl.color(0.02f, 0.02f, 0.02f);
+    drawLine(dl, 0.01f, 0.08f, 0.01f, 0.12f);
+    drawLine(dl, 0.01f, 0.12f, 0.03f, 0.13f);
+
+    // thruster point (GL_POINTS)
+    dl.pointSize(4.0f); drawPoint(dl, 0.0f, -0.11f); dl.pointSize(1.0f);
+
+    // thruster flame when player just moved (GL_TRIANGLE_FAN)
+    if (game.globalTime - game.lastMoveTime < 0.25f) {
+        dl.begin(PRIM_TRIANGLE_FAN);
+        dl.color(1.0f, 0.6f, 0.0f);
+        dl.vertex(0.0f, -0.11f);
+        dl.color(1.0f, 0.2f, 0.0f);
+        dl.vertex(-0.03f, -0.18f);
+        dl.vertex(0.0f, -0.14f);
+        dl.vertex(0.03f, -0.18f);
+        dl.end();
+    }
+}
+
+// =====================
+// Rendering UI panels and icons
+// Top/bottom panels use GL_QUADS (at least 1 primitive each)
+// Health drawn with at least 2 primitives (heart polygon + small circle)
+// =====================
+
+static void displayText(DrawList& dl, float x, float y, const char* text) { dl.text(x, y, text); }
+
+// formats an integer HUD field when its value changed since the last frame
+static const char* hudInt(HudText::Field& f, const char* fmt, long value) {
+    if (f.key != value) { snprintf(f.text, sizeof(f.text), fmt, value); f.key = value; }
+    return f.text;
+}
+// same for a timer shown with one decimal, keyed on its value in tenths
+static const char* hudTenths(HudText::Field& f, const char* fmt, float seconds) {
+    long tenths = lroundf(seconds * 10.0f);
+    if (f.key != tenths) { snprintf(f.text, sizeof(f.text), fmt, tenths / 10.0); f.key = tenths; }
+    return f.text;
+}
+
+// editor: the route's time and what it leaves of the round, re-formatted when the time changes by a tenth
+static const char* hudRoute(HudText::Field& f, float seconds) {
+    long key = seconds == SolvabilityMap::UNREACHABLE ? LONG_MAX : lroundf(seconds * 10.0f);
+    if (f.key == key) return f.text;
+    if (key == LONG_MAX) snprintf(f.text, sizeof(f.text), "Target unreachable");
+    else if (seconds <= GAME_DURATION) snprintf(f.text, sizeof(f.text), "Route %.1fs, %.1fs spare", key / 10.0, GAME_DURATION - key / 10.0);
+    else snprintf(f.text, sizeof(f.text), "Route %.1fs: too slow", key / 10.0);
+    f.key = key;
+    return f.text;
+}
+
+static void drawTopPanel(DrawList& dl, const FrameSnapshot& game, HudText& hud) {
+    // background quad (GL_QUADS)
+    dl.color(0.02f, 0.02f, 0.02f); drawQuad(dl, 0.0f, 1.0f - UI_TOP_HEIGHT / 2.0f, 1.0f, UI_TOP_HEIGHT / 2.0f);
+    // health: draw hearts (GL_POLYGON) + small inner circles (GL_TRIANGLE_FAN) -> 2 primitives per health
+    float sx = -0.9f; float y = 1.0f - UI_TOP_HEIGHT / 2.0f;
+    for (int i = 0;i < game.lives;i++) {
+        dl.color(1.0f, 0.15f, 0.25f); drawHeart(dl, sx + i * 0.08f, y, 0.03f); // GL_POLYGON
+        dl.color(0.8f, 0.2f, 0.3f); drawCircle(dl, sx + i * 0.08f, y - 0.0f, 0.01f, 8); // GL_TRIANGLE_FAN
+    }
+    // score and time text
+    dl.color(1, 1, 1);
+    displayText(dl, -0.05f, 1.0f - UI_TOP_HEIGHT / 2.0f, hudInt(hud.score, "Score: %ld", game.score));
+    displayText(dl, 0.5f, 1.0f - UI_TOP_HEIGHT / 2.0f, hudInt(hud.time, "Time: %ld", (int)game.gameTimer));
+    // active powerup and its timer (if any)
+    if (game.shieldActive) displayText(dl, 0.2f, 1.0f - UI_TOP_HEIGHT / 2.0f, hudTenths(hud.shield, "Shield: %.1fs", game.shieldTimer));
+    if (game.speedActive) displayText(dl, 0.36f, 1.0f - UI_TOP_HEIGHT / 2.0f, hudTenths(hud.speed, "Speed: %.1fs", game.speedTimer));
+    // editor: whether the level as placed can be won
+    if (game.editing) {
+        bool inTime = game.routeTime <= GAME_DURATION;
+        dl.color(inTime ? 0.5f : 1.0f, inTime ? 1.0f : 0.45f, inTime ? 0.6f : 0.3f);
+        displayText(dl, 0.12f, 1.0f - UI_TOP_HEIGHT / 2.0f, hudRoute(hud.route, game.routeTime));
+    }
+}
+
+static void drawBottomPanel(DrawList& dl, const FrameSnapshot& game) {
+    // background quad (GL_QUADS)
+    dl.color(0.02f, 0.02f, 0.02f); drawQuad(dl, 0.0f, -1.0f + UI_BOTTOM_HEIGHT / 2.0f, 1.0f, UI_BOTTOM_HEIGHT / 2.0f);
+    // draw icons for tools (obstacle, collectible, shield, score powerup)
+    float y = -1.0f + UI_BOTTOM_HEIGHT / 2.0f;
+    float startX = -0.8f; float gap = 0.45f;
+    // obstacle icon (GL_QUADS + GL_LINE_LOOP)
+    dl.color(0.6f, 0.3f, 0.2f); drawObstacleIcon(dl, startX, y, 0.06f, 0.04f);
+    displayText(dl, startX - 0.04f, y - 0.06f, "Obstacle");
+    // collectible icon (GL_TRIANGLES + GL_TRIANGLE_FAN + GL_LINES)
+    dl.color(1.0f, 0.9f, 0.2f); drawCollectibleIcon(dl, startX + gap, y, 0.06f);
+    displayText(dl, startX + gap - 0.05f, y - 0.06f, "Collectible");
+    // shield icon (GL_POLYGON + GL_LINE_LOOP)
+    dl.color(0.2f, 0.6f, 1.0f); drawShieldIcon(dl, startX + gap * 2, y, 0.06f);
+    displayText(dl, startX + gap * 2 - 0.03f, y - 0.06f, "Shield (5s)");
+    // score powerup icon (GL_TRIANGLE_STRIP + GL_LINE_STRIP)
+    dl.color(1.0f, 0.9f, 0.2f); drawScorePowerupShape(dl, startX + gap * 3, y, 0.05f);
+    displayText(dl, startX + gap * 3 - 0.03f, y - 0.06f, "Speed (5s)");
+
+    // selection highlight (GL_LINE_LOOP)
+    float selX = startX + (game.selectedTool == TOOL_OBSTACLE ? 0 : (game.selectedTool == TOOL_COLLECTIBLE ? gap : (game.selectedTool == TOOL_P_SHIELD ? gap * 2 : (game.selectedTool == TOOL_P_SPEED ? gap * 3 : 0))));
+    if (game.selectedTool != TOOL_NONE) { dl.color(0.8f, 0.8f, 0.8f); dl.begin(PRIM_LINE_LOOP); dl.vertex(selX - 0.08f, y - 0.05f); dl.vertex(selX + 0.08f, y - 0.05f); dl.vertex(selX + 0.08f, y + 0.05f); dl.vertex(selX - 0.08f, y + 0.05f); dl.end(); }
+}
+
+// =====================
+// Drawing world: objects placed by user; animate collectibles & powerups; draw obstacles; draw target; background anim
+// =====================
+
+static void drawBackground(DrawList& dl, const FrameSnapshot& game, const FramePose& pose) {
+    // parallax starfield (GL_POINTS): the renderer keeps the stars in a static buffer and moves them on the GPU
+    dl.starfield(game.globalTime - pose.timeLag, pose.cameraY);
+}
+
+// =====================
+// View culling: indices of the entities whose drawn shape can overlap the visible part of the world
+// =====================
+
+// world rectangle between the UI panels at the given camera height
+struct ViewRect { float x0, y0, x1, y1; };
+
+static ViewRect worldView(float cameraY) {
+    ViewRect v; v.x0 = WORLD_LEFT; v.x1 = WORLD_RIGHT;
+    v.y0 = cameraY - 1.0f + UI_BOTTOM_HEIGHT; v.y1 = cameraY + 1.0f - UI_TOP_HEIGHT;
+    return v;
+}
+
+// chunks this big are culled by a parallel scan instead of the grid; parallel ranges of that scan, and of
+// drawing, are this many entities
+const size_t CULL_SCAN_MIN = 65536, CULL_GRAIN = 16384;
+const size_t DRAW_PARALLEL_MIN = 4096, DRAW_GRAIN = 1024;
+
+// per-range scratch for the parallel paths, reused across frames
+static std::vector<std::vector<uint32_t>> cullParts;
+static std::vector<DrawList> drawParts;
+
+// entity centres within margin of the view, in index order so the painter's order does not depend on the
+// grid. Small levels are tested directly and mid-sized ones only visit the grid cells under the view. A view
+// covers a good part of its chunks' height, so the biggest chunks are scanned whole on the job system
+// instead: each range keeps its hits in index order and the ranges are concatenated in order.
+static void cullToView(const Column<float>& x, const Column<float>& y, const ActiveBits* active, const SpatialGrid& grid, const ViewRect& v, float margin, std::vector<uint32_t>& out) {
+    out.clear();
+    const float x0 = v.x0 - margin, y0 = v.y0 - margin, x1 = v.x1 + margin, y1 = v.y1 + margin;
+    auto inside = [&](uint32_t i) { return x[i] >= x0 && x[i] <= x1 && y[i] >= y0 && y[i] <= y1; };
+    if (x.size() <= SMALL_LEVEL_SCAN) {
+        for (uint32_t i = 0;i < (uint32_t)x.size();++i) if ((!active || active->test(i)) && inside(i)) out.push_back(i);
+        return;
+    }
+    if (x.size() >= CULL_SCAN_MIN) {
+        const size_t parts = (x.size() + CULL_GRAIN - 1) / CULL_GRAIN;
+        if (cullParts.size() < parts) cullParts.resize(parts);
+        jobSystem().parallelFor(x.size(), CULL_GRAIN, [&](size_t b, size_t e) {
+            std::vector<uint32_t>& part = cullParts[b / CULL_GRAIN];
+            part.clear();
+            for (uint32_t i = (uint32_t)b;i < (uint32_t)e;++i) if ((!active || active->test(i)) && inside(i)) part.push_back(i);
+        });
+        for (size_t k = 0;k < parts;++k) out.insert(out.end(), cullParts[k].begin(), cullParts[k].end());
+        return;
+    }
+    // the grids hold active entities only
+    grid.queryRect(x0, y0, x1, y1, [&](uint32_t i) { if (inside(i)) out.push_back(i); return false; });
+    std::sort(out.begin(), out.end());
+}
+
+// resident chunks whose band overlaps the view widened by margin (bands hold entity centres)
+template <class F>
+static void forEachChunkInView(const GameState& game, const ViewRect& v, float margin, F&& f) {
+    for (int b = chunkBand(v.y0 - margin), last = chunkBand(v.y1 + margin);b <= last;++b) if (const LevelChunk* ch = game.chunks.at(b)) f(*ch);
+}
+
+// reused across frames; snapshots are captured on one thread at a time (the parallel ranges only fill their parts)
+static std::vector<uint32_t> visibleScratch;
+
+// how far the drawn shapes reach past an entity's centre: star plus bob, spinning power-up icons
+const float COLLECTIBLE_DRAW_REACH = 0.06f, POWERUP_DRAW_REACH = 0.08f;
+
+void captureSnapshot(const GameState& game, float cameraLo, float cameraHi, FrameSnapshot& snap) {
+    snap.score = game.score; snap.lives = game.lives;
+    snap.gameTimer = game.gameTimer; snap.shieldTimer = game.shieldTimer; snap.speedTimer = game.speedTimer; snap.messageTimer = game.messageTimer;
+    snap.shieldActive = game.shieldActive; snap.speedActive = game.speedActive; snap.gameOver = game.gameOver; snap.gameWin = game.gameWin;
+    snap.selectedTool = game.selectedTool;
+    snap.globalTime = game.globalTime; snap.lastMoveTime = game.lastMoveTime;
+    memcpy(snap.statusMessage, game.statusMessage, sizeof(snap.statusMessage));
+    snap.effects = game.effects;
+    snap.editing = !game.gameStarted;
+    snap.routeTime = game.solvability.bestTime();
+    if (snap.editing) snap.route.assign(game.solvability.path().begin(), game.solvability.path().end()); else snap.route.clear();
+
+    ViewRect view = worldView(cameraLo);
+    view.y1 = worldView(cameraHi).y1;
+    snap.obstacleX.clear(); snap.obstacleY.clear(); snap.obstacleW.clear(); snap.obstacleH.clear();
+    forEachChunkInView(game, view, game.chunks.obstacleReach(), [&](const LevelChunk& ch) {
+        const ObstacleStore& obs = ch.obstacles;
+        cullToView(obs.x, obs.y, nullptr, ch.obstacleGrid, view, ch.obstacleReach, visibleScratch);
+        for (uint32_t i : visibleScratch) { snap.obstacleX.push_back(obs.x[i]); snap.obstacleY.push_back(obs.y[i]); snap.obstacleW.push_back(obs.w[i]); snap.obstacleH.push_back(obs.h[i]); }
+    });
+    // path followers after the chunks' entities (drawn on top), by a scan: they have no grid to query
+    const MovingObstacleStore& mo = game.motion.obstacles;
+    for (size_t i = 0;i < mo.size();++i) {
+        float x = mo.motion.x[i], y = mo.motion.y[i];
+        if (y + mo.h[i] < view.y0 || y - mo.h[i] > view.y1 || x + mo.w[i] < view.x0 || x - mo.w[i] > view.x1) continue;
+        snap.obstacleX.push_back(x); snap.obstacleY.push_back(y); snap.obstacleW.push_back(mo.w[i]); snap.obstacleH.push_back(mo.h[i]);
+    }
+    snap.collectibleX.clear(); snap.collectibleY.clear(); snap.collectiblePhase.clear();
+    forEachChunkInView(game, view, COLLECTIBLE_DRAW_REACH, [&](const LevelChunk& ch) {
+        const CollectibleStore& cs = ch.collectibles;
+        cullToView(cs.x, cs.y, &cs.active, ch.collectibleGrid, view, COLLECTIBLE_DRAW_REACH, visibleScratch);
+        for (uint32_t i : visibleScratch) { snap.collectibleX.push_back(cs.x[i]); snap.collectibleY.push_back(cs.y[i]); snap.collectiblePhase.push_back(cs.phase[i]); }
+    });
+    const MovingCollectibleStore& mc = game.motion.collectibles;
+    for (size_t i = 0;i < mc.size();++i) {
+        float x = mc.motion.x[i], y = mc.motion.y[i];
+        if (!mc.active.test(i) || y + COLLECTIBLE_DRAW_REACH < view.y0 || y - COLLECTIBLE_DRAW_REACH > view.y1 || x + COLLECTIBLE_DRAW_REACH < view.x0 || x - COLLECTIBLE_DRAW_REACH > view.x1) continue;
+        snap.collectibleX.push_back(x); snap.collectibleY.push_back(y); snap.collectiblePhase.push_back(mc.phase[i]);
+    }
+    snap.powerupX.clear(); snap.powerupY.clear(); snap.powerupPhase.clear(); snap.powerupType.clear();
+    forEachChunkInView(game, view, POWERUP_DRAW_REACH, [&](const LevelChunk& ch) {
+        const PowerupStore& ps = ch.powerups;
+        cullToView(ps.x, ps.y, &ps.active, ch.powerupGrid, view, POWERUP_DRAW_REACH, visibleScratch);
+        for (uint32_t i : visibleScratch) { snap.powerupX.push_back(ps.x[i]); snap.powerupY.push_back(ps.y[i]); snap.powerupPhase.push_back(ps.phase[i]); snap.powerupType.push_back((uint8_t)ps.type[i]); }
+    });
+}
+
+// draw(list, i) for i in [0, n). Big counts are drawn in fixed ranges into part lists on the job system and
+// appended in range order, which gives the same batches as drawing them one by one into dl.
+template <class Draw>
+static void drawRange(DrawList& dl, size_t n, Draw&& draw) {
+    if (n < DRAW_PARALLEL_MIN) { for (size_t i = 0;i < n;++i) draw(dl, i); return; }
+    const size_t parts = (n + DRAW_GRAIN - 1) / DRAW_GRAIN;
+    if (drawParts.size() < parts) drawParts.resize(parts);
+    jobSystem().parallelFor(n, DRAW_GRAIN, [&](size_t b, size_t e) {
+        DrawList& part = drawParts[b / DRAW_GRAIN];
+        part.clear(); part.inheritState(dl);
+        for (size_t i = b;i < e;++i) draw(part, i);
+    });
+    for (size_t k = 0;k < parts;++k) dl.append(drawParts[k]);
+}
+
+// the snapshot holds only what the view can show, so everything in it is drawn
+static void drawObstacles(DrawList& dl, const FrameSnapshot& snap) {
+    drawRange(dl, snap.obstacleX.size(), [&](DrawList& dl, size_t i) {
+        float x = snap.obstacleX[i], y = snap.obstacleY[i], w = snap.obstacleW[i], h = snap.obstacleH[i];
+        dl.color(0.4f, 0.2f, 0.1f);
+        drawQuad(dl, x, y, w, h);
+        // outline corners in the frame's scratch arena (a vector here was a heap allocation per obstacle per frame)
+        Vec2* loop = dl.arena().alloc<Vec2>(4);
+        loop[0] = Vec2(x - w, y - h); loop[1] = Vec2(x + w, y - h); loop[2] = Vec2(x + w, y + h); loop[3] = Vec2(x - w, y + h);
+        dl.color(0, 0, 0);
+        drawLineLoop(dl, loop, 4);
+    });
+}
+
+static void drawCollectibles(DrawList& dl, const FrameSnapshot& snap, const FramePose& pose) {
+    float lag = pose.timeLag * COLLECTIBLE_PHASE_RATE;
+    drawRange(dl, snap.collectibleX.size(), [&](DrawList& dl, size_t i) { float x = snap.collectibleX[i], y = snap.collectibleY[i] + sin(snap.collectiblePhase[i] - lag) * 0.02f; dl.color(1.0f, 0.9f, 0.2f); drawStarTriangles(dl, x, y, 0.03f); dl.color(1, 1, 1); drawCircle(dl, x, y, 0.01f, 8); dl.color(0, 0, 0); drawLine(dl, x - 0.02f, y, x + 0.02f, y); });
+}
+
+static void drawPowerups(DrawList& dl, const FrameSnapshot& snap, const FramePose& pose) {
+    float lag = pose.timeLag * POWERUP_PHASE_RATE;
+    drawRange(dl, snap.powerupX.size(), [&](DrawList& dl, size_t i) {
+        float x = snap.powerupX[i], y = snap.powerupY[i], phase = snap.powerupPhase[i] - lag;
+        if (snap.powerupType[i] == P_SHIELD) { dl.color(0.2f, 0.6f, 1.0f); dl.pushTransform(x, y, phase * 40.0f); drawShieldIcon(dl, 0, 0, 0.05f); dl.popTransform(); }
+        else { // P_SPEED
+            dl.color(0.8f, 0.2f, 0.9f);
+            dl.pushTransform(x, y, phase * 120.0f);
+            // draw a speed icon using triangle strip + line strip (retains primitive requirements)
+            drawScorePowerupShape(dl, 0, 0, 0.035f);
+            dl.popTransform();
+            // small arrow point (GL_TRIANGLES) to make it look like speed
+            dl.color(1, 1, 1);
+            dl.begin(PRIM_TRIANGLES);
+            dl.vertex(x + 0.03f, y);
+            dl.vertex(x, y + 0.015f);
+            dl.vertex(x, y - 0.015f);
+            dl.end();
+        }
+    });
+}
+
+// nicer sun target with glow and rays
+static void drawSunTarget(DrawList& dl, const FrameSnapshot& game, const FramePose& pose, float cx, float cy, float radius) {
+    const int N = 24;
+    // glow layers (GL_TRIANGLE_FAN)
+    for (int layer = 3;layer >= 0;--layer) { float r = radius * (0.4f + 0.2f * layer); float alpha = 0.2f + 0.2f * (3 - layer); dl.color(1.0f, 0.85f - 0.08f * layer, 0.0f, alpha); drawCircle(dl, cx, cy, r, N); }
+    // rays (GL_TRIANGLES): the cached rays are spun by one rotation per frame instead of per-vertex trig
+    float spin = (game.globalTime - pose.timeLag) * 0.5f; float rc = cos(spin) * radius, rs = sin(spin) * radius;
+    dl.color(1, 0.9f, 0.1f);
+    dl.begin(PRIM_TRIANGLES);
+    for (const Vec2& u : shapeCache().sunRays) dl.vertex(cx + u.x * rc - u.y * rs, cy + u.x * rs + u.y * rc);
+    dl.end();
+    // core (GL_TRIANGLE_FAN)
+    dl.color(1, 1, 0.6f); drawCircle(dl, cx, cy, radius * 0.6f, 20);
+}
+
+// =====================
+// Whole frame
+// =====================
+
+FramePose currentPose(const GameState& game) {
+    FramePose p;
+    p.playerX = game.playerX; p.playerY = game.playerY; p.playerAngle = game.playerAngle;
+    p.targetPos = game.targetPos;
+    p.cameraY = game.cameraY;
+    return p;
+}
+
+FramePose blendPoses(const FramePose& a, const FramePose& b, float alpha, float dt) {
+    FramePose p;
+    p.playerX = a.playerX + (b.playerX - a.playerX) * alpha;
+    p.playerY = a.playerY + (b.playerY - a.playerY) * alpha;
+    // turn the short way round
+    float turn = fmodf(b.playerAngle - a.playerAngle + 540.0f, 360.0f) - 180.0f;
+    p.playerAngle = a.playerAngle + turn * alpha;
+    p.targetPos = Vec2(a.targetPos.x + (b.targetPos.x - a.targetPos.x) * alpha, a.targetPos.y + (b.targetPos.y - a.targetPos.y) * alpha);
+    p.cameraY = a.cameraY + (b.cameraY - a.cameraY) * alpha;
+    p.timeLag = (1.0f - alpha) * dt;
+    return p;
+}
+
+void buildScene(const GameState& game, const FramePose& pose, DrawList& dl, HudText& hud) {
+    static FrameSnapshot snap; // storage reused frame to frame
+    { PROFILE_SCOPE(ZONE_SNAPSHOT); captureSnapshot(game, pose.cameraY, pose.cameraY, snap); }
+    buildScene(snap, pose, dl, hud);
+}
+
+void buildScene(const FrameSnapshot& game, const FramePose& pose, DrawList& dl, HudText& hud) {
+    PROFILE_SCOPE(ZONE_BUILD_SCENE);
+    dl.clear();
+
+    // draw background (screen space)
+    dl.setLayer(LAYER_BACKGROUND);
+    dl.color(0.02f, 0.02f, 0.05f); drawQuad(dl, 0, 0, 1.0f, 1.0f);
+    { PROFILE_SCOPE(ZONE_BACKGROUND); drawBackground(dl, game, pose); }
+
+    // draw UI panels
+    dl.setLayer(LAYER_PANELS);
+    { PROFILE_SCOPE(ZONE_PANELS); dl.color(0.1f, 0.1f, 0.12f); drawTopPanel(dl, game, hud); drawBottomPanel(dl, game); }
+
+    // draw world objects, through the camera and culled to the view
+    dl.setLayer(LAYER_WORLD);
+    dl.pushTransform(0.0f, -pose.cameraY);
+    drawSunTarget(dl, game, pose, pose.targetPos.x, pose.targetPos.y, 0.06f);
+    // editor: the fastest route, under the objects (GL_LINE_STRIP)
+    if (game.editing && game.route.size() >= 2) {
+        if (game.routeTime <= GAME_DURATION) dl.color(0.3f, 1.0f, 0.5f, 0.6f); else dl.color(1.0f, 0.45f, 0.3f, 0.6f);
+        drawLineStrip(dl, game.route.data(), game.route.size());
+    }
+    { PROFILE_SCOPE(ZONE_OBSTACLES); drawObstacles(dl, game); }
+    { PROFILE_SCOPE(ZONE_COLLECTIBLES); drawCollectibles(dl, game, pose); }
+    { PROFILE_SCOPE(ZONE_POWERUPS); drawPowerups(dl, game, pose); }
+
+    // draw player (animated rotation is visualized via antenna lines orientation using playerAngle)
+    dl.setLayer(LAYER_PLAYER);
+    {
+        PROFILE_SCOPE(ZONE_PLAYER);
+        dl.pushTransform(pose.playerX, pose.playerY, pose.playerAngle);
+        drawPlayer(dl, game);
+        dl.popTransform();
+    }
+    dl.popTransform();
+
+    // draw status messages
+    dl.setLayer(LAYER_OVERLAY);
+    if (game.messageTimer > 0.0f) { dl.color(1, 1, 1); displayText(dl, -0.4f, -0.85f + UI_BOTTOM_HEIGHT, game.statusMessage); }
+
+    if (game.gameOver) { dl.color(1, 1, 1); displayText(dl, -0.12f, 0.0f, game.gameWin ? "YOU WIN!" : "GAME OVER"); displayText(dl, -0.15f, -0.1f, hudInt(hud.finalScore, "Final Score: %ld", game.score)); displayText(dl, -0.25f, -0.2f, "Press R to Restart (returns to editor)"); }
+}
+
+// =====================
+// Particles
+// =====================
+
+static void buildParticles(const EffectLog& effects, bool thrusting, const FramePose& pose, float dt, ParticleSystem& ps, DrawList& dl) {
+    PROFILE_SCOPE(ZONE_PARTICLES);
+    spawnEffects(ps, effects);
+    if (thrusting) emitExhaust(ps, pose.playerX, pose.playerY, pose.playerAngle, dt);
+    updateParticles(ps, dt);
+    dl.setLayer(LAYER_WORLD);
+    dl.pushTransform(0.0f, -pose.cameraY);
+    drawParticles(ps, dl);
+    dl.popTransform();
+}
+
+// the thruster fires as long as drawPlayer() shows its flame
+void buildParticles(const FrameSnapshot& snap, const FramePose& pose, float dt, ParticleSystem& ps, DrawList& dl) {
+    buildParticles(snap.effects, snap.globalTime - snap.lastMoveTime < 0.25f, pose, dt, ps, dl);
+}
+
+void buildParticles(const GameState& game, const FramePose& pose, float dt, ParticleSystem& ps, DrawList& dl) {
+    buildParticles(game.effects, game.globalTime - game.lastMoveTime < 0.25f, pose, dt, ps, dl);
+}
+
+// =====================
+// Profiler overlay
+// =====================
+
+void buildProfilerOverlay(const Profiler& prof, ProfilerOverlay& overlay, DrawList& dl, double nowSeconds) {
+    if (!overlay.visible) return;
+    const int rows = ZONE_COUNT + 1;
+    // re-format at most every 0.25 s: readable, and steady frames skip the formatting
+    if (nowSeconds - overlay.lastRefresh >= 0.25) {
+        overlay.lastRefresh = nowSeconds;
+        const char* head[4] = { "zone (ms)", "min", "avg", "p99" };
+        for (int c = 0;c < 4;++c) snprintf(overlay.cells[0][c], sizeof(overlay.cells[0][c]), "%s", head[c]);
+        for (int z = 0;z < ZONE_COUNT;++z) {
+            ZoneStats st = prof.stats((ProfileZone)z);
+            char (*row)[16] = overlay.cells[z + 1];
+            snprintf(row[0], sizeof(row[0]), "%s", profileZoneName((ProfileZone)z));
+            snprintf(row[1], sizeof(row[1]), "%.3f", st.minMs);
+            snprintf(row[2], sizeof(row[2]), "%.3f", st.avgMs);
+            snprintf(row[3], sizeof(row[3]), "%.3f", st.p99Ms);
+        }
+    }
+    dl.setLayer(LAYER_OVERLAY);
+    const float left = -0.98f, top = 0.86f, lineH = 0.045f, width = 0.64f;
+    dl.color(0.0f, 0.0f, 0.0f, 0.7f);
+    drawQuad(dl, left + width * 0.5f, top - lineH * rows * 0.5f, width * 0.5f, lineH * rows * 0.5f);
+    // the font is proportional, so every column is its own text item
+    const float colX[4] = { 0.02f, 0.28f, 0.40f, 0.52f };
+    for (int r = 0;r < rows;++r) {
+        float y = top - lineH * (r + 0.75f);
+        if (r == 0) dl.color(1.0f, 1.0f, 1.0f); else dl.color(0.6f, 1.0f, 0.6f);
+        for (int c = 0;c < 4;++c) displayText(dl, left + colX[c], y, overlay.cells[r][c]);
+    }
+}
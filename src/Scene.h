@@ -0,0 +1,84 @@
+#pragma once
+
+// =====================
+// Scene building: turns a GameState into a DrawList (geometry batches plus queued text).
+// GL-free; the front end submits the result.
+// =====================
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DrawList.h"
+#include "GameCore.h"
+#include "Particles.h"
+#include "Profiler.h"
+
+// HUD strings kept across frames: a field is re-formatted only when the value it shows changes,
+// so a steady-state frame queues its text without formatting or allocating
+struct HudText {
+    struct Field { long key = LONG_MIN; char text[48] = ""; };
+    Field score, time, shield, speed, finalScore, route;
+};
+
+// render-time values of everything that moves every tick. The front end blends the poses of the last
+// two ticks so motion stays smooth when the frame rate and the simulation rate differ.
+struct FramePose {
+    float playerX = 0.0f, playerY = 0.0f, playerAngle = 0.0f;
+    Vec2 targetPos;
+    float cameraY = 0.0f;
+    float timeLag = 0.0f; // seconds the frame sits behind the latest tick; linear animations are rewound by it
+};
+
+// what a frame shows, copied out of a GameState so a scene can be built on another thread while the
+// simulation moves on: the HUD fields (named as in GameState) and the entities that can appear in the view
+struct FrameSnapshot {
+    int score = 0, lives = 0;
+    float gameTimer = 0.0f, shieldTimer = 0.0f, speedTimer = 0.0f, messageTimer = 0.0f;
+    bool shieldActive = false, speedActive = false, gameOver = false, gameWin = false;
+    Tool selectedTool = TOOL_NONE;
+    float globalTime = 0.0f, lastMoveTime = 0.0f;
+    char statusMessage[sizeof(GameState::statusMessage)] = "";
+    EffectLog effects; // the particle bursts to spawn (src/Particles.h)
+    // editor: the solvability route (world points from the rocket to the target's track) and its time
+    bool editing = false;
+    float routeTime = 0.0f;
+    std::vector<Vec2> route;
+
+    // entities in chunk and index order (the painter's order), struct of arrays; storage is reused
+    std::vector<float> obstacleX, obstacleY, obstacleW, obstacleH;
+    std::vector<float> collectibleX, collectibleY, collectiblePhase;
+    std::vector<float> powerupX, powerupY, powerupPhase;
+    std::vector<uint8_t> powerupType;
+};
+
+// copies game's HUD state and every entity the view can show with the camera anywhere in [cameraLo, cameraHi]
+// (a frame blends between two ticks, so it covers both)
+void captureSnapshot(const GameState& game, float cameraLo, float cameraHi, FrameSnapshot& snap);
+
+FramePose currentPose(const GameState& game);
+// alpha 0 gives a, 1 gives b; b's pose is assumed to be the latest tick, dt the tick length
+FramePose blendPoses(const FramePose& a, const FramePose& b, float alpha, float dt);
+
+// draws a snapshot as seen from pose; only the snapshot is read, so the simulation may keep running meanwhile
+void buildScene(const FrameSnapshot& snap, const FramePose& pose, DrawList& dl, HudText& hud);
+// captures at pose's camera and draws, for callers that simulate and render on one thread. World objects are
+// culled against the camera's view, so the cost follows what is on screen, not the level size.
+void buildScene(const GameState& game, const FramePose& pose, DrawList& dl, HudText& hud);
+
+// the frame's particles, drawn after buildScene() into the same list: spawns the bursts of effects logged
+// since the last frame, emits exhaust while the thruster fires, advances everything by dt (seconds of real
+// time since the last frame) and draws it in the world, under the rocket and the panels
+void buildParticles(const FrameSnapshot& snap, const FramePose& pose, float dt, ParticleSystem& ps, DrawList& dl);
+void buildParticles(const GameState& game, const FramePose& pose, float dt, ParticleSystem& ps, DrawList& dl);
+
+// profiler readout (min/avg/p99 per zone), text refreshed a few times per second
+struct ProfilerOverlay {
+    bool visible = false;
+    double lastRefresh = -1.0;
+    char cells[ZONE_COUNT + 1][4][16] = {};
+};
+
+// appends the overlay to an already built scene; nowSeconds is any monotonic clock
+void buildProfilerOverlay(const Profiler& prof, ProfilerOverlay& overlay, DrawList& dl, double nowSeconds);
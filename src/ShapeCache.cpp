@@ -0,0 +1,51 @@
+#define _USE_MATH_DEFINES
+
+#include "ShapeCache.h"
+
+#include <cmath>
+
+ShapeCache::ShapeCache() {
+    for (int segs = 3;segs <= SHAPE_MAX_CIRCLE_SEGS;++segs) {
+        std::vector<Vec2>& c = circles[segs];
+        c.reserve(segs + 1);
+        for (int i = 0;i <= segs;i++) { float a = i * 2 * M_PI / segs; c.push_back(Vec2(cos(a), sin(a))); }
+    }
+
+    // same parameter walk the immediate-mode heart used, so the outline is unchanged
+    for (float t = 0;t < 2 * M_PI;t += 0.05f) {
+        float X = 16 * pow(sin(t), 3);
+        float Y = 13 * cos(t) - 5 * cos(2 * t) - 2 * cos(3 * t) - cos(4 * t);
+        heart.push_back(Vec2(X / 18, Y / 18));
+    }
+
+    const int points = 5;
+    Vec2 outer[points], inner[points];
+    for (int i = 0;i < points;i++) {
+        float a = i * 2 * M_PI / points - M_PI / 2.0f;
+        outer[i] = Vec2(cos(a), sin(a));
+        float a2 = a + M_PI / points;
+        inner[i] = Vec2(cos(a2) * 0.45f, sin(a2) * 0.45f);
+    }
+    for (int i = 0;i < points;i++) {
+        int ni = (i + 1) % points;
+        starTriangles.push_back(outer[i]); starTriangles.push_back(inner[i]); starTriangles.push_back(outer[ni]);
+    }
+
+    for (int i = 0;i < SUN_RAY_COUNT;i++) {
+        float a = i * 2 * M_PI / SUN_RAY_COUNT; float innerR = 1.05f; float outerR = 1.4f + 0.2f * (i % 2);
+        sunRays.push_back(Vec2(cos(a) * innerR, sin(a) * innerR));
+        sunRays.push_back(Vec2(cos(a + 0.08f) * outerR, sin(a + 0.08f) * outerR));
+        sunRays.push_back(Vec2(cos(a - 0.08f) * outerR, sin(a - 0.08f) * outerR));
+    }
+}
+
+const std::vector<Vec2>& ShapeCache::circle(int segs) const {
+    if (segs < 3) segs = 3;
+    if (segs > SHAPE_MAX_CIRCLE_SEGS) segs = SHAPE_MAX_CIRCLE_SEGS;
+    return circles[segs];
+}
+
+const ShapeCache& shapeCache() {
+    static const ShapeCache cache;
+    return cache;
+}
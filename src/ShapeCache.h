@@ -0,0 +1,32 @@
+#pragma once
+
+// =====================
+// Precomputed unit-shape vertex tables. Built once on first use; drawing code only scales and
+// translates them, so no sin/cos/pow is evaluated per vertex per frame.
+// =====================
+
+#include <vector>
+
+#include "Vec2.h"
+
+const int SHAPE_MAX_CIRCLE_SEGS = 64;
+const int SUN_RAY_COUNT = 12;
+
+struct ShapeCache {
+    // circles[segs] holds segs + 1 points on the unit circle (first point repeated at the end)
+    std::vector<Vec2> circles[SHAPE_MAX_CIRCLE_SEGS + 1];
+    // heart outline for drawHeart, already divided by 18 so size scales it directly
+    std::vector<Vec2> heart;
+    // five-point star as a triangle list (outer, inner, next outer), outer radius 1
+    std::vector<Vec2> starTriangles;
+    // sun rays as a triangle list around the unit circle, before the time-based spin is applied
+    std::vector<Vec2> sunRays;
+
+    ShapeCache();
+
+    // unit circle with segs segments; segs is clamped to [3, SHAPE_MAX_CIRCLE_SEGS]
+    const std::vector<Vec2>& circle(int segs) const;
+};
+
+// process-wide cache (thread-safe lazy construction)
+const ShapeCache& shapeCache();
@@ -0,0 +1,175 @@
+#include "Solvability.h"
+
+#include <algorithm>
+#include <cmath>
+
+// neighbour offsets: the four orthogonal moves, then the four diagonal ones
+static const int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// =====================
+// Grid setup and edits
+// =====================
+
+void SolvabilityMap::reset(float x0, float y0, float x1, float y1, float speed) {
+    cols = std::max(1, (int)ceilf((x1 - x0) / CELL)); rows = std::max(1, (int)ceilf((y1 - y0) / CELL));
+    originX = x0; originY = y0;
+    stepTime = CELL / speed;
+    const size_t n = cellCount();
+    g.assign(n, INF); rhs.assign(n, INF);
+    blockCount.assign(n, 0); goalCell.assign(n, 0); heapPos.assign(n, -1);
+    heap.clear(); route.clear();
+    startCell = 0; searching = false; changed = true; expanded = 0;
+}
+
+void SolvabilityMap::setStart(const Vec2& p) {
+    int x = std::min(cols - 1, std::max(0, (int)floorf((p.x - originX) / CELL)));
+    int y = std::min(rows - 1, std::max(0, (int)floorf((p.y - originY) / CELL)));
+    startCell = (uint32_t)(y * cols + x);
+}
+
+void SolvabilityMap::addGoalDisc(const Vec2& c, float r) {
+    int x0 = std::max(0, (int)floorf((c.x - r - originX) / CELL)), x1 = std::min(cols - 1, (int)floorf((c.x + r - originX) / CELL));
+    int y0 = std::max(0, (int)floorf((c.y - r - originY) / CELL)), y1 = std::min(rows - 1, (int)floorf((c.y + r - originY) / CELL));
+    for (int y = y0;y <= y1;++y) for (int x = x0;x <= x1;++x) {
+        float dx = originX + (x + 0.5f) * CELL - c.x, dy = originY + (y + 0.5f) * CELL - c.y;
+        if (dx * dx + dy * dy >= r * r) continue;
+        uint32_t u = (uint32_t)(y * cols + x);
+        goalCell[u] = 1;
+        if (searching) { updateVertex(u); changed = true; }
+    }
+}
+
+void SolvabilityMap::addBox(float cx, float cy, float hw, float hh, int delta) {
+    if (!ready()) return;
+    // cells overlapping the open box: [x, x + CELL] meets (lo, hi) when x < hi and x + CELL > lo
+    int x0 = std::max(0, (int)floorf((cx - hw - originX) / CELL)), x1 = std::min(cols - 1, (int)ceilf((cx + hw - originX) / CELL) - 1);
+    int y0 = std::max(0, (int)floorf((cy - hh - originY) / CELL)), y1 = std::min(rows - 1, (int)ceilf((cy + hh - originY) / CELL) - 1);
+    for (int y = y0;y <= y1;++y) for (int x = x0;x <= x1;++x) {
+        uint32_t u = (uint32_t)(y * cols + x);
+        bool was = blocked(u);
+        if (delta > 0) ++blockCount[u]; else if (blockCount[u]) --blockCount[u];
+        // u's moves and every move beside it change (a diagonal depends on the two cells it passes, which are u's neighbours)
+        if (searching && was != blocked(u)) { updateVertex(u); updateNeighbours(u); changed = true; }
+    }
+}
+
+// =====================
+// D* Lite (backwards: g is the time from a cell to the nearest goal, and the heuristic points at the start)
+// =====================
+
+uint32_t SolvabilityMap::heuristic(uint32_t u) const {
+    uint32_t dx = (uint32_t)std::abs((int)(u % cols) - (int)(startCell % cols)), dy = (uint32_t)std::abs((int)(u / cols) - (int)(startCell / cols));
+    return ORTHO_COST * std::max(dx, dy) + (DIAG_COST - ORTHO_COST) * std::min(dx, dy); // octile: never more than a real path
+}
+
+SolvabilityMap::Key SolvabilityMap::keyOf(uint32_t u) const {
+    uint32_t m = std::min(g[u], rhs[u]);
+    return Key{ m == INF ? INF : m + heuristic(u), m };
+}
+
+uint32_t SolvabilityMap::moveCost(uint32_t u, int d, uint32_t& v) const {
+    int x = (int)(u % cols), y = (int)(u / cols), nx = x + DX[d], ny = y + DY[d];
+    if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) return INF;
+    v = (uint32_t)(ny * cols + nx);
+    if (blocked(u) || blocked(v)) return INF;
+    if (d < 4) return ORTHO_COST;
+    // no cutting corners: both cells beside the diagonal must be free too
+    if (blocked((uint32_t)(y * cols + nx)) || blocked((uint32_t)(ny * cols + x))) return INF;
+    return DIAG_COST;
+}
+
+void SolvabilityMap::updateVertex(uint32_t u) {
+    if (goal(u)) rhs[u] = 0;
+    else {
+        uint32_t best = INF, v = 0;
+        for (int d = 0;d < 8;++d) { uint32_t c = moveCost(u, d, v); if (c != INF && g[v] != INF) best = std::min(best, c + g[v]); }
+        rhs[u] = best;
+    }
+    if (heapPos[u] >= 0) heapRemove(u);
+    if (g[u] != rhs[u]) heapPush(u, keyOf(u));
+}
+
+void SolvabilityMap::updateNeighbours(uint32_t u) {
+    int x = (int)(u % cols), y = (int)(u / cols);
+    for (int d = 0;d < 8;++d) {
+        int nx = x + DX[d], ny = y + DY[d];
+        if (nx >= 0 && ny >= 0 && nx < cols && ny < rows) updateVertex((uint32_t)(ny * cols + nx));
+    }
+}
+
+bool SolvabilityMap::solve() {
+    if (!ready()) return false;
+    if (!searching) {
+        for (uint32_t u = 0;u < (uint32_t)cellCount();++u) if (goal(u)) { rhs[u] = 0; heapPush(u, keyOf(u)); }
+        searching = true; changed = true;
+    }
+    const uint32_t s = startCell;
+    while (!heap.empty() && (less(heap[0].key, keyOf(s)) || rhs[s] != g[s])) {
+        const uint32_t u = heap[0].cell;
+        const Key kOld = heap[0].key, kNew = keyOf(u);
+        ++expanded;
+        if (less(kOld, kNew)) { heapRemove(u); heapPush(u, kNew); }
+        else if (g[u] > rhs[u]) { g[u] = rhs[u]; heapRemove(u); updateNeighbours(u); }
+        else { g[u] = INF; updateVertex(u); updateNeighbours(u); }
+    }
+    if (!changed) return false;
+    changed = false;
+    rebuildPath();
+    return true;
+}
+
+void SolvabilityMap::rebuildPath() {
+    route.clear();
+    uint32_t u = startCell;
+    if (g[u] == INF) return;
+    auto centre = [&](uint32_t c) { return Vec2(originX + (c % cols + 0.5f) * CELL, originY + (c / cols + 0.5f) * CELL); };
+    route.push_back(centre(u));
+    int lastDir = -1;
+    // downhill in g (every step strictly decreases it), keeping the last direction on ties so runs stay straight
+    for (size_t steps = 0;!goal(u) && steps < cellCount();++steps) {
+        uint32_t best = INF, next = u, v = 0; int bestDir = -1;
+        for (int i = -1;i < 8;++i) {
+            int d = i < 0 ? lastDir : i;
+            if (d < 0) continue;
+            uint32_t c = moveCost(u, d, v);
+            if (c != INF && g[v] != INF && c + g[v] < best) { best = c + g[v]; bestDir = d; next = v; }
+        }
+        if (bestDir < 0) break;
+        if (bestDir == lastDir) route.back() = centre(next); else route.push_back(centre(next));
+        lastDir = bestDir; u = next;
+    }
+}
+
+// =====================
+// Priority queue
+// =====================
+
+void SolvabilityMap::heapSwap(int a, int b) {
+    std::swap(heap[a], heap[b]);
+    heapPos[heap[a].cell] = a; heapPos[heap[b].cell] = b;
+}
+
+void SolvabilityMap::heapSift(int i) {
+    while (i > 0 && less(heap[i].key, heap[(i - 1) / 2].key)) { heapSwap(i, (i - 1) / 2); i = (i - 1) / 2; }
+    for (const int n = (int)heap.size();;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && less(heap[l].key, heap[m].key)) m = l;
+        if (r < n && less(heap[r].key, heap[m].key)) m = r;
+        if (m == i) break;
+        heapSwap(i, m); i = m;
+    }
+}
+
+void SolvabilityMap::heapPush(uint32_t u, const Key& k) {
+    heap.push_back(HeapEntry{ k, u });
+    heapPos[u] = (int32_t)heap.size() - 1;
+    heapSift((int)heap.size() - 1);
+}
+
+void SolvabilityMap::heapRemove(uint32_t u) {
+    int i = heapPos[u], last = (int)heap.size() - 1;
+    if (i != last) heapSwap(i, last);
+    heap.pop_back(); heapPos[u] = -1;
+    if (i < (int)heap.size()) heapSift(i);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// =====================
+// Solvability analysis for the editor: can the rocket reach the target's track, and how fast, at a given speed?
+// The play area is an occupancy grid. A cell is blocked while any obstacle's hit box (grown by the player's
+// margin, as in the hit tests) overlaps it, so every point of a free cell is clear. Moves go between the eight
+// neighbours and never cut a blocked corner. A path found here can therefore really be flown, and its time
+// is an upper bound on the best.
+//
+// The search is D* Lite, run backwards from the goal cells toward the start. Costs are whole numbers (70 per
+// orthogonal move, 99 per diagonal, 0.005% over sqrt 2) so the key comparisons tie exactly where the algorithm
+// needs them to; with float sums a repair could stop an ulp short of the start. The start never moves while
+// editing, so the key modifier stays 0 and this is D* Lite at its simplest. After a placement only the cells
+// whose shortest times actually change are re-expanded, so feedback stays interactive however many objects
+// the level has.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Vec2.h"
+
+class SolvabilityMap {
+public:
+    static constexpr float CELL = 0.025f; // world units; a little over half the player's obstacle margin
+    static constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+    // an empty grid over [x0, x1] x [y0, y1] (every cell free, no goals) for a rocket flying at speed units/s
+    void reset(float x0, float y0, float x1, float y1, float speed);
+    // forgets the grid; ready() is false until the next reset()
+    void invalidate() { cols = rows = 0; }
+    bool ready() const { return cols > 0; }
+
+    // before the first solve(): where the rocket starts, and goal cells (centres within r of c)
+    void setStart(const Vec2& p);
+    void addGoalDisc(const Vec2& c, float r);
+    // counts a box (centre, half extents) in (delta 1) or out (-1); cells that become blocked or free are
+    // queued for the next solve()
+    void addBox(float cx, float cy, float hw, float hh, int delta);
+
+    // brings the search up to date with every change since the last call; true if the result changed
+    bool solve();
+
+    // seconds from the start to the nearest goal, UNREACHABLE if there is no way through
+    float bestTime() const { return ready() && g[startCell] != INF ? g[startCell] * stepTime / ORTHO_COST : UNREACHABLE; }
+    // cell centres from the start to a goal with straight runs merged (empty when unreachable)
+    const std::vector<Vec2>& path() const { return route; }
+
+    size_t cellCount() const { return (size_t)cols * rows; }
+    uint64_t expansions() const { return expanded; } // vertices taken off the queue so far
+
+private:
+    static constexpr uint32_t ORTHO_COST = 70, DIAG_COST = 99, INF = 0xFFFFFFFFu;
+    struct Key { uint32_t k1, k2; };
+    struct HeapEntry { Key key; uint32_t cell; };
+    static bool less(const Key& a, const Key& b) { return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2); }
+
+    bool blocked(uint32_t u) const { return blockCount[u] != 0; }
+    bool goal(uint32_t u) const { return goalCell[u] && !blocked(u); }
+    uint32_t heuristic(uint32_t u) const;
+    Key keyOf(uint32_t u) const;
+    void updateVertex(uint32_t u);
+    void updateNeighbours(uint32_t u);
+    // cost of the move from u to its neighbour in direction d (0-7), INF if blocked
+    uint32_t moveCost(uint32_t u, int d, uint32_t& v) const;
+    void rebuildPath();
+
+    // indexed binary min-heap on Key
+    void heapPush(uint32_t u, const Key& k);
+    void heapRemove(uint32_t u);
+    void heapSift(int i);
+    void heapSwap(int a, int b);
+
+    int cols = 0, rows = 0;
+    float originX = 0.0f, originY = 0.0f;
+    float stepTime = 0.0f; // seconds per orthogonal move
+    uint32_t startCell = 0;
+    bool searching = false; // goals seeded
+    bool changed = false;   // something was queued since the last solve()
+    uint64_t expanded = 0;
+
+    std::vector<uint32_t> g, rhs; // cost to the nearest goal, INF if none
+    std::vector<uint32_t> blockCount; // boxes overlapping each cell
+    std::vector<uint8_t> goalCell;
+    std::vector<int32_t> heapPos; // -1 when not queued
+    std::vector<HeapEntry> heap;
+    std::vector<Vec2> route;
+};
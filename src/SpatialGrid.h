@@ -0,0 +1,171 @@
+#pragma once
+
+// =====================
+// Uniform spatial hash over world space. Stores entity indices by the cell their centre falls in,
+// so radius queries only look at the handful of cells around the query point instead of every entity.
+//
+// Entries live in one of two layers: a hash map of per-cell vectors that takes every insert, and a
+// flat cell table (open addressing into one id array) that is only ever filled in bulk, by adoptCells() or build().
+// The flat layer is what level files store, so a loaded level's grid is ready without a rebuild.
+// =====================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.h"
+
+// one slot of the flat layer: ids[start, start + count) lie in cell `key`; start == EMPTY marks a free slot
+struct GridCell { uint64_t key; uint32_t start, count; };
+
+class SpatialGrid {
+public:
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    explicit SpatialGrid(float cellSize = 0.125f) : cellSize(cellSize), invCell(1.0f / cellSize) {}
+
+    void clear() { cells.clear(); flatCells.clear(); flatIds.clear(); count = 0; }
+    size_t size() const { return count; }
+    float cell() const { return cellSize; }
+
+    void insert(uint32_t id, float x, float y) { cells[keyFor(x, y)].push_back(id); ++count; }
+
+    // removes id from the cell containing (x, y); returns false if it was not there
+    bool remove(uint32_t id, float x, float y) {
+        uint64_t key = keyFor(x, y);
+        auto it = cells.find(key);
+        if (it != cells.end()) {
+            std::vector<uint32_t>& ids = it->second;
+            for (size_t i = 0;i < ids.size();++i) {
+                if (ids[i] == id) { ids[i] = ids.back(); ids.pop_back(); --count; if (ids.empty()) cells.erase(it); return true; }
+            }
+        }
+        GridCell* c = flatFind(key);
+        if (!c) return false;
+        uint32_t* ids = flatIds.data() + c->start;
+        for (uint32_t i = 0;i < c->count;++i) {
+            if (ids[i] == id) { ids[i] = ids[c->count - 1]; --c->count; --count; return true; }
+        }
+        return false;
+    }
+
+    // renames an entry after its entity moved to a new index (swap-and-pop erase)
+    void relabel(uint32_t oldId, uint32_t newId, float x, float y) {
+        uint64_t key = keyFor(x, y);
+        auto it = cells.find(key);
+        if (it != cells.end()) for (auto& id : it->second) if (id == oldId) { id = newId; return; }
+        if (GridCell* c = flatFind(key)) {
+            uint32_t* ids = flatIds.data() + c->start;
+            for (uint32_t i = 0;i < c->count;++i) if (ids[i] == oldId) { ids[i] = newId; return; }
+        }
+    }
+
+    // both layers merged into a flat table with a power-of-two slot count (at most half full)
+    void exportCells(std::vector<GridCell>& table, std::vector<uint32_t>& ids) const {
+        std::unordered_map<uint64_t, std::vector<uint32_t>> merged;
+        if (!flatCells.empty()) {
+            merged = cells;
+            for (const GridCell& c : flatCells) if (c.start != EMPTY) for (uint32_t i = 0;i < c.count;++i) merged[c.key].push_back(flatIds[c.start + i]);
+        }
+        const std::unordered_map<uint64_t, std::vector<uint32_t>>& all = flatCells.empty() ? cells : merged;
+        size_t slots = 16;
+        while (slots < all.size() * 2) slots *= 2;
+        table.assign(slots, GridCell{ 0, EMPTY, 0 });
+        ids.clear(); ids.reserve(count);
+        for (auto& kv : all) {
+            size_t i = slotFor(kv.first, slots);
+            while (table[i].start != EMPTY) i = (i + 1) & (slots - 1);
+            table[i].key = kv.first; table[i].start = (uint32_t)ids.size(); table[i].count = (uint32_t)kv.second.size();
+            ids.insert(ids.end(), kv.second.begin(), kv.second.end());
+        }
+    }
+
+    // replaces the contents with a table from exportCells() (slot count a power of two, entries total)
+    void adoptCells(Column<GridCell> table, Column<uint32_t> ids, size_t entries) {
+        cells.clear(); flatCells = std::move(table); flatIds = std::move(ids); count = entries;
+    }
+    void detach() { flatCells.detach(); flatIds.detach(); }
+
+    // replaces the contents with ids 0..n-1 at (xs[i], ys[i]), skipping those whose bit in `active` is clear
+    // (when given), built straight into the flat layer: one sort instead of a hash-map insert per entry
+    void build(const float* xs, const float* ys, const uint64_t* active, size_t n) {
+        std::vector<std::pair<uint64_t, uint32_t>> entries;
+        entries.reserve(n);
+        for (size_t i = 0;i < n;++i) if (!active || ((active[i >> 6] >> (i & 63)) & 1)) entries.emplace_back(keyFor(xs[i], ys[i]), (uint32_t)i);
+        std::sort(entries.begin(), entries.end());
+        size_t distinct = 0;
+        for (size_t i = 0;i < entries.size();++i) distinct += i == 0 || entries[i].first != entries[i - 1].first;
+        size_t slots = 16;
+        while (slots < distinct * 2) slots *= 2;
+        Column<GridCell> table; table.reserve(slots);
+        for (size_t i = 0;i < slots;++i) table.push_back(GridCell{ 0, EMPTY, 0 });
+        Column<uint32_t> ids; ids.reserve(entries.size());
+        for (size_t i = 0, j;i < entries.size();i = j) {
+            for (j = i;j < entries.size() && entries[j].first == entries[i].first;++j) ids.push_back(entries[j].second);
+            size_t slot = slotFor(entries[i].first, slots);
+            while (table[slot].start != EMPTY) slot = (slot + 1) & (slots - 1);
+            table[slot] = GridCell{ entries[i].first, (uint32_t)i, (uint32_t)(j - i) };
+        }
+        adoptCells(std::move(table), std::move(ids), entries.size());
+    }
+
+    // approximate footprint: hash-map nodes and id vectors, plus the flat layer
+    size_t memoryBytes() const {
+        size_t bytes = cells.bucket_count() * sizeof(void*) + cells.size() * (sizeof(uint64_t) + sizeof(std::vector<uint32_t>) + 2 * sizeof(void*));
+        for (auto& kv : cells) bytes += kv.second.capacity() * sizeof(uint32_t);
+        return bytes + flatCells.size() * sizeof(GridCell) + flatIds.size() * sizeof(uint32_t);
+    }
+
+    // calls visit(id) for every entry whose cell overlaps the square [x-r, x+r] x [y-r, y+r];
+    // visit returns true to stop early. Callers do their own exact distance test.
+    template <class Visit>
+    bool query(float x, float y, float r, Visit&& visit) const { return queryRect(x - r, y - r, x + r, y + r, visit); }
+
+    // same for the rectangle [x0, x1] x [y0, y1]
+    template <class Visit>
+    bool queryRect(float x0, float y0, float x1, float y1, Visit&& visit) const {
+        if (count == 0) return false;
+        int cx0 = cellCoord(x0), cx1 = cellCoord(x1);
+        int cy0 = cellCoord(y0), cy1 = cellCoord(y1);
+        for (int cy = cy0;cy <= cy1;++cy) for (int cx = cx0;cx <= cx1;++cx) {
+            uint64_t key = pack(cx, cy);
+            if (!cells.empty()) {
+                auto it = cells.find(key);
+                if (it != cells.end()) for (uint32_t id : it->second) if (visit(id)) return true;
+            }
+            if (const GridCell* c = flatFind(key)) {
+                const uint32_t* ids = flatIds.data() + c->start;
+                for (uint32_t i = 0;i < c->count;++i) if (visit(ids[i])) return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    int cellCoord(float v) const { return (int)std::floor(v * invCell); }
+    static uint64_t pack(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+    uint64_t keyFor(float x, float y) const { return pack(cellCoord(x), cellCoord(y)); }
+    static size_t slotFor(uint64_t key, size_t slots) { uint64_t h = key * 0x9E3779B97F4A7C15ull; return (size_t)(h ^ (h >> 32)) & (slots - 1); }
+
+    const GridCell* flatFind(uint64_t key) const {
+        size_t slots = flatCells.size();
+        if (!slots) return nullptr;
+        // bounded probe and span check: a table read from a damaged file can give wrong answers but not stray reads
+        for (size_t i = slotFor(key, slots), n = 0;n < slots;i = (i + 1) & (slots - 1), ++n) {
+            const GridCell& c = flatCells[i];
+            if (c.start == EMPTY) return nullptr;
+            if (c.key == key) return (uint64_t)c.start + c.count <= flatIds.size() ? &c : nullptr;
+        }
+        return nullptr;
+    }
+    GridCell* flatFind(uint64_t key) { return const_cast<GridCell*>(static_cast<const SpatialGrid*>(this)->flatFind(key)); }
+
+    float cellSize, invCell;
+    size_t count = 0;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+    Column<GridCell> flatCells;
+    Column<uint32_t> flatIds;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+// =====================
+// Bounded lock-free queue for one producer thread and one consumer thread: a ring of N slots (a power of
+// two) with a head the consumer advances and a tail the producer advances. Neither side blocks; push()
+// reports a full queue instead of waiting.
+// =====================
+
+#include <atomic>
+#include <cstddef>
+
+template <class T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+public:
+    // producer side; false if the queue is full (the item is dropped)
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) return false;
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side; false if the queue is empty
+    bool pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = items[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[N];
+    alignas(64) std::atomic<size_t> head{ 0 }; // next slot to pop, written by the consumer only
+    alignas(64) std::atomic<size_t> tail{ 0 }; // next slot to push, written by the producer only
+};
@@ -0,0 +1,31 @@
+#include "Starfield.h"
+
+// per layer, far to near: parallax depth, share of the stars, brightness
+struct StarLayer { float depth, share, brightness; };
+static const StarLayer STAR_LAYERS[STARFIELD_LAYERS] = {
+    { 0.05f, 0.45f, 0.45f }, { 0.15f, 0.30f, 0.65f }, { 0.35f, 0.17f, 0.85f }, { 0.70f, 0.08f, 1.00f }
+};
+
+void buildStarfield(int count, uint32_t seed, std::vector<StarVertex>& out, int layerStart[STARFIELD_LAYERS + 1]) {
+    // xorshift32 like randf(), so the sky is the same on every platform
+    uint32_t state = seed ? seed : 0x9E3779B9u;
+    auto uniform = [&]() { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return float(state >> 8) / float(1u << 24); };
+    out.clear(); out.reserve(count > 0 ? count : 0);
+    int placed = 0;
+    for (int l = 0;l < STARFIELD_LAYERS;++l) {
+        layerStart[l] = placed;
+        int n = l + 1 < STARFIELD_LAYERS ? (int)(count * STAR_LAYERS[l].share + 0.5f) : count - placed;
+        for (int i = 0;i < n && placed < count;++i, ++placed) {
+            StarVertex s;
+            s.x = uniform(); s.y = uniform(); s.depth = STAR_LAYERS[l].depth; s.phase = uniform() * 6.2831853f;
+            // white with a slight blue or yellow cast
+            float b = STAR_LAYERS[l].brightness * (0.8f + 0.2f * uniform()), tint = uniform() * 2.0f - 1.0f;
+            s.r = (uint8_t)(255.0f * b * (tint > 0.0f ? 1.0f : 1.0f + 0.2f * tint));
+            s.g = (uint8_t)(255.0f * b);
+            s.b = (uint8_t)(255.0f * b * (tint < 0.0f ? 1.0f : 1.0f - 0.2f * tint));
+            s.a = 255;
+            out.push_back(s);
+        }
+    }
+    layerStart[STARFIELD_LAYERS] = placed;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// =====================
+// Parallax starfield. The stars are built once into a vertex array that the renderer uploads to a static
+// buffer; a vertex shader moves them every frame from the time and the camera height alone, so the CPU
+// cost of the background does not depend on the star count. The sky is one screen tiled in both
+// directions: far layers hold many dim, small, slow stars and near layers a few bright, big, fast ones.
+// starPosition() is the same motion on the CPU, for GL without shaders.
+// =====================
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Vec2.h"
+
+const int STARFIELD_LAYERS = 4;
+const int STARFIELD_DEFAULT_STARS = 2000;
+
+// x, y: home position in the [0, 1) tile; depth: parallax factor (0 stays put, 1 moves with the world);
+// phase: twinkle offset. Packed for glVertexPointer(4, GL_FLOAT) plus glColorPointer.
+struct StarVertex { float x, y, depth, phase; uint8_t r, g, b, a; };
+
+// drift in tile units per second at depth 1, on top of the camera's scroll
+const float STAR_DRIFT_X = 0.01f, STAR_DRIFT_Y = 0.02f;
+const float STAR_TWINKLE_RATE = 3.0f; // radians per second
+
+// count stars, far layer first; layerStart[l] is the first star of layer l and layerStart[STARFIELD_LAYERS] the count
+void buildStarfield(int count, uint32_t seed, std::vector<StarVertex>& out, int layerStart[STARFIELD_LAYERS + 1]);
+
+// screen position at time t with the camera at scroll (world y): the tile moves by half the camera's travel
+// (the screen is two units tall) times the depth, and wraps
+inline Vec2 starPosition(const StarVertex& s, float t, float scroll) {
+    float x = s.x + t * STAR_DRIFT_X * s.depth, y = s.y - (t * STAR_DRIFT_Y + scroll * 0.5f) * s.depth;
+    x -= floorf(x); y -= floorf(y);
+    return Vec2(x * 2.0f - 1.0f, y * 2.0f - 1.0f);
+}
+inline float starPointSize(float depth) { return 1.0f + 2.0f * depth; }
+inline float starTwinkle(const StarVertex& s, float t) { return 0.75f + 0.25f * sinf(t * STAR_TWINKLE_RATE + s.phase); }
@@ -0,0 +1,44 @@
+#pragma once
+
+// =====================
+// Lock-free triple buffer for one writer thread and one reader thread. The writer fills writeSlot() and
+// publish()es it; the reader calls acquire() and then reads readSlot(), which stays untouched until its
+// next acquire(). Three slots mean each side always has one of its own and the third is the hand-off, so
+// neither side ever waits: a writer that publishes faster than the reader acquires just replaces the
+// hand-off, and a reader that acquires faster keeps the slot it already has.
+// Slots are reused, so a T holding vectors keeps their storage from frame to frame.
+// =====================
+
+#include <atomic>
+#include <cstdint>
+
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // writer side
+    T& writeSlot() { return slots[back]; }
+    void publish() {
+        uint8_t prev = handoff.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel);
+        back = prev & INDEX;
+    }
+
+    // reader side: takes the latest published slot; false (and the same slot as before) if nothing new
+    bool acquire() {
+        if (!(handoff.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t prev = handoff.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX;
+        return true;
+    }
+    const T& readSlot() const { return slots[front]; }
+
+private:
+    enum : uint8_t { INDEX = 3, FRESH = 4 };
+    T slots[3];
+    std::atomic<uint8_t> handoff{ 1 }; // index of the hand-off slot, FRESH once the writer has put a new one there
+    uint8_t back = 0;                  // writer's slot
+    uint8_t front = 2;                 // reader's slot
+};
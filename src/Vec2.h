@@ -0,0 +1,3 @@
+#pragma once
+
+struct Vec2 { float x, y; Vec2(float X = 0, float Y = 0) :x(X), y(Y) {} };
@@ -0,0 +1,161 @@
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "EntityKernels.h"
+#include "JobSystem.h"
+
+// held arrow keys per action, as the front end samples them (right and up positive)
+static const float ACTION_DX[ACT_COUNT] = { 0, 0, 1, 1, 1, 0, -1, -1, -1 };
+static const float ACTION_DY[ACT_COUNT] = { 0, 1, 1, 0, -1, -1, -1, 0, 1 };
+
+static inline void clearBit(uint64_t* words, size_t i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+static size_t wordsFor(size_t n) { return (n + 63) / 64; }
+
+VecEnv::VecEnv(const GameState& start, size_t count, const VecEnvConfig& config) : cfg(config), level(start) {
+    // the editor's route map is of no use in play
+    level.solvability = SolvabilityMap(); level.solvabilityChunks = 0;
+    if (level.gameOver) resetToEditing(level);
+    if (!level.gameStarted) applyKey(level, 'r');
+
+    startRound = level;
+
+    // bit runs, and their starting values: every obstacle, the pickups still active in the level
+    const int bands = level.chunks.bandCount();
+    obstacleRun.assign(bands, 0); collectibleRun.assign(bands, 0); powerupRun.assign(bands, 0);
+    level.chunks.forEachResident([&](const LevelChunk& ch) {
+        obstacleRun[ch.band] = (uint32_t)bitWords; bitWords += wordsFor(ch.obstacles.size());
+        collectibleRun[ch.band] = (uint32_t)bitWords; bitWords += wordsFor(ch.collectibles.size());
+        powerupRun[ch.band] = (uint32_t)bitWords; bitWords += wordsFor(ch.powerups.size());
+    });
+    const MovingObstacleStore& mo = level.motion.obstacles; const MovingCollectibleStore& mc = level.motion.collectibles;
+    movingObstacleRun = (uint32_t)bitWords; bitWords += wordsFor(mo.size());
+    movingCollectibleRun = (uint32_t)bitWords; bitWords += wordsFor(mc.size());
+    startBits.assign(bitWords, 0);
+    auto allOn = [&](uint32_t run, size_t n) { for (size_t k = 0;k < n;++k) startBits[run + (k >> 6)] |= uint64_t(1) << (k & 63); };
+    auto copy = [&](uint32_t run, const ActiveBits& a) { std::copy(a.words(), a.words() + a.wordCount(), startBits.begin() + run); };
+    level.chunks.forEachResident([&](const LevelChunk& ch) {
+        allOn(obstacleRun[ch.band], ch.obstacles.size());
+        copy(collectibleRun[ch.band], ch.collectibles.active);
+        copy(powerupRun[ch.band], ch.powerups.active);
+    });
+    allOn(movingObstacleRun, mo.size());
+    copy(movingCollectibleRun, mc.active);
+
+    moverFloats = 3 * (mo.size() + mc.size());
+    startMovers.reserve(moverFloats);
+    for (const MoverStore* m : { &mo.motion, &mc.motion }) {
+        startMovers.insert(startMovers.end(), m->dist.begin(), m->dist.end());
+        startMovers.insert(startMovers.end(), m->x.begin(), m->x.end());
+        startMovers.insert(startMovers.end(), m->y.begin(), m->y.end());
+    }
+
+    rounds.resize(count); bits.resize(count * bitWords); movers.resize(count * moverFloats);
+    obs.assign(count * VEC_OBS_DIM, 0.0f); rew.assign(count, 0.0f); done.assign(count, 0); finished.assign(count, 0);
+    for (size_t i = 0;i < count;++i) { restart(i); observe(i); }
+}
+
+void VecEnv::reset() {
+    jobSystem().parallelFor(rounds.size(), cfg.grain, [&](size_t b, size_t e) { for (size_t i = b;i < e;++i) reset(i); });
+}
+
+void VecEnv::reset(size_t i) {
+    restart(i);
+    rew[i] = 0.0f; done[i] = 0;
+    observe(i);
+}
+
+// overwrites the instance's state with the level's start, in place
+void VecEnv::restart(size_t i) {
+    rounds[i] = startRound;
+    if (bitWords) memcpy(bits.data() + i * bitWords, startBits.data(), bitWords * sizeof(uint64_t));
+    if (moverFloats) memcpy(movers.data() + i * moverFloats, startMovers.data(), moverFloats * sizeof(float));
+}
+
+void VecEnv::step(const uint8_t* actions) {
+    jobSystem().parallelFor(rounds.size(), cfg.grain, [&](size_t b, size_t e) { for (size_t i = b;i < e;++i) stepInstance(i, actions[i]); });
+    ++steps;
+}
+
+uint64_t VecEnv::roundsFinished() const {
+    uint64_t n = 0;
+    for (uint32_t r : finished) n += r;
+    return n;
+}
+
+// what the rules take out of play, cleared in the instance's bits where GameCore removes it from the level
+struct InstanceView {
+    RoundView view;
+    uint64_t* bits; // view.bits, writable
+};
+
+static void usedUp(void* ctx, RoundEvent e, const EntityRef& ref) {
+    const InstanceView& in = *static_cast<const InstanceView*>(ctx);
+    const RoundView& v = in.view;
+    switch (e) {
+    case ROUND_OBSTACLE_BROKEN: clearBit(in.bits, (size_t)(ref.band == MOVING_BAND ? v.movingObstacleRun : v.obstacleRun[ref.band]) * 64 + ref.index); break;
+    case ROUND_COLLECTED: clearBit(in.bits, (size_t)(ref.band == MOVING_BAND ? v.movingCollectibleRun : v.collectibleRun[ref.band]) * 64 + ref.index); break;
+    case ROUND_POWERUP: clearBit(in.bits, (size_t)v.powerupRun[ref.band] * 64 + ref.index); break;
+    default: break;
+    }
+}
+
+// the level seen through instance i's bits and followers
+RoundView VecEnv::view(size_t i) const {
+    RoundView v;
+    v.level = &level;
+    v.bits = bits.data() + i * bitWords;
+    v.obstacleRun = obstacleRun.data(); v.collectibleRun = collectibleRun.data(); v.powerupRun = powerupRun.data();
+    v.movingObstacleRun = movingObstacleRun; v.movingCollectibleRun = movingCollectibleRun;
+    const size_t no = level.motion.obstacles.size(), nc = level.motion.collectibles.size();
+    const float* mv = movers.data() + i * moverFloats;
+    v.movingObstacleX = mv + no; v.movingObstacleY = mv + 2 * no;
+    v.movingCollectibleX = mv + 3 * no + nc; v.movingCollectibleY = mv + 3 * no + 2 * nc;
+    return v;
+}
+
+// as step() with held keys: applyHeldMove(), then tick(), by the same rules (moveRound(), tickRound()) with
+// only what changes the outcome: no status messages, effects, camera or animation phases
+void VecEnv::stepInstance(size_t i, uint8_t action) {
+    RoundState& r = rounds[i];
+    if (action >= ACT_COUNT) action = ACT_NONE;
+    const int score = r.score, lives = r.lives;
+    const bool wasOver = r.gameOver;
+    const float dx = ACTION_DX[action], dy = ACTION_DY[action];
+    if (dx == 0.0f && dy == 0.0f) r.obstacleContact = false; // letting go ends a contact
+    else {
+        InstanceView in{ view(i), bits.data() + i * bitWords };
+        moveRound(r, in.view, dx, dy, cfg.dt * HELD_STEPS_PER_SECOND, true, RoundListener{ usedUp, &in });
+    }
+    // path followers (a handful per level: one instance's share is not worth a job)
+    float* mv = movers.data() + i * moverFloats;
+    for (const MoverStore* m : { &level.motion.obstacles.motion, &level.motion.collectibles.motion }) {
+        const size_t n = m->size();
+        advanceMovers(level.motion.paths, *m, mv, mv + n, mv + 2 * n, 0, n, cfg.dt);
+        mv += 3 * n;
+    }
+    tickRound(r, level, cfg.dt, true, RoundListener());
+    // a round that had already ended (autoReset off) keeps reporting done with nothing more to gain
+    bool ended = r.gameOver && !wasOver;
+    rew[i] = (float)(r.score - score) - cfg.lifePenalty * (float)(lives - r.lives) + (ended && r.gameWin ? cfg.winBonus : 0.0f);
+    done[i] = r.gameOver ? 1 : 0;
+    if (ended) { ++finished[i]; if (cfg.autoReset) restart(i); }
+    observe(i);
+}
+
+void VecEnv::observe(size_t i) {
+    const RoundState& r = rounds[i];
+    const RoundView v = view(i);
+    float* o = &obs[i * VEC_OBS_DIM];
+    o[OBS_X] = r.playerX; o[OBS_Y] = r.playerY;
+    o[OBS_TARGET_DX] = r.targetPos.x - r.playerX; o[OBS_TARGET_DY] = r.targetPos.y - r.playerY;
+    o[OBS_TIME] = r.gameTimer / GAME_DURATION;
+    o[OBS_LIVES] = (float)r.lives; o[OBS_SHIELD] = r.shieldTimer; o[OBS_SPEED] = r.speedTimer;
+    const float diag = VEC_PROBE_DISTANCE * 0.70710678f;
+    for (int k = 0;k < 8;++k) {
+        float scale = ACTION_DX[k + 1] != 0.0f && ACTION_DY[k + 1] != 0.0f ? diag : VEC_PROBE_DISTANCE;
+        o[OBS_BLOCKED + k] = collidesWithObstacle(v, r.playerX + ACTION_DX[k + 1] * scale, r.playerY + ACTION_DY[k + 1] * scale) ? 1.0f : 0.0f;
+    }
+}
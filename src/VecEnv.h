@@ -0,0 +1,104 @@
+#pragma once
+
+// =====================
+// Batched environment for automated agents: N independent rounds of one level, stepped together. The level
+// (chunks, grids, paths, the target's track) is held once and only read; what a round changes lives in flat
+// per-instance arrays: the player, timers, score and lives (RoundState), one bit per entity for what the round
+// has used up (obstacles destroyed, collectibles and power-ups taken), and the path followers' positions.
+// Starting the next round overwrites those in place, so a steady step neither copies the level nor
+// allocates. A tick runs the game's own rules (moveRound(), tickRound()) through a RoundView of those
+// arrays, as step() with held arrow keys, so a round played here is the same round a player would get from
+// the same key presses.
+//
+// One call steps every instance with its own action, spread over the job system. The outputs are flat arrays
+// in instance order: VEC_OBS_DIM floats of observation, one reward and one done flag per instance. Instances
+// never interact, so the results are identical for any thread count.
+// =====================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GameCore.h"
+
+// what an instance does for one tick: hold the arrow keys in one of eight directions, or none
+enum VecAction : uint8_t {
+    ACT_NONE = 0, ACT_UP, ACT_UP_RIGHT, ACT_RIGHT, ACT_DOWN_RIGHT, ACT_DOWN, ACT_DOWN_LEFT, ACT_LEFT, ACT_UP_LEFT, ACT_COUNT
+};
+
+// observation layout, per instance. Positions are world units. OBS_BLOCKED + k is 1 when a point
+// VEC_PROBE_DISTANCE away in action direction k + 1 is inside an obstacle's hit box, else 0.
+enum VecObsField {
+    OBS_X = 0, OBS_Y,
+    OBS_TARGET_DX, OBS_TARGET_DY, // target relative to the rocket
+    OBS_TIME,                     // round time left, as a fraction of GAME_DURATION
+    OBS_LIVES, OBS_SHIELD, OBS_SPEED, // lives left; seconds of shield and speed-up left
+    OBS_BLOCKED,
+    VEC_OBS_DIM = OBS_BLOCKED + 8
+};
+const float VEC_PROBE_DISTANCE = 0.1f;
+
+struct VecEnvConfig {
+    float dt = 1.0f / 60.0f;  // seconds per step, as the simulation thread ticks
+    float lifePenalty = 10.0f; // reward per life lost; points scored count one each
+    float winBonus = 100.0f;   // reward for ending the round on the target
+    bool autoReset = true;     // an instance whose round ended starts the next one in the same step
+    size_t grain = 64;         // instances per job range
+};
+
+class VecEnv {
+public:
+    // count instances of level (a GameState as loaded or edited, copied once); each starts its round as R would
+    VecEnv(const GameState& level, size_t count, const VecEnvConfig& config = VecEnvConfig());
+
+    size_t size() const { return rounds.size(); }
+    const VecEnvConfig& config() const { return cfg; }
+
+    // a fresh round for every instance, or just one; refreshes their observations
+    void reset();
+    void reset(size_t i);
+
+    // one tick of every instance, actions[i] for instance i (out-of-range actions count as ACT_NONE).
+    // With autoReset, an instance whose round ended reports done and the observation of its next round.
+    void step(const uint8_t* actions);
+
+    // size() * VEC_OBS_DIM floats, instance by instance
+    const float* observations() const { return obs.data(); }
+    // of the last step()
+    const float* rewards() const { return rew.data(); }
+    const uint8_t* dones() const { return done.data(); }
+
+    const RoundState& round(size_t i) const { return rounds[i]; }
+    uint64_t stepCount() const { return steps; }       // step() calls
+    uint64_t roundsFinished() const;                    // rounds that ended, over all instances
+
+private:
+    void restart(size_t i);
+    void stepInstance(size_t i, uint8_t action);
+    void observe(size_t i);
+    RoundView view(size_t i) const;
+
+    VecEnvConfig cfg;
+    GameState level; // with its round started; never written after construction
+
+    // Entity bits: each resident band's obstacles, collectibles and power-ups, then the moving obstacles and
+    // moving collectibles, every run starting on a word so it can go straight to the kernels. A bit is set
+    // while the entity is in play. Runs are first words, per band for the chunks.
+    std::vector<uint32_t> obstacleRun, collectibleRun, powerupRun;
+    uint32_t movingObstacleRun = 0, movingCollectibleRun = 0;
+    size_t bitWords = 0;
+    // path followers: dist, x, y of the moving obstacles, then the same of the moving collectibles
+    size_t moverFloats = 0;
+    RoundState startRound;
+    std::vector<uint64_t> startBits;
+    std::vector<float> startMovers;
+
+    // per instance, instance by instance
+    std::vector<RoundState> rounds;
+    std::vector<uint64_t> bits;  // bitWords each
+    std::vector<float> movers;   // moverFloats each
+    std::vector<float> obs, rew;
+    std::vector<uint8_t> done;
+    std::vector<uint32_t> finished; // rounds ended, written only by the range that steps the instance
+    uint64_t steps = 0;
+};
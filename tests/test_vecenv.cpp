@@ -0,0 +1,113 @@
+// =====================
+// VecEnv against the game: a GameState and a VecEnv instance of the same level, stepped with the same random
+// held keys until every round is over, must agree on every field of the round and on every observation
+// after every step. The level has a chunk big enough for the grid queries, path followers of both kinds and
+// shields to break through obstacles with. Exit code 1 on the first difference.
+// =====================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "GameCore.h"
+#include "LevelGen.h"
+#include "VecEnv.h"
+
+static const float DX[ACT_COUNT] = { 0, 0, 1, 1, 1, 0, -1, -1, -1 };
+static const float DY[ACT_COUNT] = { 0, 1, 1, 0, -1, -1, -1, 0, 1 };
+
+static bool same(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+// every field of RoundState, bit for bit
+static const char* differingField(const RoundState& a, const RoundState& b) {
+    if (!same(a.playerX, b.playerX)) return "playerX";
+    if (!same(a.playerY, b.playerY)) return "playerY";
+    if (!same(a.playerSpeed, b.playerSpeed)) return "playerSpeed";
+    if (a.score != b.score) return "score";
+    if (a.lives != b.lives) return "lives";
+    if (!same(a.gameTimer, b.gameTimer)) return "gameTimer";
+    if (a.gameOver != b.gameOver) return "gameOver";
+    if (a.gameWin != b.gameWin) return "gameWin";
+    if (a.shieldActive != b.shieldActive) return "shieldActive";
+    if (!same(a.shieldTimer, b.shieldTimer)) return "shieldTimer";
+    if (a.speedActive != b.speedActive) return "speedActive";
+    if (!same(a.speedTimer, b.speedTimer)) return "speedTimer";
+    if (a.obstacleContact != b.obstacleContact) return "obstacleContact";
+    if (!same(a.targetPos.x, b.targetPos.x) || !same(a.targetPos.y, b.targetPos.y)) return "targetPos";
+    if (!same(a.targetDist, b.targetDist)) return "targetDist";
+    return nullptr;
+}
+
+// the observation VecEnv documents, worked out from the game's own state and queries
+static const char* differingObservation(const float* o, const GameState& g) {
+    if (!same(o[OBS_X], g.playerX) || !same(o[OBS_Y], g.playerY)) return "position";
+    if (!same(o[OBS_TARGET_DX], g.targetPos.x - g.playerX) || !same(o[OBS_TARGET_DY], g.targetPos.y - g.playerY)) return "target";
+    if (!same(o[OBS_TIME], g.gameTimer / GAME_DURATION)) return "time";
+    if (o[OBS_LIVES] != (float)g.lives || !same(o[OBS_SHIELD], g.shieldTimer) || !same(o[OBS_SPEED], g.speedTimer)) return "lives/power-ups";
+    const float diag = VEC_PROBE_DISTANCE * 0.70710678f;
+    for (int k = 0;k < 8;++k) {
+        float scale = DX[k + 1] != 0.0f && DY[k + 1] != 0.0f ? diag : VEC_PROBE_DISTANCE;
+        bool blocked = collidesWithObstacle(g, g.playerX + DX[k + 1] * scale, g.playerY + DY[k + 1] * scale);
+        if (o[OBS_BLOCKED + k] != (blocked ? 1.0f : 0.0f)) return "blocked";
+    }
+    return nullptr;
+}
+
+int main() {
+    GameState level; initGame(level, 11u);
+    LevelGenOptions gen; gen.count = 2000; gen.seed = 11u; generateLevel(level, gen);
+    const Vec2 loop[4] = { Vec2(-0.3f, 0.0f), Vec2(0.0f, 0.1f), Vec2(0.3f, 0.0f), Vec2(0.0f, -0.1f) };
+    int p = level.motion.paths.addCatmullRom(loop, 4, true);
+    for (int k = 0;k < 40;++k) {
+        addMovingObstacle(level, p, Vec2(-0.6f + 0.03f * k, -0.5f + 0.08f * k), 0.05f * k, 0.25f, 0.08f, 0.06f);
+        addMovingCollectible(level, p, Vec2(0.5f - 0.02f * k, -0.6f + 0.09f * k), 0.07f * k, -0.3f, 0.0f);
+    }
+    // a shield right above the start, so most rounds break through something before they run into things
+    // unprotected; speed-ups along the way
+    PowerUp shield; shield.pos = Vec2(-0.06f, -0.86f); shield.type = P_SHIELD; addPowerup(level, shield);
+    for (int k = 0;k < 30;++k) { PowerUp pu; pu.pos = Vec2(-0.9f + 0.06f * k, -0.7f + 0.12f * k); pu.type = P_SPEED; addPowerup(level, pu); }
+    size_t biggest = 0;
+    level.chunks.forEachResident([&](const LevelChunk& ch) { biggest = std::max(biggest, ch.obstacles.size()); });
+    if (biggest <= SMALL_LEVEL_SCAN) { printf("FAIL: no chunk has more than %zu obstacles, the grid queries go untested\n", SMALL_LEVEL_SCAN); return 1; }
+
+    const size_t N = 32;
+    VecEnvConfig cfg; cfg.autoReset = false;
+    VecEnv env(level, N, cfg);
+    std::vector<GameState> games(N, level);
+    for (GameState& g : games) if (!g.gameStarted) applyKey(g, 'r');
+
+    // mostly climbing, so rounds run into obstacles, pickups and the target as well as the clock
+    uint32_t rng = 99u;
+    std::vector<uint8_t> actions(N);
+    int shields = 0, broken = 0, hits = 0, releases = 0, wins = 0;
+    for (int n = 0;;++n) {
+        for (uint8_t& a : actions) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            a = (rng >> 8) % 3 ? (uint8_t)(rng % 2 ? ACT_UP : (rng >> 4) % 2 ? ACT_UP_LEFT : ACT_UP_RIGHT) : (uint8_t)((rng >> 12) % ACT_COUNT);
+        }
+        env.step(actions.data());
+        size_t over = 0;
+        for (size_t i = 0;i < N;++i) {
+            GameState& g = games[i];
+            const int score = g.score, lives = g.lives;
+            const bool shielded = g.shieldActive, contact = g.obstacleContact, wasOver = g.gameOver;
+            Inputs in; in.moveX = DX[actions[i]]; in.moveY = DY[actions[i]];
+            step(g, in, cfg.dt);
+            shields += g.shieldActive && !shielded; broken += shielded && g.score > score;
+            hits += g.lives < lives; releases += contact && actions[i] == ACT_NONE; wins += g.gameWin && !wasOver;
+            const char* field = differingField(env.round(i), g);
+            if (!field) field = differingObservation(env.observations() + i * VEC_OBS_DIM, g);
+            if (!field && env.dones()[i] != (g.gameOver ? 1 : 0)) field = "done";
+            if (field) { printf("FAIL: step %d, instance %zu: %s differs\n", n, i, field); return 1; }
+            over += g.gameOver;
+        }
+        if (over == N) {
+            printf("ok: %zu rounds to game over in %d steps (%d won; %d shields picked, %d steps breaking obstacles; %d hits, %d contacts let go)\n", N, n + 1, wins, shields, broken, hits, releases);
+            break;
+        }
+    }
+    if (!shields || !broken) { printf("FAIL: no shield was used, the shield rules go untested\n"); return 1; }
+    if (!hits || !releases) { printf("FAIL: no obstacle contact was held and let go, the contact rule goes untested\n"); return 1; }
+    return 0;
+}
@@ -0,0 +1,315 @@
+// =====================
+// Headless renderer: plays a scripted session through the real simulation and renderer into an
+// offscreen EGL context (Mesa's llvmpipe works, so no display or GPU is needed), dumps chosen frames
+// as PPM images and reports per-frame render time.
+//
+//   SpaceEditorHeadless [--frames N] [--size WxH] [--script file] [--dump 0,60,120 | --dump-every N]
+//                       [--out dir] [--timings file.csv] [--seed N] [--overlay]
+//                       [--level file] [--save-level file] [--threads N] [--record file.sprp] [--generate N]
+//                       [--no-alloc-after N] [--stars N]
+//
+// --level loads a level file before the first frame; --save-level writes the level after the last.
+// --generate writes a procedural level of N objects (src/LevelGen.h) to the --level file (generated.splv
+// without one) and plays on it.
+// --record writes the session as a replay (src/Replay.h) that SpaceEditorReplay plays back and checks.
+// --threads sizes the job pool (1 = no worker threads); frames are identical for any count.
+// --stars sets the size of the parallax starfield (src/Starfield.h).
+// Heap allocations are counted per frame (src/AllocCounter.h); --no-alloc-after N fails the run (exit code 3)
+// if any frame from N on allocates.
+// Script lines are "<frame> <event> [args]", applied before that frame's tick:
+//   12 click -0.8 -0.95     left click at screen position ([-1, 1] each way, as in the window)
+//   30 key r                plain key
+//   31 move 0 1             one movement step
+//   40 hold -1 1            hold arrow keys in this direction from now on (hold 0 0 releases them)
+// Blank lines and lines starting with # are ignored. Without --script a built-in session is played.
+// =====================
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GLFunctions.h"
+
+#include "AllocCounter.h"
+#include "ChunkStreamer.h"
+#include "GameCore.h"
+#include "GLRenderer.h"
+#include "GpuTimer.h"
+#include "JobSystem.h"
+#include "LevelFile.h"
+#include "LevelGen.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Scene.h"
+
+struct ScriptEvent {
+    int frame; InputEvent input;
+    bool hold = false; float holdX = 0.0f, holdY = 0.0f; // a hold event sets the held direction instead
+};
+
+// editor session: one of each tool placed, the game started, then a climb toward the target
+static const char* DEFAULT_SCRIPT =
+    "5 click -0.8 -0.95\n"  "6 click -0.3 -0.4\n" "7 click 0.4 -0.1\n"
+    "10 click -0.35 -0.95\n" "11 click 0.0 -0.6\n" "12 click 0.3 -0.3\n" "13 click -0.5 0.2\n"
+    "15 click 0.1 -0.95\n"   "16 click -0.6 -0.5\n"
+    "18 click 0.55 -0.95\n"  "19 click 0.6 0.1\n"
+    "25 key r\n"
+    "30 move 0 1\n" "34 move 0 1\n" "38 move 0 1\n" "42 move 1 0\n" "46 move 0 1\n" "50 move 0 1\n"
+    "54 move -1 0\n" "58 move 0 1\n" "62 move 0 1\n" "66 move 0 1\n" "70 move 1 0\n" "74 move 0 1\n";
+
+static bool parseScript(const char* text, std::vector<ScriptEvent>& out) {
+    int lineNo = 0;
+    const char* p = text;
+    while (*p) {
+        const char* end = strchr(p, '\n'); if (!end) end = p + strlen(p);
+        std::string line(p, end); p = *end ? end + 1 : end; ++lineNo;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        ScriptEvent e; char kind[16]; float a = 0, b = 0; char key = 0;
+        if (sscanf(line.c_str(), "%d %15s", &e.frame, kind) != 2) { fprintf(stderr, "script line %d: expected <frame> <event>\n", lineNo); return false; }
+        if (!strcmp(kind, "click") && sscanf(line.c_str(), "%*d %*s %f %f", &a, &b) == 2) e.input = clickInput(Vec2(a, b));
+        else if (!strcmp(kind, "move") && sscanf(line.c_str(), "%*d %*s %f %f", &a, &b) == 2) e.input = moveInput(a, b);
+        else if (!strcmp(kind, "hold") && sscanf(line.c_str(), "%*d %*s %f %f", &a, &b) == 2) { e.hold = true; e.holdX = a; e.holdY = b; }
+        else if (!strcmp(kind, "key") && sscanf(line.c_str(), "%*d %*s %c", &key) == 1) e.input = keyInput((unsigned char)key);
+        else { fprintf(stderr, "script line %d: bad event '%s'\n", lineNo, line.c_str()); return false; }
+        out.push_back(e);
+    }
+    std::stable_sort(out.begin(), out.end(), [](const ScriptEvent& x, const ScriptEvent& y) { return x.frame < y.frame; });
+    return true;
+}
+
+static bool readFile(const char* path, std::string& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char buf[4096]; size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+static bool writePpm(const char* path, int w, int h, std::vector<unsigned char>& pixels) {
+    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int y = h - 1;y >= 0;--y) fwrite(&pixels[(size_t)y * w * 3], 1, (size_t)w * 3, f); // GL rows are bottom-up
+    return fclose(f) == 0;
+}
+
+// surfaceless Mesa when available (no X/Wayland needed), otherwise the default display
+static bool createContext(int w, int h) {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) { fprintf(stderr, "no EGL display\n"); return false; }
+
+    const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config; EGLint count = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &count) || count == 0) { fprintf(stderr, "no EGL config with desktop GL and pbuffers\n"); return false; }
+    if (!eglBindAPI(EGL_OPENGL_API)) { fprintf(stderr, "EGL has no desktop GL\n"); return false; }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, w, EGL_HEIGHT, h, EGL_NONE };
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr); // default: compatibility profile
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) { fprintf(stderr, "could not create the offscreen context\n"); return false; }
+    return true;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+    int frames = 120, width = 800, height = 600, dumpEvery = 0;
+    unsigned seed = 1;
+    const char* scriptPath = nullptr; const char* outDir = "."; const char* timingsPath = nullptr;
+    const char* levelPath = nullptr; const char* saveLevelPath = nullptr; const char* recordPath = nullptr;
+    int streamMb = 0;
+    size_t generateCount = 0;
+    int noAllocAfter = -1;
+    int starCount = STARFIELD_DEFAULT_STARS;
+    std::vector<int> dumpFrames;
+    bool overlay = false;
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2) ++i;
+        else if (!strcmp(argv[i], "--script") && i + 1 < argc) scriptPath = argv[++i];
+        else if (!strcmp(argv[i], "--dump") && i + 1 < argc) { for (const char* p = argv[++i];*p;) { dumpFrames.push_back(atoi(p)); p = strchr(p, ','); if (!p) break; ++p; } }
+        else if (!strcmp(argv[i], "--dump-every") && i + 1 < argc) dumpEvery = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) outDir = argv[++i];
+        else if (!strcmp(argv[i], "--timings") && i + 1 < argc) timingsPath = argv[++i];
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--overlay")) overlay = true;
+        else if (!strcmp(argv[i], "--level") && i + 1 < argc) levelPath = argv[++i];
+        else if (!strcmp(argv[i], "--save-level") && i + 1 < argc) saveLevelPath = argv[++i];
+        else if (!strcmp(argv[i], "--stream") && i + 1 < argc) streamMb = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) setJobThreads(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--generate") && i + 1 < argc) generateCount = (size_t)std::max(0LL, atoll(argv[++i]));
+        else if (!strcmp(argv[i], "--no-alloc-after") && i + 1 < argc) noAllocAfter = std::max(0, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--stars") && i + 1 < argc) starCount = std::max(0, atoi(argv[++i]));
+        else { fprintf(stderr, "usage: %s [--frames N] [--size WxH] [--script file] [--dump a,b,c | --dump-every N] [--out dir] [--timings file.csv] [--seed N] [--overlay] [--level file [--stream MB]] [--save-level file] [--threads N] [--record file] [--generate N] [--no-alloc-after N] [--stars N]\n", argv[0]); return 1; }
+    }
+    if (width < 1 || height < 1) { fprintf(stderr, "bad --size\n"); return 1; }
+
+    std::string scriptText;
+    if (scriptPath && !readFile(scriptPath, scriptText)) { fprintf(stderr, "could not read %s\n", scriptPath); return 1; }
+    std::vector<ScriptEvent> script;
+    if (!parseScript(scriptPath ? scriptText.c_str() : DEFAULT_SCRIPT, script)) return 1;
+
+    if (!createContext(width, height)) return 1;
+    printf("GL: %s / %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+    // same state setup as the windowed front end
+    glViewport(0, 0, width, height);
+    glClearColor(0, 0, 0, 1);
+    glEnable(GL_POINT_SMOOTH);
+    glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLRenderer renderer; renderer.init(starCount);
+    GpuTimer gpuTimer; gpuTimer.init();
+
+    if (generateCount) {
+        if (!levelPath) levelPath = "generated.splv";
+        Clock::time_point t0 = Clock::now();
+        size_t placed = 0;
+        LevelStatus st = generateLevelFile(levelPath, generateCount, seed, placed);
+        if (st != LEVEL_OK) { fprintf(stderr, "%s: %s\n", levelPath, levelStatusText(st)); return 1; }
+        printf("generated %zu objects into %s in %.1f ms\n", placed, levelPath, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+
+    const float dt = 1.0f / 60.0f; // one tick per frame keeps the run reproducible
+    GameState game; initGame(game, seed);
+    ReplayRecorder recorder; recorder.begin(seed, dt, levelPath);
+    // --stream: chunks are paged in around the camera (asynchronously, so a run is only reproducible while the disk keeps up)
+    std::unique_ptr<ChunkStreamer> streamer;
+    if (streamMb) streamer.reset(new ChunkStreamer((size_t)streamMb << 20));
+    if (levelPath) {
+        Clock::time_point t0 = Clock::now();
+        LevelStatus st = streamer ? streamer->open(game, levelPath) : loadLevel(game, levelPath);
+        if (st != LEVEL_OK) { fprintf(stderr, "%s: %s\n", levelPath, levelStatusText(st)); return 1; }
+        recorder.levelLoaded();
+        if (streamer) { streamer->update(game, game.cameraY); streamer->waitIdle(); streamer->update(game, game.cameraY); } // the first view, as a loading screen would
+        printf("%s %s: %zu obstacles, %zu collectibles, %zu power-ups resident in %.2f ms\n", streamer ? "opened" : "loaded", levelPath,
+               game.chunks.obstacleCount(), game.chunks.collectibleCount(), game.chunks.powerupCount(), std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    DrawList drawList; HudText hudText;
+    ParticleSystem particles; // effects run at the simulation's rate here, so the frames are reproducible
+    ProfilerOverlay profilerOverlay; profilerOverlay.visible = overlay;
+    Profiler& prof = profiler();
+
+    std::vector<unsigned char> pixels((size_t)width * height * 3);
+    // sized up front so the bookkeeping itself does not allocate during the frames
+    std::vector<double> buildMs, renderMs, frameMs;
+    buildMs.reserve(frames); renderMs.reserve(frames); frameMs.reserve(frames);
+    std::vector<AllocTotals> frameAllocs; frameAllocs.reserve(frames);
+    std::vector<InputEvent> pending;
+    float holdX = 0.0f, holdY = 0.0f;
+    size_t nextEvent = 0;
+    int dumped = 0;
+
+    for (int f = 0;f < frames;++f) {
+        prof.beginFrame();
+        pending.clear();
+        for (;nextEvent < script.size() && script[nextEvent].frame <= f;++nextEvent) {
+            const ScriptEvent& e = script[nextEvent];
+            if (e.hold) { holdX = e.holdX; holdY = e.holdY; }
+            else pending.push_back(e.input);
+        }
+        Inputs in; in.events = pending.data(); in.count = pending.size(); in.moveX = holdX; in.moveY = holdY;
+        recorder.tick(in, game);
+        const AllocTotals frameStart = allocTotals(); // the recording's own growth is left out
+        { PROFILE_SCOPE(ZONE_UPDATE); step(game, in, dt); }
+        if (streamer) { PROFILE_SCOPE(ZONE_STREAM); streamer->update(game, game.cameraY); }
+
+        Clock::time_point t0 = Clock::now();
+        FramePose pose = currentPose(game);
+        buildScene(game, pose, drawList, hudText);
+        buildParticles(game, pose, dt, particles, drawList);
+        buildProfilerOverlay(prof, profilerOverlay, drawList, prof.nowUs() * 1e-6);
+        Clock::time_point t1 = Clock::now();
+        gpuTimer.collect();
+        {
+            PROFILE_SCOPE(ZONE_SUBMIT);
+            gpuTimer.begin(ZONE_GPU_DRAW);
+            glClear(GL_COLOR_BUFFER_BIT);
+            renderer.submit(drawList, width, height);
+            gpuTimer.end();
+        }
+        { PROFILE_SCOPE(ZONE_SWAP); glFinish(); } // stands in for the swap: waits for the frame to be done
+        Clock::time_point t2 = Clock::now();
+        prof.endFrame();
+        frameAllocs.push_back(allocsSince(frameStart));
+
+        buildMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        renderMs.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+        frameMs.push_back(buildMs.back() + renderMs.back());
+
+        bool dump = (dumpEvery && f % dumpEvery == 0) || std::find(dumpFrames.begin(), dumpFrames.end(), f) != dumpFrames.end();
+        if (dump) {
+            char path[1024]; snprintf(path, sizeof(path), "%s/frame_%05d.ppm", outDir, f);
+            if (!writePpm(path, width, height, pixels)) { fprintf(stderr, "could not write %s\n", path); return 1; }
+            ++dumped;
+        }
+    }
+
+    if (timingsPath) {
+        FILE* t = fopen(timingsPath, "w");
+        if (!t) { fprintf(stderr, "could not write %s\n", timingsPath); return 1; }
+        fprintf(t, "frame,build_ms,render_ms,total_ms,allocs,alloc_bytes\n");
+        for (int f = 0;f < frames;++f) fprintf(t, "%d,%.4f,%.4f,%.4f,%llu,%llu\n", f, buildMs[f], renderMs[f], frameMs[f], (unsigned long long)frameAllocs[f].count, (unsigned long long)frameAllocs[f].bytes);
+        fclose(t);
+    }
+
+    // per-frame summary (the first frame includes buffer growth and shader/texture setup in the driver)
+    auto summary = [&](const char* name, std::vector<double> v) {
+        double sum = 0; for (double x : v) sum += x;
+        std::sort(v.begin(), v.end());
+        printf("%-8s min %8.3f  avg %8.3f  p50 %8.3f  p99 %8.3f  max %8.3f ms\n", name, v.front(), sum / v.size(), v[v.size() / 2], v[(size_t)(0.99 * (v.size() - 1) + 0.5)], v.back());
+    };
+    printf("%d frames at %dx%d, %d draw calls and %zu vertices in the last frame, %d frame(s) dumped to %s\n", frames, width, height, renderer.drawCalls(), renderer.vertices(), dumped, outDir);
+    summary("build", buildMs);
+    summary("render", renderMs);
+    summary("frame", frameMs);
+    // allocations: the first frames grow buffers to their working size, after that a frame should allocate nothing
+    AllocTotals later; uint64_t worst = 0; int lastAllocating = -1, failing = 0;
+    for (int f = 1;f < frames;++f) {
+        const AllocTotals& a = frameAllocs[f];
+        later.count += a.count; later.bytes += a.bytes; worst = std::max(worst, a.count);
+        if (a.count) lastAllocating = f;
+    }
+    printf("alloc    frame 0: %llu (%.1f KB); frames 1+: %llu (%.1f KB), at most %llu in a frame, last in frame %d\n", (unsigned long long)frameAllocs[0].count, frameAllocs[0].bytes / 1024.0,
+           (unsigned long long)later.count, later.bytes / 1024.0, (unsigned long long)worst, lastAllocating);
+    if (noAllocAfter >= 0) {
+        for (int f = noAllocAfter;f < frames;++f) {
+            if (!frameAllocs[f].count) continue;
+            if (++failing <= 5) fprintf(stderr, "frame %d: %llu allocation(s), %llu bytes\n", f, (unsigned long long)frameAllocs[f].count, (unsigned long long)frameAllocs[f].bytes);
+        }
+        if (failing) fprintf(stderr, "%d frame(s) from frame %d on allocated\n", failing, noAllocAfter);
+    }
+    printf("score %d, lives %d, %s\n", game.score, game.lives, game.gameOver ? (game.gameWin ? "won" : "lost") : game.gameStarted ? "playing" : "editing");
+    if (streamer) {
+        const StreamStats& ss = streamer->stats();
+        printf("stream   %d loads, %d evictions (%d written back), %d failures; resident %.1f MB (peak %.1f of %.1f MB); update worst %.3f ms\n", ss.loads, ss.evictions, ss.writebacks, ss.failures,
+               ss.residentBytes / 1048576.0, ss.peakBytes / 1048576.0, ss.budgetBytes / 1048576.0, ss.worstUpdateMs);
+    }
+    if (recordPath) {
+        ReplayStatus st = recorder.write(recordPath, game);
+        if (st != REPLAY_OK) { fprintf(stderr, "%s: %s\n", recordPath, replayStatusText(st)); return 1; }
+        printf("session recorded to %s (%llu ticks)\n", recordPath, (unsigned long long)recorder.ticks());
+    }
+    if (saveLevelPath) {
+        LevelStatus st = streamer ? streamer->save(game, saveLevelPath) : saveLevel(game, saveLevelPath);
+        if (st != LEVEL_OK) { fprintf(stderr, "%s: %s\n", saveLevelPath, levelStatusText(st)); return 1; }
+        printf("level saved to %s\n", saveLevelPath);
+    }
+    return failing ? 3 : 0;
+}
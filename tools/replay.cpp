@@ -0,0 +1,79 @@
+// =====================
+// Replay runner: plays recorded sessions (src/Replay.h) through the simulation as fast as it goes, with no
+// window or GL, and checks each against the outcome stored with it. Recordings come from the game
+// (--record) or from SpaceEditorHeadless --record.
+//
+//   SpaceEditorReplay [--level file] [--repeat N] [--threads N] [--quiet] session.sprp ...
+//
+// --level plays every session on this level file instead of the recorded one; --repeat plays each session
+// N times (a throughput benchmark). Exit code 2 if any session ends differently from its recording, 1 if
+// one could not be played at all.
+// =====================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "GameCore.h"
+#include "JobSystem.h"
+#include "Replay.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void printOutcome(const char* label, const ReplayOutcome& o) {
+    printf("  %-9s %llu ticks, score %d, lives %d, timer %.4f, %s\n", label, (unsigned long long)o.ticks, o.score, o.lives, o.gameTimer,
+           o.flags & REPLAY_OVER ? (o.flags & REPLAY_WON ? "won" : "lost") : o.flags & REPLAY_STARTED ? "playing" : "editing");
+}
+
+int main(int argc, char** argv) {
+    const char* levelPath = nullptr;
+    int repeat = 1;
+    bool quiet = false;
+    std::vector<const char*> files;
+    for (int i = 1;i < argc;++i) {
+        if (!strcmp(argv[i], "--level") && i + 1 < argc) levelPath = argv[++i];
+        else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) setJobThreads(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--quiet")) quiet = true;
+        else if (argv[i][0] != '-') files.push_back(argv[i]);
+        else { fprintf(stderr, "unknown option %s\n", argv[i]); files.clear(); break; }
+    }
+    if (files.empty()) { fprintf(stderr, "usage: %s [--level file] [--repeat N] [--threads N] [--quiet] session.sprp ...\n", argv[0]); return 1; }
+
+    int mismatches = 0, failures = 0;
+    uint64_t totalTicks = 0;
+    double totalMs = 0.0;
+    GameState game;
+    for (const char* path : files) {
+        Replay replay;
+        ReplayStatus st = readReplay(path, replay);
+        if (st != REPLAY_OK) { fprintf(stderr, "%s: %s\n", path, replayStatusText(st)); ++failures; continue; }
+        std::string scratch = std::string(path) + ".scratch.splv";
+        ReplayOutcome played = {};
+        double bestMs = 0.0;
+        bool same = true;
+        for (int r = 0;r < repeat && st == REPLAY_OK;++r) {
+            Clock::time_point t0 = Clock::now();
+            st = playReplay(replay, levelPath, scratch.c_str(), game, played);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            if (st != REPLAY_OK) break;
+            if (r == 0 || ms < bestMs) bestMs = ms;
+            totalMs += ms; totalTicks += replay.outcome.ticks;
+            same = same && sameOutcome(played, replay.outcome);
+        }
+        if (st != REPLAY_OK) { fprintf(stderr, "%s: %s\n", path, replayStatusText(st)); ++failures; continue; }
+        if (!same) ++mismatches;
+        if (!quiet || !same) {
+            printf("%s: %s, %llu ticks in %.2f ms (%.0f ticks/s)\n", path, same ? "match" : "MISMATCH", (unsigned long long)replay.outcome.ticks, bestMs,
+                   bestMs > 0.0 ? replay.outcome.ticks / (bestMs * 0.001) : 0.0);
+            if (!same) { printOutcome("recorded", replay.outcome); printOutcome("replayed", played); }
+        }
+    }
+    printf("%zu session(s) x %d: %d mismatched, %d failed; %llu ticks in %.1f ms (%.0f ticks/s)\n", files.size(), repeat, mismatches, failures,
+           (unsigned long long)totalTicks, totalMs, totalMs > 0.0 ? totalTicks / (totalMs * 0.001) : 0.0);
+    return failures ? 1 : mismatches ? 2 : 0;
+}